@@ -10,11 +10,13 @@
 #include <QMessageBox>
 #include <QStringList>
 #include <QDesktopServices>
+#include <QThread>
 
 #include "gui/dialogs/VersionSelectDialog.h"
 #include "logic/InstanceList.h"
 #include "logic/auth/MojangAccountList.h"
 #include "logic/icons/IconList.h"
+#include "logic/ModStore.h"
 #include "logic/LwjglVersionList.h"
 #include "logic/minecraft/MinecraftVersionList.h"
 #include "logic/liteloader/LiteLoaderVersionList.h"
@@ -29,6 +31,7 @@
 #include "logic/net/URLConstants.h"
 
 #include "logic/java/JavaUtils.h"
+#include "logic/java/JavaCheckerCache.h"
 
 #include "logic/updater/UpdateChecker.h"
 #include "logic/updater/NotificationChecker.h"
@@ -45,6 +48,12 @@
 #include "logger/QsLogDest.h"
 
 #include "logic/trans/TranslationDownloader.h"
+#include "logic/LogArchive.h"
+#include "logic/WatchHub.h"
+#include "logic/screenshots/ThumbnailCache.h"
+#include "logic/StartupTrace.h"
+#include "logic/Metrics.h"
+#include "logic/StallDetector.h"
 
 #ifdef Q_OS_WIN32
 #include <windows.h>
@@ -53,8 +62,15 @@ static const int APPDATA_BUFFER_SIZE = 1024;
 
 using namespace Util::Commandline;
 
+// how long it may take until the main window can be painted, in milliseconds
+static const qint64 STARTUP_BUDGET = 1500;
+
 MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, argv)
 {
+	m_startupTrace = std::make_shared<StartupTrace>();
+	m_startupTrace->setBudget("main window visible", STARTUP_BUDGET * 1000);
+	auto startupPhase = m_startupTrace->phase("MultiMC constructor");
+
 	setOrganizationName("MultiMC");
 	setApplicationName("MultiMC5");
 
@@ -80,6 +96,10 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 		parser.addShortOpt("dir", 'd');
 		parser.addDocumentation("dir", "use the supplied directory as MultiMC root instead of "
 									   "the binary location (use '.' for current)");
+		// --startup-trace
+		parser.addOption("startup-trace");
+		parser.addDocumentation("startup-trace", "write the timing of the startup phases to the "
+												 "given file, in the Chrome trace event format");
 
 		// parse the arguments
 		try
@@ -113,6 +133,12 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 		}
 	}
 	origcwdPath = QDir::currentPath();
+	m_startupTracePath = args["startup-trace"].toString();
+	if (!m_startupTracePath.isEmpty())
+	{
+		// relative to where we were started, not the data path
+		m_startupTracePath = QDir::current().absoluteFilePath(m_startupTracePath);
+	}
 	binPath = applicationDirPath();
 	QString adjustedBy;
 	// change directory
@@ -169,7 +195,10 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 #endif
 
 	// init the logger
-	initLogger();
+	{
+		auto phase = m_startupTrace->phase("logger");
+		initLogger();
+	}
 
 	QLOG_INFO() << "MultiMC 5, (c) 2013-2014 MultiMC Contributors";
 	QLOG_INFO() << "Version                    : " << BuildConfig.VERSION_STR;
@@ -188,12 +217,36 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 	QLOG_INFO() << "Application root path      : " << rootPath;
 	QLOG_INFO() << "Static data path           : " << staticDataPath;
 
+	// so exported metrics from different machines can be told apart
+	auto &registry = Metrics::Registry::instance();
+	registry.setInfo("version", BuildConfig.VERSION_STR);
+	registry.setInfo("git", BuildConfig.GIT_COMMIT);
+	registry.setInfo("platform", BuildConfig.BUILD_PLATFORM);
+	registry.setInfo("threads", QString::number(QThread::idealThreadCount()));
+
+	// the tests block the GUI thread on purpose, no point in complaining about it there
+	if (!test_mode)
+	{
+		m_stallDetector = std::make_shared<StallDetector>();
+		m_stallDetector->start();
+	}
+
 	// load settings
-	initGlobalSettings(test_mode);
+	{
+		auto phase = m_startupTrace->phase("settings");
+		initGlobalSettings(test_mode);
+		m_logArchive->setLimits(m_settings->get("LogSegmentSize").toLongLong() * 1024 * 1024,
+								m_settings->get("LogTotalSize").toLongLong() * 1024 * 1024,
+								m_settings->get("LogMaxAge").toInt());
+	}
 
 	// load translations
-	initTranslations();
+	{
+		auto phase = m_startupTrace->phase("translations");
+		initTranslations();
+	}
 
+	auto checkersPhase = m_startupTrace->phase("checkers");
 	// initialize the updater
 	m_updateChecker.reset(new UpdateChecker());
 
@@ -207,8 +260,10 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 	m_statusChecker.reset(new StatusChecker());
 
 	m_translationChecker.reset(new TranslationDownloader());
+	checkersPhase.end();
 
 	// and instances
+	auto instancesPhase = m_startupTrace->phase("instances");
 	auto InstDirSetting = m_settings->getSetting("InstanceDir");
 	// instance path: check for problems with '!' in instance path and warn the user in the log
 	// and rememer that we have to show him a dialog when the gui starts (if it does so)
@@ -220,28 +275,43 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 			<< "Your instance path contains \'!\' and this is known to cause java problems";
 	}
 	m_instances.reset(new InstanceList(InstDirSetting->get().toString(), this));
-	QLOG_INFO() << "Loading Instances...";
-	m_instances->loadList();
+	// the main window comes up with an empty list, the instances fill it right after
+	defer(DeferHigh, "instance list", [this]()
+	{
+		QLOG_INFO() << "Loading Instances...";
+		m_instances->loadList();
+	});
 	connect(InstDirSetting.get(), SIGNAL(SettingChanged(const Setting &, QVariant)),
 			m_instances.get(), SLOT(on_InstFolderChanged(const Setting &, QVariant)));
+	instancesPhase.end();
 
 	// and accounts
-	m_accounts.reset(new MojangAccountList(this));
-	QLOG_INFO() << "Loading accounts...";
-	m_accounts->setListFilePath("accounts.json", true);
-	m_accounts->loadList();
-
-	// init the http meta cache
-	initHttpMetaCache();
+	{
+		auto phase = m_startupTrace->phase("accounts");
+		m_accounts.reset(new MojangAccountList(this));
+		QLOG_INFO() << "Loading accounts...";
+		m_accounts->setListFilePath("accounts.json", true);
+		m_accounts->loadList();
+	}
 
 	// create the global network manager
-	m_qnam.reset(new QNetworkAccessManager(this));
+	{
+		auto phase = m_startupTrace->phase("network");
+		m_qnam.reset(new QNetworkAccessManager(this));
 
-	m_translationChecker->downloadTranslations();
+		// init proxy settings
+		updateProxySettings();
+	}
 
-	// init proxy settings
-	updateProxySettings();
+	// everything below isn't needed to show the main window and runs once it is up.
+	// the http meta cache is loaded on first use if something needs it sooner
+	connect(&m_deferredTimer, SIGNAL(timeout()), SLOT(runDeferred()));
+	defer(DeferHigh, "metacache", [this]()
+	{ metacache(); });
+	defer(DeferLow, "translation download", [this]()
+	{ m_translationChecker->downloadTranslations(); });
 
+	auto toolsPhase = m_startupTrace->phase("tools");
 	m_profilers.insert("jprofiler",
 					   std::shared_ptr<BaseProfilerFactory>(new JProfilerFactory()));
 	m_profilers.insert("jvisualvm",
@@ -255,6 +325,7 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 	{
 		tool->registerSettings(m_settings);
 	}
+	toolsPhase.end();
 
 	connect(this, SIGNAL(aboutToQuit()), SLOT(onExit()));
 	m_status = MultiMC::Initialized;
@@ -312,30 +383,30 @@ void MultiMC::initTranslations()
 	}
 }
 
-void moveFile(const QString &oldName, const QString &newName)
-{
-	QFile::remove(newName);
-	QFile::copy(oldName, newName);
-	QFile::remove(oldName);
-}
 void MultiMC::initLogger()
 {
 	static const QString logBase = "MultiMC-%0.log";
 
-	moveFile(logBase.arg(3), logBase.arg(4));
-	moveFile(logBase.arg(2), logBase.arg(3));
-	moveFile(logBase.arg(1), logBase.arg(2));
-	moveFile(logBase.arg(0), logBase.arg(1));
+	// the previous session (and the numbered logs of older versions) go into the archive
+	m_logArchive = std::make_shared<LogArchive>(QDir::current().absoluteFilePath("logs"), "MultiMC");
+	for (int i = 4; i >= 0; i--)
+	{
+		m_logArchive->archive(logBase.arg(i));
+	}
 
 	// init the logging mechanism
 	QsLogging::Logger &logger = QsLogging::Logger::instance();
-	logger.setLoggingLevel(QsLogging::TraceLevel);
-	m_fileDestination = QsLogging::DestinationFactory::MakeFileDestination(logBase.arg(0));
+	m_fileDestination = QsLogging::DestinationFactory::MakeFileDestination(logBase.arg(0), m_logArchive);
 	m_debugDestination = QsLogging::DestinationFactory::MakeDebugOutputDestination();
 	logger.addDestination(m_fileDestination.get());
 	logger.addDestination(m_debugDestination.get());
-	// log all the things
-	logger.setLoggingLevel(QsLogging::TraceLevel);
+	// debug by default, MMC_LOG can change it per category - like 'info,net=trace'
+	logger.configure("debug");
+	const QString spec = QString::fromLocal8Bit(qgetenv("MMC_LOG"));
+	if (!spec.isEmpty() && !logger.configure(spec))
+	{
+		QLOG_WARN() << "Could not fully understand MMC_LOG:" << spec;
+	}
 }
 
 void MultiMC::initGlobalSettings(bool test_mode)
@@ -478,6 +549,12 @@ void MultiMC::initGlobalSettings(bool test_mode)
 	m_settings->registerSetting({"CentralModsDir", "ModsDir"}, "mods");
 	m_settings->registerSetting({"LWJGLDir", "LwjglDir"}, "lwjgl");
 	m_settings->registerSetting("IconsDir", "icons");
+	m_settings->registerSetting("UseModStore", false);
+
+	// Launcher logs, sizes in MiB and age in days. 0 means unlimited.
+	m_settings->registerSetting("LogSegmentSize", 8);
+	m_settings->registerSetting("LogTotalSize", 64);
+	m_settings->registerSetting("LogMaxAge", 30);
 
 	// Editors
 	m_settings->registerSetting("JsonEditor", QString());
@@ -628,6 +705,102 @@ void MultiMC::updateProxySettings()
 	QLOG_INFO() << proxyDesc;
 }
 
+std::shared_ptr<HttpMetaCache> MultiMC::metacache()
+{
+	if (!m_metacache)
+	{
+		auto phase = m_startupTrace->phase("metacache");
+		initHttpMetaCache();
+	}
+	return m_metacache;
+}
+
+void MultiMC::defer(DeferPriority priority, const QString &name, std::function<void()> task,
+					QObject *context)
+{
+	DeferredTask deferred;
+	deferred.name = name;
+	deferred.hasContext = context != nullptr;
+	deferred.context = context;
+	deferred.task = task;
+	m_deferred.insert(std::make_pair(int(priority), deferred));
+	// while a task runs, the timer is restarted when it's done
+	if (!m_deferredTimer.isActive() && !m_runningDeferred)
+	{
+		m_deferredTimer.start(0);
+	}
+}
+
+void MultiMC::runDeferred()
+{
+	if (m_runningDeferred)
+		return;
+	if (m_firstIdle)
+	{
+		// the window was shown before the event loop started, by now it got painted
+		m_firstIdle = false;
+		m_startupTrace->mark("main window visible");
+		const qint64 visible = m_startupTrace->elapsed() / 1000;
+		if (!m_startupTrace->withinBudget())
+		{
+			QLOG_WARN() << "Main window visible after" << visible << "ms, over the budget of"
+						<< m_startupTrace->budget() / 1000 << "ms";
+		}
+		else
+		{
+			QLOG_INFO() << "Main window visible after" << visible << "ms";
+		}
+	}
+	if (m_deferred.empty())
+	{
+		m_deferredTimer.stop();
+		finishStartup();
+		return;
+	}
+	auto iter = m_deferred.begin();
+	DeferredTask deferred = iter->second;
+	m_deferred.erase(iter);
+	if (deferred.hasContext && !deferred.context)
+		return;
+
+	// a task that opens a dialog runs a nested event loop - don't spin the timer in there
+	m_deferredTimer.stop();
+	m_runningDeferred = true;
+	{
+		auto phase = m_startupTrace->phase(deferred.name, "deferred");
+		Metrics::PhaseMarker marker("deferred: " + deferred.name);
+		deferred.task();
+	}
+	m_runningDeferred = false;
+	m_deferredTimer.start(0);
+}
+
+void MultiMC::finishStartup()
+{
+	// only the first time the queue runs dry is the end of startup
+	if (m_startupFinished)
+		return;
+	m_startupFinished = true;
+	QLOG_INFO() << "Startup finished after" << m_startupTrace->elapsed() / 1000 << "ms";
+	for (auto &event : m_startupTrace->events())
+	{
+		if (event.duration < 0)
+			continue;
+		QLOG_DEBUG() << "Startup phase" << event.category << event.name << ":"
+					 << event.duration / 1000.0 << "ms";
+	}
+	if (m_startupTracePath.isEmpty())
+		return;
+	if (m_startupTrace->write(m_startupTracePath))
+	{
+		QLOG_INFO() << "Wrote startup trace to" << m_startupTracePath;
+	}
+	else
+	{
+		QLOG_ERROR() << "Could not write startup trace to" << m_startupTracePath;
+	}
+}
+
 std::shared_ptr<IconList> MultiMC::icons()
 {
 	if (!m_icons)
@@ -637,6 +810,33 @@ std::shared_ptr<IconList> MultiMC::icons()
 	return m_icons;
 }
 
+std::shared_ptr<ModStore> MultiMC::modstore()
+{
+	if (!m_modstore)
+	{
+		m_modstore.reset(new ModStore("modstore"));
+	}
+	return m_modstore;
+}
+
+std::shared_ptr<WatchHub> MultiMC::watches()
+{
+	if (!m_watches)
+	{
+		m_watches.reset(new WatchHub());
+	}
+	return m_watches;
+}
+
+std::shared_ptr<ThumbnailCache> MultiMC::thumbnails()
+{
+	if (!m_thumbnails)
+	{
+		m_thumbnails.reset(new ThumbnailCache(QDir("cache/thumbnails").absolutePath()));
+	}
+	return m_thumbnails;
+}
+
 std::shared_ptr<LWJGLVersionList> MultiMC::lwjgllist()
 {
 	if (!m_lwjgllist)
@@ -682,6 +882,16 @@ std::shared_ptr<JavaVersionList> MultiMC::javalist()
 	return m_javalist;
 }
 
+std::shared_ptr<JavaCheckerCache> MultiMC::javacheckercache()
+{
+	if (!m_javacheckercache)
+	{
+		m_javacheckercache.reset(new JavaCheckerCache("javacheck.json"));
+		m_javacheckercache->Load();
+	}
+	return m_javacheckercache;
+}
+
 void MultiMC::installUpdates(const QString updateFilesDir, UpdateFlags flags)
 {
 	// if we are going to update on exit, save the params now
@@ -744,6 +954,19 @@ void MultiMC::onExit()
 	{
 		installUpdates(m_updateOnExitPath, m_updateOnExitFlags);
 	}
+	if (m_stallDetector)
+	{
+		m_stallDetector->stop();
+		auto report = m_stallDetector->report();
+		if (!report.isEmpty())
+		{
+			QLOG_INFO() << "GUI thread stalls by phase:\n" + report;
+		}
+	}
+	// settings are written lazily, anything still pending goes out now
+	INISettingsObject::flushAll();
+	// the log writer runs on its own thread - make sure nothing is left in the queue
+	QsLogging::Logger::instance().flush();
 }
 
 bool MultiMC::openJsonEditor(const QString &filename)
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <QApplication>
+#include <QPointer>
+#include <QTimer>
 #include <memory>
+#include <functional>
+#include <map>
 #include "logger/QsLog.h"
 #include "logger/QsLogDest.h"
 #include <QFlag>
@@ -17,6 +21,11 @@ class QNetworkAccessManager;
 class ForgeVersionList;
 class LiteLoaderVersionList;
 class JavaVersionList;
+class JavaCheckerCache;
+class ModStore;
+class WatchHub;
+class ThumbnailCache;
+class LogArchive;
 class UpdateChecker;
 class NotificationChecker;
 class NewsChecker;
@@ -24,6 +33,8 @@ class StatusChecker;
 class BaseProfilerFactory;
 class BaseDetachedToolFactory;
 class TranslationDownloader;
+class StartupTrace;
+class StallDetector;
 
 #if defined(MMC)
 #undef MMC
@@ -51,6 +62,14 @@ public:
 		Initialized
 	};
 
+	/// when a deferred task runs, relative to the other ones
+	enum DeferPriority
+	{
+		DeferHigh,
+		DeferNormal,
+		DeferLow
+	};
+
 public:
 	MultiMC(int &argc, char **argv, bool test_mode = false);
 	virtual ~MultiMC();
@@ -82,10 +101,7 @@ public:
 		return m_qnam;
 	}
 
-	std::shared_ptr<HttpMetaCache> metacache()
-	{
-		return m_metacache;
-	}
+	std::shared_ptr<HttpMetaCache> metacache();
 
 	std::shared_ptr<UpdateChecker> updateChecker()
 	{
@@ -117,6 +133,19 @@ public:
 
 	std::shared_ptr<JavaVersionList> javalist();
 
+	std::shared_ptr<JavaCheckerCache> javacheckercache();
+
+	std::shared_ptr<ModStore> modstore();
+
+	std::shared_ptr<WatchHub> watches();
+
+	std::shared_ptr<ThumbnailCache> thumbnails();
+
+	std::shared_ptr<LogArchive> logArchive()
+	{
+		return m_logArchive;
+	}
+
 	QMap<QString, std::shared_ptr<BaseProfilerFactory>> profilers()
 	{
 		return m_profilers;
@@ -126,6 +155,27 @@ public:
 		return m_tools;
 	}
 
+	std::shared_ptr<StartupTrace> startupTrace()
+	{
+		return m_startupTrace;
+	}
+
+	/// null in test mode
+	std::shared_ptr<StallDetector> stallDetector()
+	{
+		return m_stallDetector;
+	}
+
+	/**
+	 * Run a task once the event loop is running and the main window had a chance to paint.
+	 *
+	 * Deferred tasks run one per event loop iteration on the GUI thread, higher priorities
+	 * first and in the order they were added otherwise. If a context object is given and it is
+	 * destroyed before the task runs, the task is dropped.
+	 */
+	void defer(DeferPriority priority, const QString &name, std::function<void()> task,
+			   QObject *context = nullptr);
+
 	void installUpdates(const QString updateFilesDir, UpdateFlags flags = None);
 
 	/*!
@@ -173,6 +223,11 @@ private slots:
 	 */
 	void onExit();
 
+	/**
+	 * Run the next deferred task
+	 */
+	void runDeferred();
+
 private:
 	void initLogger();
 
@@ -182,6 +237,9 @@ private:
 
 	void initTranslations();
 
+	/// log the startup timing and write the trace, once all deferred tasks are done
+	void finishStartup();
+
 private:
 	friend class UpdateCheckerTest;
 	friend class DownloadUpdateTaskTest;
@@ -203,11 +261,33 @@ private:
 	std::shared_ptr<LiteLoaderVersionList> m_liteloaderlist;
 	std::shared_ptr<MinecraftVersionList> m_minecraftlist;
 	std::shared_ptr<JavaVersionList> m_javalist;
+	std::shared_ptr<JavaCheckerCache> m_javacheckercache;
+	std::shared_ptr<ModStore> m_modstore;
+	std::shared_ptr<WatchHub> m_watches;
+	std::shared_ptr<ThumbnailCache> m_thumbnails;
 	std::shared_ptr<TranslationDownloader> m_translationChecker;
+	std::shared_ptr<StartupTrace> m_startupTrace;
+	std::shared_ptr<StallDetector> m_stallDetector;
+
+	struct DeferredTask
+	{
+		QString name;
+		bool hasContext = false;
+		QPointer<QObject> context;
+		std::function<void()> task;
+	};
+	// ordered by priority, equal priorities stay in insertion order
+	std::multimap<int, DeferredTask> m_deferred;
+	QTimer m_deferredTimer;
+	bool m_runningDeferred = false;
+	bool m_firstIdle = true;
+	bool m_startupFinished = false;
+	QString m_startupTracePath;
 
 	QMap<QString, std::shared_ptr<BaseProfilerFactory>> m_profilers;
 	QMap<QString, std::shared_ptr<BaseDetachedToolFactory>> m_tools;
 
+	std::shared_ptr<LogArchive> m_logArchive;
 	QsLogging::DestinationPtr m_fileDestination;
 	QsLogging::DestinationPtr m_debugDestination;
 
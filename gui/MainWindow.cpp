@@ -65,6 +65,8 @@
 #include "gui/pages/global/MultiMCPage.h"
 #include "gui/pages/global/ExternalToolsPage.h"
 #include "gui/pages/global/AccountListPage.h"
+#include "gui/pages/global/DiagnosticsPage.h"
+#include "gui/pages/global/LauncherLogsPage.h"
 #include "gui/pages/global/ProxyPage.h"
 #include "gui/pages/global/JavaPage.h"
 #include "gui/pages/global/MinecraftPage.h"
@@ -260,6 +262,8 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
 		m_globalSettingsProvider->addPage<ProxyPage>();
 		m_globalSettingsProvider->addPage<ExternalToolsPage>();
 		m_globalSettingsProvider->addPage<AccountListPage>();
+		m_globalSettingsProvider->addPage<DiagnosticsPage>();
+		m_globalSettingsProvider->addPage<LauncherLogsPage>();
 	}
 
 	// Update the menu when the active account changes.
@@ -273,6 +277,53 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
 	// Show initial account
 	activeAccountChanged();
 
+	// none of the downloads are needed to show the window
+	MMC->defer(MultiMC::DeferNormal, "skin download", [this]()
+	{ downloadSkins(); }, this);
+
+	// set up the updater object.
+	auto updater = MMC->updateChecker();
+	connect(updater.get(), &UpdateChecker::updateAvailable, this, &MainWindow::updateAvailable);
+	connect(updater.get(), &UpdateChecker::noUpdateFound, this, &MainWindow::updateNotAvailable);
+	connect(MMC->notificationChecker().get(), &NotificationChecker::notificationCheckFinished,
+			this, &MainWindow::notificationsChanged);
+
+	// run the things that load and download other things... FIXME: this is NOT the place
+	// FIXME: invisible actions in the background = NOPE.
+	MMC->defer(MultiMC::DeferNormal, "version lists", [this]()
+	{
+		if (!MMC->minecraftlist()->isLoaded())
+		{
+			m_versionLoadTask = MMC->minecraftlist()->getLoadTask();
+			startTask(m_versionLoadTask);
+		}
+		if (!MMC->lwjgllist()->isLoaded())
+		{
+			MMC->lwjgllist()->loadList();
+		}
+	}, this);
+	MMC->defer(MultiMC::DeferLow, "news", [this]()
+	{
+		MMC->newsChecker()->reloadNews();
+		updateNewsLabel();
+	}, this);
+	// if automatic update checks are allowed, start one.
+	MMC->defer(MultiMC::DeferLow, "update check", []()
+	{
+		if (MMC->settings()->get("AutoUpdate").toBool())
+		{
+			MMC->updateChecker()->checkForUpdate(false);
+		}
+	});
+
+	setSelectedInstanceById(MMC->settings()->get("SelectedInstance").toString());
+
+	// removing this looks stupid
+	view->setFocus();
+}
+
+void MainWindow::downloadSkins()
+{
 	auto accounts = MMC->accounts();
 
 	QList<CacheDownloadPtr> skin_dls;
@@ -301,45 +352,6 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
 		skin_download_job.reset(job);
 		job->start();
 	}
-
-	// run the things that load and download other things... FIXME: this is NOT the place
-	// FIXME: invisible actions in the background = NOPE.
-	{
-		if (!MMC->minecraftlist()->isLoaded())
-		{
-			m_versionLoadTask = MMC->minecraftlist()->getLoadTask();
-			startTask(m_versionLoadTask);
-		}
-		if (!MMC->lwjgllist()->isLoaded())
-		{
-			MMC->lwjgllist()->loadList();
-		}
-
-		MMC->newsChecker()->reloadNews();
-		updateNewsLabel();
-
-		// set up the updater object.
-		auto updater = MMC->updateChecker();
-		connect(updater.get(), &UpdateChecker::updateAvailable, this,
-				&MainWindow::updateAvailable);
-		connect(updater.get(), &UpdateChecker::noUpdateFound, this,
-				&MainWindow::updateNotAvailable);
-		// if automatic update checks are allowed, start one.
-		if (MMC->settings()->get("AutoUpdate").toBool())
-		{
-			auto updater = MMC->updateChecker();
-			updater->checkForUpdate(false);
-		}
-
-		connect(MMC->notificationChecker().get(),
-				&NotificationChecker::notificationCheckFinished, this,
-				&MainWindow::notificationsChanged);
-	}
-
-	setSelectedInstanceById(MMC->settings()->get("SelectedInstance").toString());
-
-	// removing this looks stupid
-	view->setFocus();
 }
 
 MainWindow::~MainWindow()
@@ -829,6 +841,20 @@ void MainWindow::on_actionCopyInstance_triggered()
 
 	auto &loader = InstanceFactory::get();
 
+	std::unique_ptr<Task> copyTask(
+		loader.copyInstanceFiles(m_selectedInstance, instDir, copyInstDlg.linkMods()));
+	ProgressDialog tDialog(this);
+	tDialog.exec(copyTask.get());
+	if (!copyTask->successful())
+	{
+		QDir(instDir).removeRecursively();
+		CustomMessageBox::selectable(this, tr("Error"),
+									 tr("Failed to copy instance %1: %2")
+										 .arg(instDirName, copyTask->failReason()),
+									 QMessageBox::Warning)->show();
+		return;
+	}
+
 	InstancePtr newInstance;
 	auto error = loader.copyInstance(newInstance, m_selectedInstance, instDir);
 
@@ -1441,8 +1467,8 @@ void MainWindow::instanceEnded()
 
 void MainWindow::checkMigrateLegacyAssets()
 {
-	int legacyAssets = AssetsUtils::findLegacyAssets();
-	if (legacyAssets > 0)
+	QStringList legacyAssets = AssetsUtils::findLegacyAssets();
+	if (!legacyAssets.isEmpty())
 	{
 		ProgressDialog migrateDlg(this);
 		AssetsMigrateTask migrateTask(legacyAssets, &migrateDlg);
@@ -180,6 +180,8 @@ protected:
 
 	void setSelectedInstanceById(const QString &id);
 
+	void downloadSkins();
+
 private:
 	Ui::MainWindow *ui;
 	class GroupView *view;
@@ -196,7 +198,7 @@ private:
 	InstancePtr m_selectedInstance;
 	QString m_currentInstIcon;
 
-	Task *m_versionLoadTask;
+	Task *m_versionLoadTask = nullptr;
 
 	QLabel *m_statusLeft;
 	class ServerStatus *m_statusRight;
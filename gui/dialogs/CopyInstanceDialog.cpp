@@ -79,6 +79,11 @@ QString CopyInstanceDialog::iconKey() const
 	return InstIconKey;
 }
 
+bool CopyInstanceDialog::linkMods() const
+{
+	return ui->linkModsCheckBox->isChecked();
+}
+
 QString CopyInstanceDialog::instGroup() const
 {
 	return ui->groupBox->currentText();
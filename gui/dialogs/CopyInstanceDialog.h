@@ -39,6 +39,7 @@ public:
 	QString instName() const;
 	QString instGroup() const;
 	QString iconKey() const;
+	bool linkMods() const;
 
 private
 slots:
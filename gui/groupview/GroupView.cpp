@@ -8,8 +8,10 @@
 #include <QPersistentModelIndex>
 #include <QDrag>
 #include <QMimeData>
-#include <QCache>
 #include <QScrollBar>
+#include <QHash>
+
+#include <algorithm>
 
 #include "VisualGroup.h"
 #include "logger/QsLog.h"
@@ -43,6 +45,12 @@ GroupView::~GroupView()
 
 void GroupView::setModel(QAbstractItemModel *model)
 {
+	m_itemCache.clear();
+	m_placements.clear();
+	// connected before the view's own handlers, so the cache follows the rows before any layout
+	connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this,
+			&GroupView::modelLayoutAboutToBeChanged);
+	connect(model, &QAbstractItemModel::layoutChanged, this, &GroupView::modelLayoutChanged);
 	QAbstractItemView::setModel(model);
 	connect(model, &QAbstractItemModel::modelReset, this, &GroupView::modelReset);
 }
@@ -50,18 +58,78 @@ void GroupView::setModel(QAbstractItemModel *model)
 void GroupView::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
 							const QVector<int> &roles)
 {
+	// everything else (progress, tooltips, ...) only needs a repaint
+	static const QVector<int> layoutRoles = {Qt::DisplayRole, Qt::DecorationRole, Qt::FontRole,
+											 Qt::SizeHintRole, GroupViewRoles::GroupRole};
+	bool affectsLayout = roles.isEmpty();
+	for (int role : roles)
+	{
+		if (layoutRoles.contains(role))
+		{
+			affectsLayout = true;
+			break;
+		}
+	}
+	if (!affectsLayout)
+	{
+		for (int row = topLeft.row(); row <= bottomRight.row(); row++)
+		{
+			viewport()->update(visualRect(model()->index(row, 0)));
+		}
+		return;
+	}
+	invalidateRows(topLeft.row(), bottomRight.row());
 	scheduleDelayedItemsLayout();
 }
 void GroupView::rowsInserted(const QModelIndex &parent, int start, int end)
 {
+	if (!parent.isValid() && start <= m_itemCache.size())
+	{
+		m_itemCache.insert(start, end - start + 1, ItemCache());
+	}
 	scheduleDelayedItemsLayout();
 }
 
 void GroupView::rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
 {
+	if (!parent.isValid() && end < m_itemCache.size())
+	{
+		m_itemCache.remove(start, end - start + 1);
+	}
 	scheduleDelayedItemsLayout();
 }
 
+void GroupView::invalidateRows(int first, int last)
+{
+	last = qMin(last, m_itemCache.size() - 1);
+	for (int row = first; row <= last; row++)
+	{
+		m_itemCache[row].valid = false;
+	}
+}
+
+const GroupView::ItemCache &GroupView::cachedItem(int row) const
+{
+	if (row >= m_itemCache.size())
+	{
+		m_itemCache.resize(model()->rowCount());
+	}
+	ItemCache &item = m_itemCache[row];
+	if (!item.valid)
+	{
+		const QModelIndex index = model()->index(row, 0);
+		item.group = index.data(GroupViewRoles::GroupRole).toString();
+		item.size = itemDelegate()->sizeHint(viewOptions(), index);
+		item.valid = true;
+	}
+	return item;
+}
+
+QSize GroupView::itemSize(int row) const
+{
+	return cachedItem(row).size;
+}
+
 class LocaleString : public QString
 {
 public:
@@ -80,35 +148,49 @@ inline bool operator<(const LocaleString &lhs, const LocaleString &rhs)
 
 void GroupView::updateGeometries()
 {
-	geometryCache.clear();
 	int previousScroll = verticalScrollBar()->value();
+	const int rowCount = model()->rowCount();
+	if (m_itemCache.size() != rowCount)
+	{
+		// we missed something, start over
+		m_itemCache.clear();
+		m_itemCache.resize(rowCount);
+	}
 
+	// one pass over the model. the groups are kept, so their state and pointers to them survive
+	QHash<QString, VisualGroup *> existing;
+	for (auto group : m_groups)
+	{
+		existing.insert(group->text, group);
+		group->m_items.clear();
+	}
 	QMap<LocaleString, VisualGroup *> cats;
-
-	for (int i = 0; i < model()->rowCount(); ++i)
+	VisualGroup *group = nullptr;
+	for (int i = 0; i < rowCount; ++i)
 	{
-		const QString groupName =
-			model()->index(i, 0).data(GroupViewRoles::GroupRole).toString();
-		if (!cats.contains(groupName))
+		const QString &groupName = cachedItem(i).group;
+		// consecutive rows are usually in the same group
+		if (!group || group->text != groupName)
 		{
-			VisualGroup *old = this->category(groupName);
-			if (old)
-			{
-				cats.insert(groupName, new VisualGroup(old));
-			}
-			else
+			group = existing.value(groupName);
+			if (!group)
 			{
-				cats.insert(groupName, new VisualGroup(groupName, this));
+				group = new VisualGroup(groupName, this);
+				existing.insert(groupName, group);
 			}
+			cats.insert(groupName, group);
 		}
+		group->m_items.append(model()->index(i, 0));
 	}
-
-	/*if (m_editedCategory)
+	for (auto old : m_groups)
 	{
-		m_editedCategory = cats[m_editedCategory->text];
-	}*/
-
-	qDeleteAll(m_groups);
+		if (!cats.contains(old->text))
+		{
+			if (m_pressedCategory == old)
+				m_pressedCategory = nullptr;
+			delete old;
+		}
+	}
 	m_groups = cats.values();
 
 	for (auto cat : m_groups)
@@ -147,6 +229,27 @@ void GroupView::updateGeometries()
 		verticalScrollBar()->setRange(0, totalHeight - height());
 	}
 
+	m_placements.fill(Placement(), rowCount);
+	for (auto category : m_groups)
+	{
+		const int top = category->contentTop();
+		for (int r = 0; r < category->rows.size(); r++)
+		{
+			const VisualRow &row = category->rows[r];
+			for (int c = 0; c < row.items.size(); c++)
+			{
+				const int modelRow = row.items[c].row();
+				Placement &placement = m_placements[modelRow];
+				placement.group = category;
+				placement.column = c;
+				placement.row = r;
+				placement.rect = QRect(QPoint(m_spacing + c * (itemWidth() + m_spacing),
+											  top + row.top),
+									   itemSize(modelRow));
+			}
+		}
+	}
+
 	verticalScrollBar()->setValue(qMin(previousScroll, verticalScrollBar()->maximum()));
 
 	viewport()->update();
@@ -154,10 +257,37 @@ void GroupView::updateGeometries()
 
 void GroupView::modelReset()
 {
+	m_itemCache.clear();
 	scheduleDelayedItemsLayout();
 	executeDelayedItemsLayout();
 }
 
+void GroupView::modelLayoutAboutToBeChanged()
+{
+	// sorting moves the rows around, remember where the cached ones are going
+	m_layoutChangeRows.clear();
+	for (int row = 0; row < m_itemCache.size(); row++)
+	{
+		m_layoutChangeRows.append(QPersistentModelIndex(model()->index(row, 0)));
+	}
+}
+
+void GroupView::modelLayoutChanged()
+{
+	QVector<ItemCache> moved(model()->rowCount());
+	for (int i = 0; i < m_layoutChangeRows.size() && i < m_itemCache.size(); i++)
+	{
+		const QPersistentModelIndex &index = m_layoutChangeRows[i];
+		if (index.isValid() && index.row() < moved.size())
+		{
+			moved[index.row()] = m_itemCache[i];
+		}
+	}
+	m_itemCache = moved;
+	m_layoutChangeRows.clear();
+	scheduleDelayedItemsLayout();
+}
+
 bool GroupView::isIndexHidden(const QModelIndex &index) const
 {
 	VisualGroup *cat = category(index);
@@ -173,6 +303,11 @@ bool GroupView::isIndexHidden(const QModelIndex &index) const
 
 VisualGroup *GroupView::category(const QModelIndex &index) const
 {
+	int row = index.row();
+	if (row >= 0 && row < m_placements.size() && m_placements[row].group)
+	{
+		return m_placements[row].group;
+	}
 	return category(index.data(GroupViewRoles::GroupRole).toString());
 }
 
@@ -396,15 +531,22 @@ void GroupView::paintEvent(QPaintEvent *event)
 	QStyleOptionViewItemV4 option(viewOptions());
 	option.widget = this;
 
+	// only what intersects this (in geometry coordinates) gets painted
+	const QRect exposed = event->rect().translated(offset());
+
 	int wpWidth = viewport()->width();
 	option.rect.setWidth(wpWidth);
 	for (int i = 0; i < m_groups.size(); ++i)
 	{
 		VisualGroup *category = m_groups.at(i);
+		if (category->verticalPosition() > exposed.bottom())
+			break;
+		int height = category->totalHeight();
+		if (category->verticalPosition() + height < exposed.top())
+			continue;
 		int y = category->verticalPosition();
 		y -= verticalOffset();
 		QRect backup = option.rect;
-		int height = category->totalHeight();
 		option.rect.setTop(y);
 		option.rect.setHeight(height);
 		option.rect.setLeft(m_leftMargin);
@@ -414,17 +556,15 @@ void GroupView::paintEvent(QPaintEvent *event)
 		option.rect = backup;
 	}
 
-	for (int i = 0; i < model()->rowCount(); ++i)
+	option.features |=
+		QStyleOptionViewItemV2::WrapText; // FIXME: what is the meaning of this anyway?
+	const QStyle::State baseState = option.state;
+	for (int row : rowsIntersecting(exposed))
 	{
-		const QModelIndex index = model()->index(i, 0);
-		if (isIndexHidden(index))
-		{
-			continue;
-		}
+		const QModelIndex index = model()->index(row, 0);
 		Qt::ItemFlags flags = index.flags();
-		option.rect = visualRect(index);
-		option.features |=
-			QStyleOptionViewItemV2::WrapText; // FIXME: what is the meaning of this anyway?
+		option.rect = m_placements[row].rect.translated(-offset());
+		option.state = baseState;
 		if (flags & Qt::ItemIsSelectable && selectionModel()->isSelected(index))
 		{
 			option.state |= selectionModel()->isSelected(index) ? QStyle::State_Selected
@@ -604,33 +744,55 @@ QRect GroupView::geometryRect(const QModelIndex &index) const
 		return QRect();
 	}
 
+	// laid out in updateGeometries
 	int row = index.row();
-	if(geometryCache.contains(row))
+	if (row >= m_placements.size())
 	{
-		return *geometryCache[row];
+		return QRect();
 	}
+	return m_placements[row].rect;
+}
 
-	const VisualGroup *cat = category(index);
-	QPair<int, int> pos = cat->positionOf(index);
-	int x = pos.first;
-	// int y = pos.second;
-
-	QRect out;
-	out.setTop(cat->verticalPosition() + cat->headerHeight() + 5 + cat->rowTopOf(index));
-	out.setLeft(m_spacing + x * (itemWidth() + m_spacing));
-	out.setSize(itemDelegate()->sizeHint(viewOptions(), index));
-	geometryCache.insert(row, new QRect(out));
+QVector<int> GroupView::rowsIntersecting(const QRect &rect) const
+{
+	QVector<int> out;
+	// groups are stacked top to bottom, skip the ones above the rectangle
+	auto first = std::upper_bound(m_groups.begin(), m_groups.end(), rect.top(),
+								  [](int y, const VisualGroup *group)
+	{ return y < group->verticalPosition() + group->totalHeight(); });
+	for (auto iter = first; iter != m_groups.end(); ++iter)
+	{
+		const VisualGroup *group = *iter;
+		if (group->verticalPosition() > rect.bottom())
+			break;
+		if (group->collapsed)
+			continue;
+		const int top = group->contentTop();
+		for (int r = group->firstRowBelow(rect.top() - top); r < group->rows.size(); r++)
+		{
+			const VisualRow &row = group->rows[r];
+			if (top + row.top > rect.bottom())
+				break;
+			for (auto &index : row.items)
+			{
+				if (m_placements[index.row()].rect.intersects(rect))
+					out.append(index.row());
+			}
+		}
+	}
+	// groups are sorted by name, not by row
+	std::sort(out.begin(), out.end());
 	return out;
 }
 
 QModelIndex GroupView::indexAt(const QPoint &point) const
 {
-	for (int i = 0; i < model()->rowCount(); ++i)
+	const QPoint geometryPoint = point + offset();
+	for (int row : rowsIntersecting(QRect(geometryPoint, QSize(1, 1))))
 	{
-		QModelIndex index = model()->index(i, 0);
-		if (visualRect(index).contains(point))
+		if (m_placements[row].rect.contains(geometryPoint))
 		{
-			return index;
+			return model()->index(row, 0);
 		}
 	}
 	return QModelIndex();
@@ -639,15 +801,12 @@ QModelIndex GroupView::indexAt(const QPoint &point) const
 void GroupView::setSelection(const QRect &rect,
 							 const QItemSelectionModel::SelectionFlags commands)
 {
-	for (int i = 0; i < model()->rowCount(); ++i)
+	for (int row : rowsIntersecting(rect.translated(offset())))
 	{
-		QModelIndex index = model()->index(i, 0);
+		QModelIndex index = model()->index(row, 0);
 		QRect itemRect = visualRect(index);
-		if (itemRect.intersects(rect))
-		{
-			selectionModel()->select(index, commands);
-			update(itemRect.translated(-offset()));
-		}
+		selectionModel()->select(index, commands);
+		update(itemRect.translated(-offset()));
 	}
 }
 
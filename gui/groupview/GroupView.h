@@ -3,7 +3,7 @@
 #include <QListView>
 #include <QLineEdit>
 #include <QScrollBar>
-#include <QCache>
+#include <QVector>
 
 struct GroupViewRoles
 {
@@ -58,6 +58,8 @@ slots:
 	virtual void rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end) override;
 	virtual void updateGeometries() override;
 	void modelReset();
+	void modelLayoutAboutToBeChanged();
+	void modelLayoutChanged();
 
 protected:
 	virtual bool isIndexHidden(const QModelIndex &index) const override;
@@ -88,7 +90,27 @@ private:
 	int m_itemWidth = 100;
 	int m_currentItemsPerRow = -1;
 	int m_currentCursorColumn= -1;
-	mutable QCache<int, QRect> geometryCache;
+
+	// what the layout needs to know about a model row. only rows that changed are asked again.
+	struct ItemCache
+	{
+		QString group;
+		QSize size;
+		bool valid = false;
+	};
+	mutable QVector<ItemCache> m_itemCache;
+	// rows of m_itemCache, kept across a layout change of the model
+	QList<QPersistentModelIndex> m_layoutChangeRows;
+
+	// where each model row ended up in the last layout
+	struct Placement
+	{
+		VisualGroup *group = nullptr;
+		int column = 0;
+		int row = 0;
+		QRect rect;
+	};
+	QVector<Placement> m_placements;
 
 	// point where the currently active mouse action started in geometry coordinates
 	QPoint m_pressedPosition;
@@ -109,6 +131,13 @@ private:
 	int contentWidth() const;
 
 private: /* methods */
+	/// the cached entry for the model row, asking the model and delegate if it's not valid
+	const ItemCache &cachedItem(int row) const;
+	QSize itemSize(int row) const;
+	void invalidateRows(int first, int last);
+	/// model rows of the visible items intersecting the rectangle (in geometry coordinates),
+	/// in model order
+	QVector<int> rowsIntersecting(const QRect &rect) const;
 	int itemWidth() const;
 	int calculateItemsPerRow() const;
 	int verticalScrollToValue(const QModelIndex &index, const QRect &rect,
@@ -25,6 +25,8 @@
 #include "logic/InstanceList.h"
 
 QCache<QString, QPixmap> ListViewDelegate::m_pixmapCache;
+// 16 MiB of item tiles, shared by all the views
+QCache<QString, QPixmap> ListViewDelegate::m_tileCache(16 * 1024);
 
 // Origin: Qt
 static void viewItemTextLayout(QTextLayout &textLayout, int lineWidth, qreal &height,
@@ -51,6 +53,7 @@ static void viewItemTextLayout(QTextLayout &textLayout, int lineWidth, qreal &he
 
 ListViewDelegate::ListViewDelegate(QObject *parent) : QStyledItemDelegate(parent)
 {
+	m_textSizeCache.setMaxCost(2000);
 }
 
 void drawSelectionRect(QPainter *painter, const QStyleOptionViewItemV4 &option,
@@ -110,9 +113,9 @@ void drawProgressOverlay(QPainter *painter, const QStyleOptionViewItemV4 &option
 	painter->restore();
 }
 
-void drawBadges(QPainter *painter, const QStyleOptionViewItemV4 &option, BaseInstance *instance)
+static QStringList badgesFor(BaseInstance *instance)
 {
-	QList<QString> pixmaps;
+	QStringList pixmaps;
 	const BaseInstance::InstanceFlags flags = instance->flags();
 	if (flags & BaseInstance::VersionBrokenFlag)
 	{
@@ -124,26 +127,35 @@ void drawBadges(QPainter *painter, const QStyleOptionViewItemV4 &option, BaseIns
 	}
 
 	// begin easter eggs
-	if (instance->name().contains("btw", Qt::CaseInsensitive) ||
-		instance->name().contains("better then wolves", Qt::CaseInsensitive) ||
-		instance->name().contains("better than wolves", Qt::CaseInsensitive))
+	const QString name = instance->name();
+	if (name.contains("btw", Qt::CaseInsensitive) ||
+		name.contains("better then wolves", Qt::CaseInsensitive) ||
+		name.contains("better than wolves", Qt::CaseInsensitive))
 	{
 		pixmaps.append("herobrine");
 	}
-	if (instance->name().contains("direwolf", Qt::CaseInsensitive))
+	if (name.contains("direwolf", Qt::CaseInsensitive))
 	{
 		pixmaps.append("enderman");
 	}
-	if (instance->name().contains("kitten", Qt::CaseInsensitive))
+	if (name.contains("kitten", Qt::CaseInsensitive))
 	{
 		pixmaps.append("kitten");
 	}
-	if (instance->name().contains("derp", Qt::CaseInsensitive))
+	if (name.contains("derp", Qt::CaseInsensitive))
 	{
 		pixmaps.append("derp");
 	}
 	// end easter eggs
+	return pixmaps;
+}
 
+void drawBadges(QPainter *painter, const QStyleOptionViewItemV4 &option, const QStringList &pixmaps)
+{
+	if (pixmaps.isEmpty())
+	{
+		return;
+	}
 	static const int itemSide = 24;
 	static const int spacing = 1;
 	const int itemsPerRow = qMax(1, qFloor(double(option.rect.width() + spacing) / double(itemSide + spacing)));
@@ -186,19 +198,13 @@ static QSize viewItemTextSize(const QStyleOptionViewItemV4 *option)
 	return QSize(size.width() + 2 * textMargin, size.height());
 }
 
-void ListViewDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
-							 const QModelIndex &index) const
+// paints everything but the progress overlay
+static void paintItem(QPainter *painter, const QStyleOptionViewItemV4 &opt,
+					  const QStringList &badges)
 {
-	QStyleOptionViewItemV4 opt = option;
-	initStyleOption(&opt, index);
 	painter->save();
 	painter->setClipRect(opt.rect);
 
-	opt.features |= QStyleOptionViewItem::WrapText;
-	opt.text = index.data().toString();
-	opt.textElideMode = Qt::ElideRight;
-	opt.displayAlignment = Qt::AlignTop | Qt::AlignHCenter;
-
 	QStyle *style = opt.widget ? opt.widget->style() : QApplication::style();
 
 	// const int iconSize =  style->pixelMetric(QStyle::PM_IconViewIconSize);
@@ -317,20 +323,82 @@ void ListViewDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
 		line.draw(painter, position);
 	}
 
+	drawBadges(painter, opt, badges);
+
+	painter->restore();
+}
+
+// everything that changes what the tile of an item looks like
+static QString tileKey(const QStyleOptionViewItemV4 &opt, const QStringList &badges, int ratio)
+{
+	const int stateMask =
+		QStyle::State_Selected | QStyle::State_Enabled | QStyle::State_Active | QStyle::State_Open;
+	QStringList parts;
+	parts << QString::number(opt.rect.width()) << QString::number(opt.rect.height())
+		  << QString::number(ratio) << QString::number(int(opt.state & stateMask))
+		  << QString::number(opt.widget && opt.widget->isEnabled())
+		  << QString::number(opt.direction) << QString::number(opt.palette.cacheKey())
+		  << opt.font.key() << QString::number(opt.icon.cacheKey()) << badges.join(',')
+		  << opt.text;
+	return parts.join('|');
+}
+
+void ListViewDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+							 const QModelIndex &index) const
+{
+	QStyleOptionViewItemV4 opt = option;
+	initStyleOption(&opt, index);
+
+	opt.features |= QStyleOptionViewItem::WrapText;
+	opt.text = index.data().toString();
+	opt.textElideMode = Qt::ElideRight;
+	opt.displayAlignment = Qt::AlignTop | Qt::AlignHCenter;
+
 	// FIXME: this really has no business of being here. Make generic.
 	auto instance = (BaseInstance*)index.data(InstanceList::InstancePointerRole)
 			.value<void *>();
+	QStringList badges;
 	if (instance)
 	{
-		drawBadges(painter, opt, instance);
+		badges = badgesFor(instance);
+	}
+
+	// a background brush is aligned to the view, it can't be cached with the item
+	if (opt.backgroundBrush.style() != Qt::NoBrush || opt.rect.isEmpty())
+	{
+		paintItem(painter, opt, badges);
+	}
+	else
+	{
+		// laying out text and scaling icons is slow, blitting the result is not
+		const int ratio = painter->device()->devicePixelRatio();
+		const QString key = tileKey(opt, badges, ratio);
+		QPixmap tile;
+		if (QPixmap *cached = m_tileCache.object(key))
+		{
+			tile = *cached;
+		}
+		else
+		{
+			tile = QPixmap(opt.rect.size() * ratio);
+			tile.setDevicePixelRatio(ratio);
+			tile.fill(Qt::transparent);
+			QStyleOptionViewItemV4 tileOpt = opt;
+			tileOpt.rect = QRect(QPoint(0, 0), opt.rect.size());
+			QPainter tilePainter(&tile);
+			paintItem(&tilePainter, tileOpt, badges);
+			tilePainter.end();
+			// cost in KiB
+			m_tileCache.insert(key, new QPixmap(tile), tile.width() * tile.height() * 4 / 1024);
+		}
+		painter->drawPixmap(opt.rect.topLeft(), tile);
 	}
 
 	drawProgressOverlay(painter, opt, index.data(GroupViewRoles::ProgressValueRole).toInt(),
 						index.data(GroupViewRoles::ProgressMaximumRole).toInt());
-
-	painter->restore();
 }
 
+
 QSize ListViewDelegate::sizeHint(const QStyleOptionViewItem &option,
 								 const QModelIndex &index) const
 {
@@ -345,7 +413,18 @@ QSize ListViewDelegate::sizeHint(const QStyleOptionViewItem &option,
 	const int textMargin =
 		style->pixelMetric(QStyle::PM_FocusFrameHMargin, &option, opt.widget) + 1;
 	int height = 48 + textMargin * 2 + 5; // TODO: turn constants into variables
-	QSize szz = viewItemTextSize(&opt);
+	// only the text height depends on the item
+	const QString key = opt.font.key() + '|' + QString::number(textMargin) + '|' + opt.text;
+	QSize szz;
+	if (QSize *cached = m_textSizeCache.object(key))
+	{
+		szz = *cached;
+	}
+	else
+	{
+		szz = viewItemTextSize(&opt);
+		m_textSizeCache.insert(key, new QSize(szz));
+	}
 	height += szz.height();
 	// FIXME: maybe the icon items could scale and keep proportions?
 	QSize sz(100, height);
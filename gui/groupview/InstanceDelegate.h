@@ -32,4 +32,8 @@ protected:
 
 private:
 	static QCache<QString, QPixmap> m_pixmapCache;
+	// fully painted items, see tileKey()
+	static QCache<QString, QPixmap> m_tileCache;
+	// size of the laid out text, by font and text
+	mutable QCache<QString, QSize> m_textSizeCache;
 };
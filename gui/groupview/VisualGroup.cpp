@@ -5,6 +5,8 @@
 #include <QtMath>
 #include <QApplication>
 
+#include <algorithm>
+
 #include "GroupView.h"
 
 VisualGroup::VisualGroup(const QString &text, GroupView *view) : view(view), text(text), collapsed(false)
@@ -20,6 +22,8 @@ void VisualGroup::update()
 {
 	auto temp_items = items();
 	auto itemsPerRow = view->itemsPerRow();
+	// the font doesn't change between two layouts, there's no need to measure it for every item
+	m_headerHeight = calculateHeaderHeight();
 
 	int numRows = qMax(1, qCeil((qreal)temp_items.size() / (qreal)itemsPerRow));
 	rows = QVector<VisualRow>(numRows);
@@ -39,7 +43,7 @@ void VisualGroup::update()
 			positionInRow = 0;
 			maxRowHeight = 0;
 		}
-		auto itemHeight = view->itemDelegate()->sizeHint(view->viewOptions(), item).height();
+		auto itemHeight = view->itemSize(item.row()).height();
 		if(itemHeight > maxRowHeight)
 		{
 			maxRowHeight = itemHeight;
@@ -53,6 +57,13 @@ void VisualGroup::update()
 
 QPair<int, int> VisualGroup::positionOf(const QModelIndex &index) const
 {
+	// the view knows where every item of the current layout went
+	int row = index.row();
+	if (row >= 0 && row < view->m_placements.size() && view->m_placements[row].group == this)
+	{
+		auto &placement = view->m_placements[row];
+		return qMakePair(placement.column, placement.row);
+	}
 	int x = 0;
 	int y = 0;
 	for (auto & row: rows)
@@ -249,6 +260,11 @@ int VisualGroup::totalHeight() const
 }
 
 int VisualGroup::headerHeight() const
+{
+	return m_headerHeight;
+}
+
+int VisualGroup::calculateHeaderHeight()
 {
 	QFont font(QApplication::font());
     font.setBold(true);
@@ -286,16 +302,19 @@ int VisualGroup::verticalPosition() const
 	return m_verticalPosition;
 }
 
+int VisualGroup::contentTop() const
+{
+	return m_verticalPosition + headerHeight() + 5;
+}
+
+int VisualGroup::firstRowBelow(int y) const
+{
+	auto iter = std::upper_bound(rows.begin(), rows.end(), y, [](int y, const VisualRow &row)
+	{ return y < row.top + row.height; });
+	return iter - rows.begin();
+}
+
 QList<QModelIndex> VisualGroup::items() const
 {
-	QList<QModelIndex> indices;
-	for (int i = 0; i < view->model()->rowCount(); ++i)
-	{
-		const QModelIndex index = view->model()->index(i, 0);
-		if (index.data(GroupViewRoles::GroupRole).toString() == text)
-		{
-			indices.append(index);
-		}
-	}
-	return indices;
+	return m_items;
 }
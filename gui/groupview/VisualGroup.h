@@ -37,9 +37,12 @@ struct VisualGroup
 	QVector<VisualRow> rows;
 	int firstItemIndex = 0;
 	int m_verticalPosition = 0;
+	int m_headerHeight = 0;
+	/// the items of this group, in model order. filled in by the view.
+	QList<QModelIndex> m_items;
 
 /* logic */
-	/// update the internal list of items and flow them into the rows.
+	/// flow the items into rows, using the item sizes the view has cached.
 	void update();
 
 	/// draw the header at y-position.
@@ -63,6 +66,12 @@ struct VisualGroup
 	/// the height at which this group starts, in pixels
 	int verticalPosition() const;
 
+	/// the height at which the content (first row) starts, in pixels
+	int contentTop() const;
+
+	/// index of the first row that ends below the given y offset from contentTop()
+	int firstRowBelow(int y) const;
+
 	/// relative geometry - top of the row of the given item
 	int rowTopOf(const QModelIndex &index) const;
 
@@ -86,6 +95,9 @@ struct VisualGroup
 	HitResults hitScan (const QPoint &pos) const;
 
 	QList<QModelIndex> items() const;
+
+private:
+	static int calculateHeaderHeight();
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(VisualGroup::HitResults)
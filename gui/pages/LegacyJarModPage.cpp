@@ -119,9 +119,7 @@ void LegacyJarModPage::on_addForgeBtn_clicked()
 			dlg.exec(fjob);
 			if (dlg.result() == QDialog::Accepted)
 			{
-				m_jarmods->stopWatching();
 				m_jarmods->installMod(QFileInfo(entry->getFullPath()));
-				m_jarmods->startWatching();
 			}
 			else
 			{
@@ -130,9 +128,7 @@ void LegacyJarModPage::on_addForgeBtn_clicked()
 		}
 		else
 		{
-			m_jarmods->stopWatching();
 			m_jarmods->installMod(QFileInfo(entry->getFullPath()));
-			m_jarmods->startWatching();
 		}
 	}
 }
@@ -140,11 +136,11 @@ void LegacyJarModPage::on_addJarBtn_clicked()
 {
 	//: Title of jar mod selection dialog
 	QStringList fileNames = QFileDialog::getOpenFileNames(this, tr("Select Jar Mods"));
+	// one transaction for the whole batch
+	auto suspension = m_jarmods->suspendWatching();
 	for (auto filename : fileNames)
 	{
-		m_jarmods->stopWatching();
 		m_jarmods->installMod(QFileInfo(filename));
-		m_jarmods->startWatching();
 	}
 }
 
@@ -176,9 +172,7 @@ void LegacyJarModPage::on_rmJarBtn_clicked()
 
 	if (!lastfirst(list, first, last))
 		return;
-	m_jarmods->stopWatching();
 	m_jarmods->deleteMods(first, last);
-	m_jarmods->startWatching();
 }
 
 void LegacyJarModPage::on_viewJarBtn_clicked()
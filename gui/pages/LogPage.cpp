@@ -6,20 +6,23 @@
 #include <QIcon>
 #include <QScrollBar>
 #include <QShortcut>
+#include <QMenu>
 
 #include "logic/MinecraftProcess.h"
+#include "logic/LogModel.h"
 #include "gui/GuiUtil.h"
 
 LogPage::LogPage(MinecraftProcess *proc, QWidget *parent)
-	: QWidget(parent), ui(new Ui::LogPage), m_process(proc)
+	: QWidget(parent), ui(new Ui::LogPage), m_process(proc), m_model(new LogModel(this))
 {
 	ui->setupUi(this);
 	ui->tabWidget->tabBar()->hide();
+	ui->logView->setModel(m_model);
+	connect(m_model, SIGNAL(searchFinished()), SLOT(searchFinished()));
 	connect(m_process, SIGNAL(log(QString, MessageLevel::Enum)), this,
 			SLOT(write(QString, MessageLevel::Enum)));
 
-	// create the format and set its font
-	defaultFormat = new QTextCharFormat(ui->text->currentCharFormat());
+	// set the font
 	QString fontFamily = MMC->settings()->get("ConsoleFont").toString();
 	bool conversionOk = false;
 	int fontSize = MMC->settings()->get("ConsoleFontSize").toInt(&conversionOk);
@@ -27,7 +30,33 @@ LogPage::LogPage(MinecraftProcess *proc, QWidget *parent)
 	{
 		fontSize = 11;
 	}
-	defaultFormat->setFont(QFont(fontFamily, fontSize));
+	m_model->setFont(QFont(fontFamily, fontSize));
+
+	// the level filter
+	static const QList<QPair<MessageLevel::Enum, const char *>> levels = {
+		{MessageLevel::MultiMC, QT_TR_NOOP("MultiMC")},
+		{MessageLevel::PrePost, QT_TR_NOOP("Pre/post launch commands")},
+		{MessageLevel::Debug, QT_TR_NOOP("Debug")},
+		{MessageLevel::Info, QT_TR_NOOP("Info")},
+		{MessageLevel::Message, QT_TR_NOOP("Messages")},
+		{MessageLevel::Warning, QT_TR_NOOP("Warnings")},
+		{MessageLevel::Error, QT_TR_NOOP("Errors")},
+		{MessageLevel::Fatal, QT_TR_NOOP("Fatal errors")}};
+	auto levelsMenu = new QMenu(this);
+	for (auto level : levels)
+	{
+		auto action = levelsMenu->addAction(tr(level.second));
+		action->setCheckable(true);
+		action->setChecked(true);
+		const MessageLevel::Enum value = level.first;
+		connect(action, &QAction::toggled, [this, value](bool checked)
+		{
+			m_model->setLevelVisible(value, checked);
+			if (m_scroll_active)
+				ui->logView->scrollToBottom();
+		});
+	}
+	ui->levelsButton->setMenu(levelsMenu);
 
 	auto findShortcut = new QShortcut(QKeySequence(QKeySequence::Find), this);
 	connect(findShortcut, SIGNAL(activated()), SLOT(findActivated()));
@@ -41,7 +70,6 @@ LogPage::LogPage(MinecraftProcess *proc, QWidget *parent)
 LogPage::~LogPage()
 {
 	delete ui;
-	delete defaultFormat;
 }
 
 bool LogPage::apply()
@@ -56,17 +84,17 @@ bool LogPage::shouldDisplay() const
 
 void LogPage::on_btnPaste_clicked()
 {
-	GuiUtil::uploadPaste(ui->text->toPlainText(), this);
+	GuiUtil::uploadPaste(m_model->toPlainText(), this);
 }
 
 void LogPage::on_btnCopy_clicked()
 {
-	GuiUtil::setClipboardText(ui->text->toPlainText());
+	GuiUtil::setClipboardText(m_model->toPlainText());
 }
 
 void LogPage::on_btnClear_clicked()
 {
-	ui->text->clear();
+	m_model->clear();
 }
 
 void LogPage::on_trackLogCheckbox_clicked(bool checked)
@@ -92,33 +120,74 @@ void LogPage::findActivated()
 	// focus the search bar if it doesn't have focus
 	if (!ui->searchBar->hasFocus())
 	{
-		auto searchForCursor = ui->text->textCursor();
-		auto searchForString = searchForCursor.selectedText();
-		if (searchForString.size())
+		// search for the selected line
+		auto current = ui->logView->currentIndex();
+		if (current.isValid() && ui->logView->selectionModel()->isSelected(current))
 		{
-			ui->searchBar->setText(searchForString);
+			auto searchForString = current.data().toString().trimmed();
+			if (searchForString.size())
+			{
+				ui->searchBar->setText(searchForString);
+			}
 		}
 		ui->searchBar->setFocus();
 		ui->searchBar->selectAll();
 	}
 }
 
-void LogPage::findNextActivated()
+void LogPage::on_searchBar_textChanged(const QString &text)
 {
-	auto toSearch = ui->searchBar->text();
-	if (toSearch.size())
+	// the model searches in the background and narrows the previous matches down while
+	// typing, no need to wait for enter
+	m_model->setSearchTerm(text);
+}
+
+void LogPage::searchFinished()
+{
+	if (m_model->searchTerm().isEmpty())
+		ui->matchLabel->clear();
+	else
+		ui->matchLabel->setText(tr("%n line(s)", "", m_model->matchCount()));
+	if (m_findPending)
 	{
-		ui->text->find(toSearch);
+		m_findPending = false;
+		jumpToMatch(m_findBackwards);
 	}
 }
 
-void LogPage::findPreviousActivated()
+void LogPage::find(bool backwards)
 {
 	auto toSearch = ui->searchBar->text();
-	if (toSearch.size())
+	if (toSearch.isEmpty())
+		return;
+	m_model->setSearchTerm(toSearch);
+	if (m_model->searchPending())
 	{
-		ui->text->find(toSearch, QTextDocument::FindBackward);
+		m_findPending = true;
+		m_findBackwards = backwards;
+		return;
 	}
+	jumpToMatch(backwards);
+}
+
+void LogPage::jumpToMatch(bool backwards)
+{
+	auto found = m_model->findNext(ui->logView->currentIndex(), backwards);
+	if (found.isValid())
+	{
+		ui->logView->setCurrentIndex(found);
+		ui->logView->scrollTo(found);
+	}
+}
+
+void LogPage::findNextActivated()
+{
+	find(false);
+}
+
+void LogPage::findPreviousActivated()
+{
+	find(true);
 }
 
 void LogPage::write(QString data, MessageLevel::Enum mode)
@@ -131,10 +200,7 @@ void LogPage::write(QString data, MessageLevel::Enum mode)
 		}
 	}
 
-	// save the cursor so it can be restored.
-	auto savedCursor = ui->text->cursor();
-
-	QScrollBar *bar = ui->text->verticalScrollBar();
+	QScrollBar *bar = ui->logView->verticalScrollBar();
 	int max_bar = bar->maximum();
 	int val_bar = bar->value();
 	if (isVisible())
@@ -148,75 +214,11 @@ void LogPage::write(QString data, MessageLevel::Enum mode)
 			m_scroll_active = val_bar == max_bar;
 		}
 	}
-	if (data.endsWith('\n'))
-		data = data.left(data.length() - 1);
-	QStringList paragraphs = data.split('\n');
-	QStringList filtered;
-	for (QString &paragraph : paragraphs)
-	{
-		//TODO: implement filtering here.
-		filtered.append(paragraph);
-	}
-	QListIterator<QString> iter(filtered);
-	QTextCharFormat format(*defaultFormat);
-
-	switch(mode)
-	{
-		case MessageLevel::MultiMC:
-		{
-			format.setForeground(QColor("blue"));
-			break;
-		}
-		case MessageLevel::Debug:
-		{
-			format.setForeground(QColor("green"));
-			break;
-		}
-		case MessageLevel::Warning:
-		{
-			format.setForeground(QColor("orange"));
-			break;
-		}
-		case MessageLevel::Error:
-		{
-			format.setForeground(QColor("red"));
-			break;
-		}
-		case MessageLevel::Fatal:
-		{
-			format.setForeground(QColor("red"));
-			format.setBackground(QColor("black"));
-			break;
-		}
-		case MessageLevel::PrePost:
-		{
-			format.setForeground(QColor("grey"));
-			break;
-		}
-		case MessageLevel::Info:
-		case MessageLevel::Message:
-		default:
-		{
-			// do nothing, keep original
-		}
-	}
 
-	while (iter.hasNext())
-	{
-		// append a paragraph/line
-		auto workCursor = ui->text->textCursor();
-		workCursor.movePosition(QTextCursor::End);
-		workCursor.insertText(iter.next(), format);
-		workCursor.insertBlock();
-	}
+	m_model->append(data, mode);
 
-	if (isVisible())
+	if (isVisible() && m_scroll_active)
 	{
-		if (m_scroll_active)
-		{
-			bar->setValue(bar->maximum());
-		}
-		m_last_scroll_value = bar->value();
+		ui->logView->scrollToBottom();
 	}
-	ui->text->setCursor(savedCursor);
 }
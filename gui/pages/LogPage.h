@@ -28,7 +28,7 @@ namespace Ui
 {
 class LogPage;
 }
-class QTextCharFormat;
+class LogModel;
 
 class LogPage : public QWidget, public BasePage
 {
@@ -74,14 +74,19 @@ private slots:
 	void findActivated();
 	void findNextActivated();
 	void findPreviousActivated();
+	void on_searchBar_textChanged(const QString &text);
+	void searchFinished();
 
 private:
 	Ui::LogPage *ui;
 	MinecraftProcess *m_process;
-	int m_last_scroll_value = 0;
+	LogModel *m_model;
 	bool m_scroll_active = true;
-	int m_saved_offset = 0;
 	bool m_write_active = true;
+	/// a find waits for the search to finish
+	bool m_findPending = false;
+	bool m_findBackwards = false;
 
-	QTextCharFormat * defaultFormat;
+	void find(bool backwards);
+	void jumpToMatch(bool backwards);
 };
@@ -123,11 +123,11 @@ void ModFolderPage::on_addModBtn_clicked()
 {
 	QStringList fileNames = QFileDialog::getOpenFileNames(
 		this, QApplication::translate("ModFolderPage", "Select Loader Mods"));
+	// one transaction for the whole batch
+	auto suspension = m_mods->suspendWatching();
 	for (auto filename : fileNames)
 	{
-		m_mods->stopWatching();
 		m_mods->installMod(QFileInfo(filename));
-		m_mods->startWatching();
 	}
 }
 void ModFolderPage::on_rmModBtn_clicked()
@@ -137,9 +137,7 @@ void ModFolderPage::on_rmModBtn_clicked()
 
 	if (!lastfirst(list, first, last))
 		return;
-	m_mods->stopWatching();
 	m_mods->deleteMods(first, last);
-	m_mods->startWatching();
 }
 
 void ModFolderPage::on_viewModBtn_clicked()
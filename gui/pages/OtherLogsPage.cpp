@@ -18,20 +18,36 @@
 
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QTimer>
 
 #include "gui/GuiUtil.h"
 #include "logic/RecursiveFileSystemWatcher.h"
-#include "logic/BaseInstance.h"
+#include "logic/LogFileModel.h"
+#include "logic/Metrics.h"
 
-OtherLogsPage::OtherLogsPage(BaseInstance *instance, QWidget *parent)
-	: QWidget(parent), ui(new Ui::OtherLogsPage), m_instance(instance),
-	  m_watcher(new RecursiveFileSystemWatcher(this))
+OtherLogsPage::OtherLogsPage(QString path, QWidget *parent)
+	: QWidget(parent), ui(new Ui::OtherLogsPage), m_path(path),
+	  m_watcher(new RecursiveFileSystemWatcher(this)), m_model(new LogFileModel(this)),
+	  m_followTimer(new QTimer(this))
 {
 	ui->setupUi(this);
 	ui->tabWidget->tabBar()->hide();
 
-	m_watcher->setFileExpression("(.*\\.log(\\.[0-9]*)?$)|(crash-.*\\.txt)");
-	m_watcher->setRootDir(QDir::current().absoluteFilePath(m_instance->minecraftRoot()));
+	QFont font("Monospace");
+	font.setStyleHint(QFont::TypeWriter);
+	ui->logView->setFont(font);
+	ui->logView->setModel(m_model);
+	m_model->setFollowing(ui->followBox->isChecked());
+	connect(m_model, SIGNAL(failed(QString)), SLOT(logFailed(QString)));
+	connect(m_model, SIGNAL(loaded()), SLOT(logLoaded()));
+	connect(m_model, SIGNAL(rowsInserted(QModelIndex, int, int)), SLOT(linesAdded()));
+
+	// growing logs are picked up while following them
+	m_followTimer->setInterval(1000);
+	connect(m_followTimer, SIGNAL(timeout()), m_model, SLOT(refresh()));
+
+	m_watcher->setFileExpression("(.*\\.log(\\.[0-9]*)?(\\.gz)?$)|(crash-.*\\.txt)");
+	m_watcher->setRootDir(QDir::current().absoluteFilePath(m_path));
 
 	connect(m_watcher, &RecursiveFileSystemWatcher::filesChanged, this,
 			&OtherLogsPage::populateSelectLogBox);
@@ -46,10 +62,13 @@ OtherLogsPage::~OtherLogsPage()
 void OtherLogsPage::opened()
 {
 	m_watcher->enable();
+	if (ui->followBox->isChecked())
+		m_followTimer->start();
 }
 void OtherLogsPage::closed()
 {
 	m_watcher->disable();
+	m_followTimer->stop();
 }
 
 void OtherLogsPage::populateSelectLogBox()
@@ -76,53 +95,76 @@ void OtherLogsPage::on_selectLogBox_currentIndexChanged(const int index)
 		file = ui->selectLogBox->itemText(index);
 	}
 
-	if (file.isEmpty() || !QFile::exists(m_instance->minecraftRoot() + "/" + file))
+	if (file.isEmpty() || !QFile::exists(m_path + "/" + file))
 	{
 		m_currentFile = QString();
-		ui->text->clear();
+		m_model->close();
 		setControlsEnabled(false);
 	}
 	else
 	{
 		m_currentFile = file;
-		on_btnReload_clicked();
 		setControlsEnabled(true);
+		on_btnReload_clicked();
 	}
 }
 
 void OtherLogsPage::on_btnReload_clicked()
 {
-	QFile file(m_instance->minecraftRoot() + "/" + m_currentFile);
-	if (!file.open(QFile::ReadOnly))
+	// the model only starts indexing here, the time is taken when it's done
+	m_openTimer.start();
+	Metrics::PhaseMarker phase("other_logs_open");
+	// rotated logs are gzipped, the model unpacks them
+	m_model->open(m_path + "/" + m_currentFile);
+}
+
+void OtherLogsPage::logLoaded()
+{
+	static auto &openTime = Metrics::Registry::instance().histogram(
+		"other_logs_open_ms", "Time it takes to open and index a log file, in milliseconds.");
+	if (!m_openTimer.isValid())
+		return;
+	openTime.observe(m_openTimer.elapsed());
+	m_openTimer.invalidate();
+}
+
+void OtherLogsPage::logFailed(QString reason)
+{
+	m_openTimer.invalidate();
+	setControlsEnabled(false);
+	ui->btnReload->setEnabled(true); // allow reload
+	QMessageBox::critical(this, tr("Error"),
+						  tr("Unable to open %1 for reading: %2").arg(m_currentFile, reason));
+}
+
+void OtherLogsPage::linesAdded()
+{
+	if (ui->followBox->isChecked())
+		ui->logView->scrollToBottom();
+}
+
+void OtherLogsPage::on_followBox_toggled(bool checked)
+{
+	m_model->setFollowing(checked);
+	if (checked)
 	{
-		setControlsEnabled(false);
-		ui->btnReload->setEnabled(true); // allow reload
-		m_currentFile = QString();
-		QMessageBox::critical(this, tr("Error"), tr("Unable to open %1 for reading: %2")
-													 .arg(m_currentFile, file.errorString()));
+		m_followTimer->start();
+		m_model->refresh();
+		ui->logView->scrollToBottom();
 	}
 	else
 	{
-		if (file.size() < 10000000ll)
-		{
-			ui->text->setPlainText(QString::fromUtf8(file.readAll()));
-		}
-		else
-		{
-			ui->text->setPlainText(
-				tr("The file (%1) is too big. You may want to open it in a viewer optimized "
-				   "for large files.").arg(file.fileName()));
-		}
+		m_followTimer->stop();
 	}
 }
 
 void OtherLogsPage::on_btnPaste_clicked()
 {
-	GuiUtil::uploadPaste(ui->text->toPlainText(), this);
+	GuiUtil::uploadPaste(m_model->text(), this);
 }
 void OtherLogsPage::on_btnCopy_clicked()
 {
-	GuiUtil::setClipboardText(ui->text->toPlainText());
+	GuiUtil::setClipboardText(m_model->text());
 }
 void OtherLogsPage::on_btnDelete_clicked()
 {
@@ -132,7 +174,9 @@ void OtherLogsPage::on_btnDelete_clicked()
 	{
 		return;
 	}
-	QFile file(m_instance->minecraftRoot() + "/" + m_currentFile);
+	// the file can't be removed while it's mapped on some platforms
+	m_model->close();
+	QFile file(m_path + "/" + m_currentFile);
 	if (!file.remove())
 	{
 		QMessageBox::critical(this, tr("Error"), tr("Unable to delete %1: %2")
@@ -146,5 +190,5 @@ void OtherLogsPage::setControlsEnabled(const bool enabled)
 	ui->btnDelete->setEnabled(enabled);
 	ui->btnCopy->setEnabled(enabled);
 	ui->btnPaste->setEnabled(enabled);
-	ui->text->setEnabled(enabled);
+	ui->logView->setEnabled(enabled);
 }
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QWidget>
+#include <QElapsedTimer>
 
 #include "BasePage.h"
 
@@ -25,15 +26,18 @@ class OtherLogsPage;
 }
 
 class RecursiveFileSystemWatcher;
+class LogFileModel;
+class QTimer;
 
-class BaseInstance;
-
+/**
+ * Lists the log files below a folder and shows them, gzipped or not.
+ */
 class OtherLogsPage : public QWidget, public BasePage
 {
 	Q_OBJECT
 
 public:
-	explicit OtherLogsPage(BaseInstance *instance, QWidget *parent = 0);
+	explicit OtherLogsPage(QString path, QWidget *parent = 0);
 	~OtherLogsPage();
 
 	QString id() const override
@@ -62,12 +66,20 @@ private slots:
 	void on_btnPaste_clicked();
 	void on_btnCopy_clicked();
 	void on_btnDelete_clicked();
+	void on_followBox_toggled(bool checked);
+	void logFailed(QString reason);
+	void logLoaded();
+	void linesAdded();
 
 private:
 	Ui::OtherLogsPage *ui;
-	BaseInstance *m_instance;
+	QString m_path;
 	RecursiveFileSystemWatcher *m_watcher;
+	LogFileModel *m_model;
+	QTimer *m_followTimer;
 	QString m_currentFile;
+	/// runs from open() until the model has indexed the file
+	QElapsedTimer m_openTimer;
 
 	void setControlsEnabled(const bool enabled);
 };
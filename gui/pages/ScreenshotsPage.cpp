@@ -14,6 +14,7 @@
 #include <QClipboard>
 #include <QDesktopServices>
 #include <QKeyEvent>
+#include <QMutex>
 
 #include <pathutils.h>
 
@@ -24,9 +25,12 @@
 #include "logic/screenshots/ImgurAlbumCreation.h"
 #include "logic/tasks/SequentialTask.h"
 
-#include "logic/RWStorage.h"
+#include "logic/screenshots/ThumbnailCache.h"
+#include "logic/ConcurrentCache.h"
+#include "logic/Metrics.h"
+#include "MultiMC.h"
 
-typedef RWStorage<QString, QIcon> SharedIconCache;
+typedef ConcurrentCache<QString, QIcon> SharedIconCache;
 typedef std::shared_ptr<SharedIconCache> SharedIconCachePtr;
 
 class ThumbnailingResult : public QObject
@@ -40,56 +44,76 @@ signals:
 	void resultsFailed(const QString &path);
 };
 
+/*
+ * Screenshots waiting for a thumbnail, the most recently requested first.
+ *
+ * The view asks for the decorations of the items it paints, so whatever is on screen right
+ * now was asked for last and gets done first. Scrolling moves the new items to the front.
+ */
+class ThumbnailQueue
+{
+public:
+	/// returns false if the path was already waiting (it is moved to the front)
+	bool push(const QString &path)
+	{
+		QMutexLocker locker(&m_mutex);
+		bool waiting = m_paths.removeOne(path);
+		m_paths.append(path);
+		return !waiting;
+	}
+	QString pop()
+	{
+		QMutexLocker locker(&m_mutex);
+		if (m_paths.isEmpty())
+			return QString();
+		return m_paths.takeLast();
+	}
+	void clear()
+	{
+		QMutexLocker locker(&m_mutex);
+		m_paths.clear();
+	}
+
+private:
+	QMutex m_mutex;
+	QList<QString> m_paths;
+};
+typedef std::shared_ptr<ThumbnailQueue> ThumbnailQueuePtr;
+
 class ThumbnailRunnable : public QRunnable
 {
 public:
-	ThumbnailRunnable(QString path, SharedIconCachePtr cache)
+	ThumbnailRunnable(ThumbnailQueuePtr queue, SharedIconCachePtr cache,
+					  ThumbnailCachePtr diskCache)
 	{
-		m_path = path;
+		m_queue = queue;
 		m_cache = cache;
+		m_diskCache = diskCache;
 	}
 	void run()
 	{
-		QFileInfo info(m_path);
-		if (info.isDir())
+		// not necessarily the one this runnable was started for, see ThumbnailQueue
+		QString path = m_queue->pop();
+		if (path.isEmpty())
 			return;
-		if ((info.suffix().compare("png", Qt::CaseInsensitive) != 0))
+		if (!m_cache->stale(path))
 			return;
-		int tries = 5;
-		while (tries)
+		// a screenshot that is still being written fails here and gets another try when
+		// the watcher sees it change
+		QImage thumbnail = m_diskCache->get(path);
+		if (thumbnail.isNull())
 		{
-			if (!m_cache->stale(m_path))
-				return;
-			QImage image(m_path);
-			if (image.isNull())
-			{
-				QThread::msleep(500);
-				tries--;
-				continue;
-			}
-			QImage small;
-			if (image.width() > image.height())
-				small = image.scaledToWidth(512).scaledToWidth(256, Qt::SmoothTransformation);
-			else
-				small = image.scaledToHeight(512).scaledToHeight(256, Qt::SmoothTransformation);
-			auto smallSize = small.size();
-			QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
-			QImage square(QSize(256, 256), QImage::Format_ARGB32);
-			square.fill(Qt::transparent);
-
-			QPainter painter(&square);
-			painter.drawImage(offset, small);
-			painter.end();
-
-			QIcon icon(QPixmap::fromImage(square));
-			m_cache->add(m_path, icon);
-			m_resultEmitter.emitResultsReady(m_path);
+			m_resultEmitter.emitResultsFailed(path);
 			return;
 		}
-		m_resultEmitter.emitResultsFailed(m_path);
+		QIcon icon(QPixmap::fromImage(thumbnail));
+		// cost in KiB
+		m_cache->insert(path, icon, thumbnail.byteCount() / 1024);
+		m_resultEmitter.emitResultsReady(path);
 	}
-	QString m_path;
+	ThumbnailQueuePtr m_queue;
 	SharedIconCachePtr m_cache;
+	ThumbnailCachePtr m_diskCache;
 	ThumbnailingResult m_resultEmitter;
 };
 
@@ -102,12 +126,19 @@ public:
 	explicit FilterModel(QObject *parent = 0) : QIdentityProxyModel(parent)
 	{
 		m_thumbnailingPool.setMaxThreadCount(4);
-		m_thumbnailCache = std::make_shared<SharedIconCache>();
-		m_thumbnailCache->add("placeholder", QIcon::fromTheme("screenshot-placeholder"));
+		m_thumbnailQueue = std::make_shared<ThumbnailQueue>();
+		// 64 MiB of thumbnails, the rest is reloaded from the disk cache when needed
+		m_thumbnailCache = std::make_shared<SharedIconCache>(64 * 1024);
+		m_placeholder = QIcon::fromTheme("screenshot-placeholder");
 		connect(&watcher, SIGNAL(fileChanged(QString)), SLOT(fileChanged(QString)));
 		// FIXME: the watched file set is not updated when files are removed
 	}
-	virtual ~FilterModel() { m_thumbnailingPool.waitForDone(500); }
+	virtual ~FilterModel()
+	{
+		// the runnables that are left find nothing to do
+		m_thumbnailQueue->clear();
+		m_thumbnailingPool.waitForDone(500);
+	}
 	virtual QVariant data(const QModelIndex &proxyIndex, int role = Qt::DisplayRole) const
 	{
 		auto model = sourceModel();
@@ -129,15 +160,21 @@ public:
 				((QFileSystemWatcher &)watcher).addPath(filePath);
 				((QSet<QString> &)watched).insert(filePath);
 			}
+			static auto &hits = Metrics::Registry::instance().counter(
+				"thumbnail_memory_hits_total", "Thumbnails found in the in-memory icon cache.");
+			static auto &misses = Metrics::Registry::instance().counter(
+				"thumbnail_memory_misses_total", "Thumbnails not in the in-memory icon cache.");
 			if (m_thumbnailCache->get(filePath, temp))
 			{
+				hits.add();
 				return temp;
 			}
+			misses.add();
 			if (!m_failed.contains(filePath))
 			{
 				((FilterModel *)this)->thumbnailImage(filePath);
 			}
-			return (m_thumbnailCache->get("placeholder"));
+			return m_placeholder;
 		}
 		return sourceModel()->data(mapToSource(proxyIndex), role);
 	}
@@ -161,7 +198,10 @@ public:
 private:
 	void thumbnailImage(QString path)
 	{
-		auto runnable = new ThumbnailRunnable(path, m_thumbnailCache);
+		// one runnable per waiting path
+		if (!m_thumbnailQueue->push(path))
+			return;
+		auto runnable = new ThumbnailRunnable(m_thumbnailQueue, m_thumbnailCache, MMC->thumbnails());
 		connect(&(runnable->m_resultEmitter), SIGNAL(resultsReady(QString)),
 				SLOT(thumbnailReady(QString)));
 		connect(&(runnable->m_resultEmitter), SIGNAL(resultsFailed(QString)),
@@ -169,10 +209,18 @@ private:
 		((QThreadPool &)m_thumbnailingPool).start(runnable);
 	}
 private slots:
-	void thumbnailReady(QString path) { emit layoutChanged(); }
+	void thumbnailReady(QString path)
+	{
+		auto fsModel = qobject_cast<QFileSystemModel *>(sourceModel());
+		if (!fsModel)
+			return;
+		auto index = mapFromSource(fsModel->index(path));
+		emit dataChanged(index, index, {Qt::DecorationRole});
+	}
 	void thumbnailFailed(QString path) { m_failed.insert(path); }
 	void fileChanged(QString filepath)
 	{
+		m_failed.remove(filepath);
 		m_thumbnailCache->setStale(filepath);
 		thumbnailImage(filepath);
 		// reinsert the path...
@@ -181,7 +229,9 @@ private slots:
 	}
 
 private:
+	ThumbnailQueuePtr m_thumbnailQueue;
 	SharedIconCachePtr m_thumbnailCache;
+	QIcon m_placeholder;
 	QThreadPool m_thumbnailingPool;
 	QSet<QString> m_failed;
 	QSet<QString> watched;
@@ -335,6 +385,7 @@ void ScreenshotsPage::on_deleteBtn_clicked()
 	auto selected = ui->listView->selectionModel()->selectedIndexes();
 	for (auto item : selected)
 	{
+		MMC->thumbnails()->remove(m_model->fileInfo(item).absoluteFilePath());
 		m_model->remove(item);
 	}
 }
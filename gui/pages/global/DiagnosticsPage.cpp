@@ -0,0 +1,131 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "DiagnosticsPage.h"
+#include "ui_DiagnosticsPage.h"
+
+#include <QFileDialog>
+#include <QSaveFile>
+#include <QTabBar>
+
+#include "gui/dialogs/CustomMessageBox.h"
+#include "logic/Metrics.h"
+#include "logic/StallDetector.h"
+#include "MultiMC.h"
+
+DiagnosticsPage::DiagnosticsPage(QWidget *parent) : QWidget(parent), ui(new Ui::DiagnosticsPage)
+{
+	ui->setupUi(this);
+	ui->tabWidget->tabBar()->hide();
+	ui->metricsTree->sortByColumn(0, Qt::AscendingOrder);
+	m_refreshTimer.setInterval(1000);
+	connect(&m_refreshTimer, SIGNAL(timeout()), SLOT(refresh()));
+}
+
+DiagnosticsPage::~DiagnosticsPage()
+{
+	delete ui;
+}
+
+void DiagnosticsPage::opened()
+{
+	refresh();
+	m_refreshTimer.start();
+}
+
+void DiagnosticsPage::closed()
+{
+	m_refreshTimer.stop();
+}
+
+void DiagnosticsPage::refresh()
+{
+	const double seconds = m_sinceLast.isValid() ? m_sinceLast.restart() / 1000.0 : 0;
+	if (!m_sinceLast.isValid())
+		m_sinceLast.start();
+
+	for (auto &entry : Metrics::Registry::instance().entries())
+	{
+		QTreeWidgetItem *item = m_items.value(entry.name);
+		if (!item)
+		{
+			item = new QTreeWidgetItem(ui->metricsTree);
+			item->setText(0, entry.name);
+			item->setToolTip(0, entry.help);
+			for (int column = 1; column < ui->metricsTree->columnCount(); column++)
+				item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+			m_items.insert(entry.name, item);
+		}
+		if (entry.type == Metrics::Registry::CounterType)
+		{
+			const qint64 value = entry.counter->value();
+			item->setText(1, QString::number(value));
+			if (seconds > 0 && m_lastValues.contains(entry.name))
+			{
+				const double rate = (value - m_lastValues[entry.name]) / seconds;
+				item->setText(2, QString::number(rate, 'f', 1));
+			}
+			m_lastValues[entry.name] = value;
+		}
+		else
+		{
+			auto data = entry.histogram->snapshot();
+			item->setText(1, QString::number(data.count));
+			if (data.count)
+			{
+				item->setText(3, QString::number(data.sum / data.count, 'f', 1));
+				item->setText(4, QString::number(data.max, 'f', 1));
+			}
+		}
+	}
+	for (int column = 0; column < ui->metricsTree->columnCount(); column++)
+		ui->metricsTree->resizeColumnToContents(column);
+
+	auto detector = MMC->stallDetector();
+	QString stalls = detector ? detector->report() : QString();
+	if (stalls.isEmpty())
+		stalls = tr("None so far.");
+	if (ui->stallsView->toPlainText() != stalls)
+		ui->stallsView->setPlainText(stalls);
+}
+
+void DiagnosticsPage::exportTo(const QString &filter, const QString &suffix,
+							   const QByteArray &data)
+{
+	QString path = QFileDialog::getSaveFileName(this, tr("Export metrics"),
+												"multimc-metrics." + suffix, filter);
+	if (path.isEmpty())
+		return;
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+		file.write(data) != data.size() || !file.commit())
+	{
+		CustomMessageBox::selectable(this, tr("Export failed"),
+									 tr("Could not write %1:\n%2").arg(path, file.errorString()),
+									 QMessageBox::Warning)->exec();
+	}
+}
+
+void DiagnosticsPage::on_exportJsonBtn_clicked()
+{
+	exportTo(tr("JSON files (*.json)"), "json", Metrics::Registry::instance().toJson());
+}
+
+void DiagnosticsPage::on_exportPrometheusBtn_clicked()
+{
+	exportTo(tr("Prometheus text files (*.prom *.txt)"), "prom",
+			 Metrics::Registry::instance().toPrometheus());
+}
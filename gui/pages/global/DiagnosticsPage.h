@@ -0,0 +1,75 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMap>
+
+#include "gui/pages/BasePage.h"
+
+namespace Ui
+{
+class DiagnosticsPage;
+}
+
+class QTreeWidgetItem;
+
+/**
+ * Shows the counters and histograms from the metrics registry, and exports them.
+ * Also lists the GUI thread stalls seen so far, by phase.
+ */
+class DiagnosticsPage : public QWidget, public BasePage
+{
+	Q_OBJECT
+
+public:
+	explicit DiagnosticsPage(QWidget *parent = 0);
+	~DiagnosticsPage();
+
+	QString displayName() const override
+	{
+		return tr("Diagnostics");
+	}
+	QIcon icon() const override
+	{
+		return QIcon::fromTheme("bug");
+	}
+	QString id() const override
+	{
+		return "diagnostics";
+	}
+	void opened() override;
+	void closed() override;
+
+private
+slots:
+	void refresh();
+	void on_exportJsonBtn_clicked();
+	void on_exportPrometheusBtn_clicked();
+
+private:
+	void exportTo(const QString &filter, const QString &suffix, const QByteArray &data);
+
+	Ui::DiagnosticsPage *ui;
+	QTimer m_refreshTimer;
+	QMap<QString, QTreeWidgetItem *> m_items;
+	// counter values at the last refresh, for the rates
+	QMap<QString, qint64> m_lastValues;
+	QElapsedTimer m_sinceLast;
+};
@@ -0,0 +1,42 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "gui/pages/OtherLogsPage.h"
+
+/**
+ * The rotated launcher logs, from the log archive folder.
+ */
+class LauncherLogsPage : public OtherLogsPage
+{
+	Q_OBJECT
+
+public:
+	explicit LauncherLogsPage(QWidget *parent = 0);
+
+	QString id() const override
+	{
+		return "launcher-logs";
+	}
+	QString displayName() const override
+	{
+		return tr("Launcher logs");
+	}
+	QString helpPage() const override
+	{
+		return QString();
+	}
+};
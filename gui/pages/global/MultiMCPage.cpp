@@ -317,6 +317,7 @@ void MultiMCPage::applySettings()
 	s->set("CentralModsDir", ui->modsDirTextBox->text());
 	s->set("LWJGLDir", ui->lwjglDirTextBox->text());
 	s->set("IconsDir", ui->iconsDirTextBox->text());
+	s->set("UseModStore", ui->modStoreCheckBox->isChecked());
 
 	auto sortMode = (InstSortMode)ui->sortingModeGroup->checkedId();
 	switch (sortMode)
@@ -405,6 +406,7 @@ void MultiMCPage::loadSettings()
 	ui->modsDirTextBox->setText(s->get("CentralModsDir").toString());
 	ui->lwjglDirTextBox->setText(s->get("LWJGLDir").toString());
 	ui->iconsDirTextBox->setText(s->get("IconsDir").toString());
+	ui->modStoreCheckBox->setChecked(s->get("UseModStore").toBool());
 
 	QString sortMode = s->get("InstSortMode").toString();
 
@@ -26,6 +26,10 @@
 #include "QsLog.h"
 #include "QsLogDest.h"
 #include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QAtomicInt>
+#include <QAtomicPointer>
 #include <QList>
 #include <QDateTime>
 #include <QtGlobal>
@@ -37,12 +41,37 @@ namespace QsLogging
 {
 typedef QList<Destination *> DestinationList;
 
-static const char *LevelStrings[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"
-																				"UNKNOWN"};
+static const char *LevelStrings[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL",
+									 "UNKNOWN"};
 
 // not using Qt::ISODate because we need the milliseconds too
 static const QString fmtDateTime("hhhh:mm:ss.zzz");
 
+// how many messages may wait for the writer before less important ones get dropped
+static const int maxPendingMessages = 65536;
+// past this, warnings and errors are dropped too. only fatal messages always get through
+static const int maxPendingImportantMessages = 4 * maxPendingMessages;
+
+static const char *CategoryNames[] = {"general", "net", "jar", "mods", "process"};
+
+QBasicAtomicInt categoryLevels[CategoryCount] = {
+	Q_BASIC_ATOMIC_INITIALIZER(InfoLevel), Q_BASIC_ATOMIC_INITIALIZER(InfoLevel),
+	Q_BASIC_ATOMIC_INITIALIZER(InfoLevel), Q_BASIC_ATOMIC_INITIALIZER(InfoLevel),
+	Q_BASIC_ATOMIC_INITIALIZER(InfoLevel)};
+
+static bool LevelFromText(const QString &text, Level &level)
+{
+	for (int i = TraceLevel; i <= FatalLevel; i++)
+	{
+		if (text.compare(LevelStrings[i], Qt::CaseInsensitive) == 0)
+		{
+			level = Level(i);
+			return true;
+		}
+	}
+	return false;
+}
+
 static const char *LevelToText(Level theLevel)
 {
 	if (theLevel > FatalLevel)
@@ -53,15 +82,173 @@ static const char *LevelToText(Level theLevel)
 	return LevelStrings[theLevel];
 }
 
-class LoggerImpl
+struct LogNode
+{
+	QString message;
+	QAtomicPointer<LogNode> next;
+};
+
+/*!
+ * Log messages go through an intrusive multi-producer single-consumer queue (Vyukov's).
+ * Producers never lock, the writer thread is the only consumer. It writes out everything
+ * that piled up since it last woke up and flushes the destinations once per batch.
+ *
+ * Anything that needs the messages on disk right now (flush(), removing a destination)
+ * becomes the consumer temporarily by taking consumerMutex.
+ *
+ * Going to sleep is a store-then-load on both sides: the producer publishes a message and
+ * then checks 'sleeping', the writer sets 'sleeping' and then checks 'pending'. Both need
+ * sequentially consistent operations, or each side may miss the other's store and the
+ * message waits for the wait timeout.
+ */
+class LoggerImpl : public QThread
 {
 public:
-	LoggerImpl() : level(InfoLevel)
+	LoggerImpl() : tail(&stub)
+	{
+		head.storeRelease(&stub);
+	}
+
+	void enqueue(Level messageLevel, const QString &message)
+	{
+		const int queued = pending.fetchAndAddOrdered(1);
+		if ((queued >= maxPendingMessages && messageLevel < WarnLevel) ||
+			(queued >= maxPendingImportantMessages && messageLevel < FatalLevel))
+		{
+			pending.fetchAndAddOrdered(-1);
+			dropped.fetchAndAddRelaxed(1);
+			return;
+		}
+		LogNode *node = new LogNode;
+		node->message = message;
+		push(node);
+		// a sequentially consistent load, pairs with the store in run()
+		if (sleeping.fetchAndAddOrdered(0))
+		{
+			QMutexLocker lock(&wakeMutex);
+			wakeCondition.wakeOne();
+		}
+	}
+
+	//! writes out everything in the queue. consumerMutex has to be held.
+	void drain()
 	{
+		int written = 0;
+		while (LogNode *node = pop())
+		{
+			for (auto destination : destList)
+			{
+				destination->write(node->message);
+			}
+			delete node;
+			pending.fetchAndAddOrdered(-1);
+			written++;
+		}
+		int lost = dropped.fetchAndStoreRelaxed(0);
+		if (lost)
+		{
+			const QString message = QString("%1\t%2 log messages were dropped")
+										.arg(LevelToText(WarnLevel), 5)
+										.arg(lost);
+			for (auto destination : destList)
+			{
+				destination->write(message);
+			}
+			written++;
+		}
+		if (written)
+		{
+			for (auto destination : destList)
+			{
+				destination->flush();
+			}
+		}
+	}
+
+	void stop()
+	{
+		stopping.storeRelease(1);
+		{
+			QMutexLocker lock(&wakeMutex);
+			wakeCondition.wakeOne();
+		}
+		wait();
+		QMutexLocker lock(&consumerMutex);
+		drain();
 	}
-	QMutex logMutex;
-	Level level;
+
 	DestinationList destList;
+	QMutex consumerMutex;
+
+protected:
+	virtual void run()
+	{
+		while (true)
+		{
+			{
+				QMutexLocker lock(&consumerMutex);
+				drain();
+			}
+			if (stopping.loadAcquire())
+				break;
+			QMutexLocker lock(&wakeMutex);
+			sleeping.fetchAndStoreOrdered(1);
+			if (!pending.fetchAndAddOrdered(0) && !stopping.loadAcquire())
+			{
+				wakeCondition.wait(&wakeMutex, 1000);
+			}
+			sleeping.fetchAndStoreOrdered(0);
+		}
+	}
+
+private:
+	void push(LogNode *node)
+	{
+		node->next.store(nullptr);
+		LogNode *prev = head.fetchAndStoreOrdered(node);
+		prev->next.storeRelease(node);
+	}
+
+	LogNode *pop()
+	{
+		LogNode *first = tail;
+		LogNode *next = first->next.loadAcquire();
+		if (first == &stub)
+		{
+			if (!next)
+				return nullptr;
+			tail = next;
+			first = next;
+			next = next->next.loadAcquire();
+		}
+		if (next)
+		{
+			tail = next;
+			return first;
+		}
+		// a producer is in the middle of push(), try again later
+		if (first != head.loadAcquire())
+			return nullptr;
+		push(&stub);
+		next = first->next.loadAcquire();
+		if (next)
+		{
+			tail = next;
+			return first;
+		}
+		return nullptr;
+	}
+
+	QAtomicPointer<LogNode> head;
+	LogNode *tail;
+	LogNode stub;
+
+	QAtomicInt pending;
+	QAtomicInt dropped;
+	QAtomicInt sleeping;
+	QAtomicInt stopping;
+	QMutex wakeMutex;
+	QWaitCondition wakeCondition;
 };
 
 Logger::Logger() : d(new LoggerImpl)
@@ -70,37 +257,110 @@ Logger::Logger() : d(new LoggerImpl)
 
 Logger::~Logger()
 {
+	d->stop();
 	delete d;
 }
 
 void Logger::addDestination(Destination *destination)
 {
 	assert(destination);
-	d->destList.push_back(destination);
+	{
+		QMutexLocker lock(&d->consumerMutex);
+		d->destList.push_back(destination);
+	}
+	if (!d->isRunning())
+	{
+		d->start(QThread::LowPriority);
+	}
 }
 
 void Logger::setLoggingLevel(Level newLevel)
 {
-	d->level = newLevel;
+	setLoggingLevel(GeneralCategory, newLevel);
 }
 
 Level Logger::loggingLevel() const
 {
-	return d->level;
+	return loggingLevel(GeneralCategory);
+}
+
+void Logger::setLoggingLevel(Category category, Level newLevel)
+{
+	categoryLevels[category].store(newLevel);
+}
+
+Level Logger::loggingLevel(Category category) const
+{
+	return Level(categoryLevels[category].load());
+}
+
+bool Logger::configure(const QString &spec)
+{
+	bool ok = true;
+	for (auto part : spec.split(',', QString::SkipEmptyParts))
+	{
+		part = part.trimmed();
+		int eq = part.indexOf('=');
+		Level newLevel;
+		if (eq == -1)
+		{
+			if (!LevelFromText(part, newLevel))
+			{
+				ok = false;
+				continue;
+			}
+			for (int i = 0; i < CategoryCount; i++)
+				setLoggingLevel(Category(i), newLevel);
+			continue;
+		}
+		const QString name = part.left(eq).trimmed();
+		if (!LevelFromText(part.mid(eq + 1).trimmed(), newLevel))
+		{
+			ok = false;
+			continue;
+		}
+		bool found = false;
+		for (int i = 0; i < CategoryCount; i++)
+		{
+			if (name.compare(CategoryNames[i], Qt::CaseInsensitive) == 0)
+			{
+				setLoggingLevel(Category(i), newLevel);
+				found = true;
+				break;
+			}
+		}
+		ok &= found;
+	}
+	return ok;
+}
+
+void Logger::flush()
+{
+	QMutexLocker lock(&d->consumerMutex);
+	d->drain();
 }
 
 //! creates the complete log message and passes it to the logger
 void Logger::Helper::writeToLog()
 {
 	const char *const levelName = LevelToText(level);
-	const QString completeMessage(QString("%1\t%2").arg(levelName, 5).arg(buffer));
+	QString completeMessage;
+	if (category == GeneralCategory)
+		completeMessage = QString("%1\t%2").arg(levelName, 5).arg(buffer);
+	else
+		completeMessage = QString("%1\t[%2] %3").arg(levelName, 5).arg(CategoryNames[category]).arg(buffer);
 
 	Logger &logger = Logger::instance();
-	QMutexLocker lock(&logger.d->logMutex);
-	logger.write(completeMessage);
+	logger.write(level, completeMessage);
+	// whatever happens next, this one has to be on disk
+	if (level == FatalLevel)
+	{
+		logger.flush();
+	}
 }
 
-Logger::Helper::Helper(Level logLevel) : level(logLevel), qtDebug(&buffer)
+Logger::Helper::Helper(Level logLevel, Category logCategory)
+	: level(logLevel), category(logCategory), qtDebug(&buffer)
 {
 }
 
@@ -119,23 +379,19 @@ Logger::Helper::~Helper()
 	}
 }
 
-//! sends the message to all the destinations
-void Logger::write(const QString &message)
+//! queues the message for the writer thread
+void Logger::write(Level level, const QString &message)
 {
-	for (DestinationList::iterator it = d->destList.begin(), endIt = d->destList.end();
-		 it != endIt; ++it)
-	{
-		if (!(*it))
-		{
-			assert(!"null log destination");
-			continue;
-		}
-		(*it)->write(message);
-	}
+	d->enqueue(level, message);
 }
 
 void Logger::removeDestination(Destination* destination)
 {
+	QMutexLocker lock(&d->consumerMutex);
+	if (!d->destList.contains(destination))
+		return;
+	// give it everything that was meant for it before it goes away
+	d->drain();
 	d->destList.removeAll(destination);
 }
 
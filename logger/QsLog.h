@@ -27,6 +27,15 @@
 
 #include <QDebug>
 #include <QString>
+#include <QAtomicInt>
+
+/*!
+ * Log statements below this level are compiled out entirely.
+ * Release builds set it to InfoLevel (2), see CMakeLists.txt.
+ */
+#ifndef QSLOG_LEVEL_FLOOR
+#define QSLOG_LEVEL_FLOOR 0
+#endif
 
 namespace QsLogging
 {
@@ -42,6 +51,26 @@ enum Level
 	UnknownLevel
 };
 
+//! Every category has its own runtime level
+enum Category
+{
+	GeneralCategory = 0,
+	NetCategory,
+	JarCategory,
+	ModsCategory,
+	ProcessCategory,
+	CategoryCount
+};
+
+//! Current level of each category. Read by the log macros, changed through Logger.
+extern QBasicAtomicInt categoryLevels[CategoryCount];
+
+//! The check done by the log macros before anything gets formatted.
+inline bool isEnabled(Level level, Category category)
+{
+	return level >= QSLOG_LEVEL_FLOOR && int(level) >= categoryLevels[category].load();
+}
+
 class LoggerImpl; // d pointer
 class Logger
 {
@@ -60,13 +89,23 @@ public:
 	void setLoggingLevel(Level newLevel);
 	//! The default level is INFO
 	Level loggingLevel() const;
+	//! Sets the level of a single category
+	void setLoggingLevel(Category category, Level newLevel);
+	Level loggingLevel(Category category) const;
+	/*!
+	 * Applies a level specification like "debug,net=trace,jar=warn".
+	 * A bare level applies to all categories. Returns false if any part was not understood.
+	 */
+	bool configure(const QString &spec);
+	//! Writes out all queued messages and flushes the destinations. Blocks until done.
+	void flush();
 
 	//! The helper forwards the streaming to QDebug and builds the final
 	//! log message.
 	class Helper
 	{
 	public:
-		explicit Helper(Level logLevel);
+		explicit Helper(Level logLevel, Category logCategory = GeneralCategory);
 		~Helper();
 		QDebug &stream()
 		{
@@ -77,6 +116,7 @@ public:
 		void writeToLog();
 
 		Level level;
+		Category category;
 		QString buffer;
 		QDebug qtDebug;
 	};
@@ -87,30 +127,35 @@ private:
 	Logger &operator=(const Logger &);
 	~Logger();
 
-	void write(const QString &message);
+	void write(Level level, const QString &message);
 
 	LoggerImpl *d;
 };
 
 } // end namespace
 
-#define QLOG_TRACE()                                                                           \
-	if (QsLogging::Logger::instance().loggingLevel() <= QsLogging::TraceLevel)                 \
-	QsLogging::Logger::Helper(QsLogging::TraceLevel).stream()
-#define QLOG_DEBUG()                                                                           \
-	if (QsLogging::Logger::instance().loggingLevel() <= QsLogging::DebugLevel)                 \
-	QsLogging::Logger::Helper(QsLogging::DebugLevel).stream()
-#define QLOG_INFO()                                                                            \
-	if (QsLogging::Logger::instance().loggingLevel() <= QsLogging::InfoLevel)                  \
-	QsLogging::Logger::Helper(QsLogging::InfoLevel).stream()
-#define QLOG_WARN()                                                                            \
-	if (QsLogging::Logger::instance().loggingLevel() <= QsLogging::WarnLevel)                  \
-	QsLogging::Logger::Helper(QsLogging::WarnLevel).stream()
-#define QLOG_ERROR()                                                                           \
-	if (QsLogging::Logger::instance().loggingLevel() <= QsLogging::ErrorLevel)                 \
-	QsLogging::Logger::Helper(QsLogging::ErrorLevel).stream()
+// the empty branch keeps a following 'else' attached to the caller's 'if'
+#define QLOG_IF(level, category)                                                               \
+	if (!QsLogging::isEnabled(level, category))                                                \
+	{                                                                                          \
+	}                                                                                          \
+	else                                                                                       \
+		QsLogging::Logger::Helper(level, category).stream()
+
+#define QLOG_TRACE() QLOG_IF(QsLogging::TraceLevel, QsLogging::GeneralCategory)
+#define QLOG_DEBUG() QLOG_IF(QsLogging::DebugLevel, QsLogging::GeneralCategory)
+#define QLOG_INFO() QLOG_IF(QsLogging::InfoLevel, QsLogging::GeneralCategory)
+#define QLOG_WARN() QLOG_IF(QsLogging::WarnLevel, QsLogging::GeneralCategory)
+#define QLOG_ERROR() QLOG_IF(QsLogging::ErrorLevel, QsLogging::GeneralCategory)
 #define QLOG_FATAL() QsLogging::Logger::Helper(QsLogging::FatalLevel).stream()
 
+// category variants, use like QCLOG_DEBUG(Net) << "...";
+#define QCLOG_TRACE(category) QLOG_IF(QsLogging::TraceLevel, QsLogging::category##Category)
+#define QCLOG_DEBUG(category) QLOG_IF(QsLogging::DebugLevel, QsLogging::category##Category)
+#define QCLOG_INFO(category) QLOG_IF(QsLogging::InfoLevel, QsLogging::category##Category)
+#define QCLOG_WARN(category) QLOG_IF(QsLogging::WarnLevel, QsLogging::category##Category)
+#define QCLOG_ERROR(category) QLOG_IF(QsLogging::ErrorLevel, QsLogging::category##Category)
+
 /*
 #define QLOG_TRACE()                                                                           \
 	if (QsLogging::Logger::instance().loggingLevel() <= QsLogging::TraceLevel)                 \
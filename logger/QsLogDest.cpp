@@ -29,6 +29,7 @@
 #include <QFile>
 #include <QTextStream>
 #include <QString>
+#include <QDateTime>
 
 namespace QsLogging
 {
@@ -39,36 +40,88 @@ Destination::~Destination()
 	QsDebugOutput::output("Removed logger destination.");
 }
 
+void Destination::flush()
+{
+}
+
 //! file message sink
 class FileDestination : public Destination
 {
 public:
-	FileDestination(const QString &filePath);
+	FileDestination(const QString &filePath, RotationHandlerPtr rotation);
+	virtual ~FileDestination();
 	virtual void write(const QString &message);
+	virtual void flush();
 
 private:
+	void open();
+	void rotate();
+
 	QFile mFile;
 	QTextStream mOutputStream;
+	RotationHandlerPtr mRotation;
+	QDateTime mStarted;
 };
 
-FileDestination::FileDestination(const QString &filePath)
+FileDestination::FileDestination(const QString &filePath, RotationHandlerPtr rotation)
+	: mRotation(rotation)
 {
 	mFile.setFileName(filePath);
+	open();
+}
+
+void FileDestination::open()
+{
 	mFile.open(QFile::WriteOnly | QFile::Text |
 			   QFile::Truncate); // fixme: should throw on failure
 	mOutputStream.setDevice(&mFile);
+	mStarted = QDateTime::currentDateTime();
+}
+
+FileDestination::~FileDestination()
+{
+	// drains the queue into this file while it can still be written to
+	Logger::instance().removeDestination(this);
 }
 
 void FileDestination::write(const QString &message)
 {
-	mOutputStream << message << endl;
+	mOutputStream << message << '\n';
+}
+
+void FileDestination::flush()
+{
 	mOutputStream.flush();
+	if (mRotation && mRotation->shouldRotate(mFile.size(), mStarted))
+	{
+		rotate();
+	}
+}
+
+void FileDestination::rotate()
+{
+	const QString archived = mRotation->archivePath(mStarted);
+	mOutputStream.setDevice(nullptr);
+	mFile.close();
+	if (!QFile::rename(mFile.fileName(), archived))
+	{
+		// keep writing to the old file, better than losing messages
+		mFile.open(QFile::WriteOnly | QFile::Text | QFile::Append);
+		mOutputStream.setDevice(&mFile);
+		return;
+	}
+	open();
+	mRotation->rotated(archived);
 }
 
 //! debugger sink
 class DebugOutputDestination : public Destination
 {
 public:
+	virtual ~DebugOutputDestination()
+	{
+		Logger::instance().removeDestination(this);
+	}
 	virtual void write(const QString &message);
 };
 
@@ -80,15 +133,20 @@ void DebugOutputDestination::write(const QString &message)
 class QDebugDestination : public Destination
 {
 public:
+	virtual ~QDebugDestination()
+	{
+		Logger::instance().removeDestination(this);
+	}
 	virtual void write(const QString &message)
 	{
 		qDebug() << message;
 	};
 };
 
-DestinationPtr DestinationFactory::MakeFileDestination(const QString &filePath)
+DestinationPtr DestinationFactory::MakeFileDestination(const QString &filePath,
+													   RotationHandlerPtr rotation)
 {
-	return DestinationPtr(new FileDestination(filePath));
+	return DestinationPtr(new FileDestination(filePath, rotation));
 }
 
 DestinationPtr DestinationFactory::MakeDebugOutputDestination()
@@ -26,8 +26,10 @@
 #pragma once
 
 #include <memory>
+#include <QtGlobal>
 
 class QString;
+class QDateTime;
 
 namespace QsLogging
 {
@@ -37,15 +39,33 @@ class Destination
 public:
 	virtual ~Destination();
 	virtual void write(const QString &message) = 0;
+	//! called after a batch of messages has been written
+	virtual void flush();
 };
 typedef std::shared_ptr<Destination> DestinationPtr;
 
+//! Decides when a file destination starts a new file and what happens to the old one.
+//! Called from the log writer thread.
+class RotationHandler
+{
+public:
+	virtual ~RotationHandler() {}
+	//! checked after every batch of messages
+	virtual bool shouldRotate(qint64 size, const QDateTime &started) = 0;
+	//! where the current file should be moved to
+	virtual QString archivePath(const QDateTime &started) = 0;
+	//! the file was moved to path and a fresh one was started
+	virtual void rotated(const QString &path) = 0;
+};
+typedef std::shared_ptr<RotationHandler> RotationHandlerPtr;
+
 //! Creates logging destinations/sinks. The caller will have ownership of
 //! the newly created destinations.
 class DestinationFactory
 {
 public:
-	static DestinationPtr MakeFileDestination(const QString &filePath);
+	static DestinationPtr MakeFileDestination(const QString &filePath,
+											  RotationHandlerPtr rotation = RotationHandlerPtr());
 	static DestinationPtr MakeDebugOutputDestination();
 	static DestinationPtr MakeQDebugDestination();
 };
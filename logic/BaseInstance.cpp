@@ -37,11 +37,11 @@ BaseInstance::BaseInstance(const QString &rootDir, SettingsObject *settings, QOb
 	m_settings = std::shared_ptr<SettingsObject>(settings);
 	m_rootDir = rootDir;
 
-	m_settings->registerSetting("name", "Unnamed Instance");
-	m_settings->registerSetting("iconKey", "default");
+	m_name = SettingHandle<QString>(m_settings->registerSetting("name", "Unnamed Instance"));
+	m_iconKey = SettingHandle<QString>(m_settings->registerSetting("iconKey", "default"));
 	connect(MMC->icons().get(), SIGNAL(iconUpdated(QString)), SLOT(iconUpdated(QString)));
-	m_settings->registerSetting("notes", "");
-	m_settings->registerSetting("lastLaunchTime", 0);
+	m_notes = SettingHandle<QString>(m_settings->registerSetting("notes", ""));
+	m_lastLaunch = SettingHandle<qint64>(m_settings->registerSetting("lastLaunchTime", 0));
 
 	auto globalSettings = MMC->settings();
 
@@ -107,7 +107,8 @@ void BaseInstance::setRunning(bool running)
 
 QString BaseInstance::instanceType() const
 {
-	return m_settings->get("InstanceType").toString();
+	static const SettingKey key("InstanceType");
+	return m_settings->get(key).toString();
 }
 
 QString BaseInstance::instanceRoot() const
@@ -187,12 +188,12 @@ bool BaseInstance::reload()
 
 qint64 BaseInstance::lastLaunch() const
 {
-	return m_settings->get("lastLaunchTime").value<qint64>();
+	return m_lastLaunch.get();
 }
 
 void BaseInstance::setLastLaunch(qint64 val)
 {
-	m_settings->set("lastLaunchTime", val);
+	m_lastLaunch.set(val);
 	emit propertiesChanged(this);
 }
 
@@ -215,34 +216,34 @@ QString BaseInstance::group() const
 
 void BaseInstance::setNotes(QString val)
 {
-	m_settings->set("notes", val);
+	m_notes.set(val);
 }
 
 QString BaseInstance::notes() const
 {
-	return m_settings->get("notes").toString();
+	return m_notes.get();
 }
 
 void BaseInstance::setIconKey(QString val)
 {
-	m_settings->set("iconKey", val);
+	m_iconKey.set(val);
 	emit propertiesChanged(this);
 }
 
 QString BaseInstance::iconKey() const
 {
-	return m_settings->get("iconKey").toString();
+	return m_iconKey.get();
 }
 
 void BaseInstance::setName(QString val)
 {
-	m_settings->set("name", val);
+	m_name.set(val);
 	emit propertiesChanged(this);
 }
 
 QString BaseInstance::name() const
 {
-	return m_settings->get("name").toString();
+	return m_name.get();
 }
 
 QString BaseInstance::windowTitle() const
@@ -252,5 +253,6 @@ QString BaseInstance::windowTitle() const
 
 QStringList BaseInstance::extraArguments() const
 {
-	return Util::Commandline::splitArgs(settings().get("JvmArgs").toString());
+	static const SettingKey key("JvmArgs");
+	return Util::Commandline::splitArgs(settings().get(key).toString());
 }
@@ -214,6 +214,11 @@ protected:
 	QString m_rootDir;
 	QString m_group;
 	std::shared_ptr<SettingsObject> m_settings;
+	// read all the time by the instance views
+	SettingHandle<QString> m_name;
+	SettingHandle<QString> m_iconKey;
+	SettingHandle<QString> m_notes;
+	SettingHandle<qint64> m_lastLaunch;
 	InstanceFlags m_flags;
 	bool m_isRunning = false;
 };
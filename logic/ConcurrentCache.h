@@ -0,0 +1,228 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <list>
+#include <vector>
+
+/**
+ * A size bounded, least recently used cache that can be shared between threads.
+ *
+ * The keys are spread over a number of shards by hash, each with its own mutex, LRU list and
+ * share of the total cost budget. Threads working on different keys rarely wait for each
+ * other. Every lookup moves the entry to the front of its shard's LRU list, so there are no
+ * read-only operations and the shards use plain mutexes instead of read/write locks.
+ *
+ * Entries can be marked stale: they are still returned, but stale() reports them, so a
+ * producer knows to refresh them.
+ */
+template <typename K, typename V> class ConcurrentCache
+{
+public:
+	struct Stats
+	{
+		qint64 hits = 0;
+		qint64 misses = 0;
+		qint64 evictions = 0;
+		int count = 0;
+		int cost = 0;
+	};
+
+	explicit ConcurrentCache(int maxCost = 1000, int shardCount = 16)
+		: m_shards(qMax(1, shardCount))
+	{
+		setMaxCost(maxCost);
+	}
+
+	/// the budget is split evenly between the shards
+	void setMaxCost(int maxCost)
+	{
+		int perShard = qMax(1, (maxCost + int(m_shards.size()) - 1) / int(m_shards.size()));
+		for (auto &shard : m_shards)
+		{
+			QMutexLocker locker(&shard.mutex);
+			shard.maxCost = perShard;
+			shard.trim();
+		}
+	}
+
+	/// insert or replace the entry. it is no longer stale.
+	void insert(const K &key, const V &value, int cost = 1)
+	{
+		Shard &shard = shardFor(key);
+		QMutexLocker locker(&shard.mutex);
+		auto iter = shard.entries.find(key);
+		if (iter != shard.entries.end())
+		{
+			shard.cost -= iter->cost;
+			iter->value = value;
+			iter->cost = cost;
+			iter->stale = false;
+			shard.lru.splice(shard.lru.begin(), shard.lru, iter->position);
+		}
+		else
+		{
+			shard.lru.push_front(key);
+			Entry entry;
+			entry.value = value;
+			entry.cost = cost;
+			entry.position = shard.lru.begin();
+			shard.entries.insert(key, entry);
+		}
+		shard.cost += cost;
+		shard.trim();
+	}
+
+	/// look the entry up and mark it as recently used
+	bool get(const K &key, V &value)
+	{
+		Shard &shard = shardFor(key);
+		QMutexLocker locker(&shard.mutex);
+		auto iter = shard.entries.find(key);
+		if (iter == shard.entries.end())
+		{
+			shard.misses++;
+			return false;
+		}
+		shard.hits++;
+		shard.lru.splice(shard.lru.begin(), shard.lru, iter->position);
+		value = iter->value;
+		return true;
+	}
+
+	V get(const K &key)
+	{
+		V value = V();
+		get(key, value);
+		return value;
+	}
+
+	bool contains(const K &key) const
+	{
+		const Shard &shard = shardFor(key);
+		QMutexLocker locker(&shard.mutex);
+		return shard.entries.contains(key);
+	}
+
+	/// true if there is no entry or it was marked stale
+	bool stale(const K &key) const
+	{
+		const Shard &shard = shardFor(key);
+		QMutexLocker locker(&shard.mutex);
+		auto iter = shard.entries.find(key);
+		if (iter == shard.entries.end())
+			return true;
+		return iter->stale;
+	}
+
+	void setStale(const K &key)
+	{
+		Shard &shard = shardFor(key);
+		QMutexLocker locker(&shard.mutex);
+		auto iter = shard.entries.find(key);
+		if (iter != shard.entries.end())
+			iter->stale = true;
+	}
+
+	bool remove(const K &key)
+	{
+		Shard &shard = shardFor(key);
+		QMutexLocker locker(&shard.mutex);
+		auto iter = shard.entries.find(key);
+		if (iter == shard.entries.end())
+			return false;
+		shard.cost -= iter->cost;
+		shard.lru.erase(iter->position);
+		shard.entries.erase(iter);
+		return true;
+	}
+
+	void clear()
+	{
+		for (auto &shard : m_shards)
+		{
+			QMutexLocker locker(&shard.mutex);
+			shard.entries.clear();
+			shard.lru.clear();
+			shard.cost = 0;
+		}
+	}
+
+	/// the sum over all shards. each shard is locked on its own, so this is not a snapshot.
+	Stats stats() const
+	{
+		Stats out;
+		for (auto &shard : m_shards)
+		{
+			QMutexLocker locker(&shard.mutex);
+			out.hits += shard.hits;
+			out.misses += shard.misses;
+			out.evictions += shard.evictions;
+			out.count += shard.entries.size();
+			out.cost += shard.cost;
+		}
+		return out;
+	}
+
+private:
+	struct Entry
+	{
+		V value = V();
+		int cost = 0;
+		bool stale = false;
+		typename std::list<K>::iterator position;
+	};
+	struct Shard
+	{
+		mutable QMutex mutex;
+		QHash<K, Entry> entries;
+		// most recently used first
+		std::list<K> lru;
+		int cost = 0;
+		int maxCost = 1;
+		qint64 hits = 0;
+		qint64 misses = 0;
+		qint64 evictions = 0;
+
+		// evict from the back, but never the entry that was just used
+		void trim()
+		{
+			while (cost > maxCost && lru.size() > 1)
+			{
+				auto iter = entries.find(lru.back());
+				cost -= iter->cost;
+				entries.erase(iter);
+				lru.pop_back();
+				evictions++;
+			}
+		}
+	};
+
+	Shard &shardFor(const K &key)
+	{
+		return m_shards[qHash(key) % m_shards.size()];
+	}
+	const Shard &shardFor(const K &key) const
+	{
+		return m_shards[qHash(key) % m_shards.size()];
+	}
+
+	std::vector<Shard> m_shards;
+};
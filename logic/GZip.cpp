@@ -0,0 +1,148 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "GZip.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <zlib.h>
+
+// 16 added to the window bits selects the gzip wrapper, 32 makes inflate detect it
+static const int gzipWindowBits = 15 + 16;
+static const int autoWindowBits = 15 + 32;
+static const int chunkSize = 64 * 1024;
+
+bool GZip::zip(const QByteArray &uncompressedBytes, QByteArray &compressedBytes)
+{
+	z_stream zs = {};
+	if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, gzipWindowBits, 8,
+					 Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+
+	compressedBytes.resize(deflateBound(&zs, uncompressedBytes.size()));
+	zs.next_in = (Bytef *)uncompressedBytes.data();
+	zs.avail_in = uncompressedBytes.size();
+	zs.next_out = (Bytef *)compressedBytes.data();
+	zs.avail_out = compressedBytes.size();
+	int ret = deflate(&zs, Z_FINISH);
+	compressedBytes.resize(zs.total_out);
+	deflateEnd(&zs);
+	return ret == Z_STREAM_END;
+}
+
+bool GZip::unzip(const QByteArray &compressedBytes, QByteArray &uncompressedBytes)
+{
+	uncompressedBytes.clear();
+	if (compressedBytes.isEmpty())
+		return true;
+
+	z_stream zs = {};
+	if (inflateInit2(&zs, autoWindowBits) != Z_OK)
+		return false;
+
+	zs.next_in = (Bytef *)compressedBytes.data();
+	zs.avail_in = compressedBytes.size();
+	// logs compress well, start with a generous guess
+	uncompressedBytes.resize(compressedBytes.size() * 4);
+	int ret;
+	do
+	{
+		if ((qint64)zs.total_out == uncompressedBytes.size())
+			uncompressedBytes.resize(uncompressedBytes.size() * 2);
+		zs.next_out = (Bytef *)uncompressedBytes.data() + zs.total_out;
+		zs.avail_out = uncompressedBytes.size() - zs.total_out;
+		ret = inflate(&zs, Z_NO_FLUSH);
+		// concatenated gzip members are valid gzip too
+		if (ret == Z_STREAM_END && zs.avail_in)
+			ret = inflateReset(&zs);
+	} while (ret == Z_OK);
+	uncompressedBytes.resize(zs.total_out);
+	inflateEnd(&zs);
+	return ret == Z_STREAM_END;
+}
+
+bool GZip::zipFile(const QString &source, const QString &target)
+{
+	QFile in(source);
+	if (!in.open(QIODevice::ReadOnly))
+		return false;
+	QSaveFile out(target);
+	if (!out.open(QIODevice::WriteOnly))
+		return false;
+
+	z_stream zs = {};
+	if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, gzipWindowBits, 8,
+					 Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+
+	QByteArray outBuffer(chunkSize, Qt::Uninitialized);
+	bool ok = true;
+	int ret = Z_OK;
+	while (ok && ret != Z_STREAM_END)
+	{
+		QByteArray inBuffer = in.read(chunkSize);
+		if (inBuffer.isEmpty() && in.error() != QFile::NoError)
+		{
+			ok = false;
+			break;
+		}
+		const int flush = in.atEnd() ? Z_FINISH : Z_NO_FLUSH;
+		zs.next_in = (Bytef *)inBuffer.data();
+		zs.avail_in = inBuffer.size();
+		do
+		{
+			zs.next_out = (Bytef *)outBuffer.data();
+			zs.avail_out = outBuffer.size();
+			ret = deflate(&zs, flush);
+			if (ret == Z_STREAM_ERROR)
+			{
+				ok = false;
+				break;
+			}
+			const int have = outBuffer.size() - zs.avail_out;
+			if (out.write(outBuffer.constData(), have) != have)
+			{
+				ok = false;
+				break;
+			}
+		} while (zs.avail_out == 0);
+	}
+	deflateEnd(&zs);
+	if (!ok)
+	{
+		out.cancelWriting();
+		return false;
+	}
+	return out.commit();
+}
+
+bool GZip::isGZipped(const QString &path)
+{
+	return path.endsWith(".gz", Qt::CaseInsensitive);
+}
+
+bool GZip::readFile(const QString &path, QByteArray &data)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	if (!isGZipped(path))
+	{
+		data = file.readAll();
+		return true;
+	}
+	return unzip(file.readAll(), data);
+}
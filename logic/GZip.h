@@ -0,0 +1,39 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * gzip helpers on top of zlib
+ */
+class GZip
+{
+public:
+	static bool zip(const QByteArray &uncompressedBytes, QByteArray &compressedBytes);
+	static bool unzip(const QByteArray &compressedBytes, QByteArray &uncompressedBytes);
+
+	/// compress source into target, a chunk at a time. target is replaced atomically.
+	static bool zipFile(const QString &source, const QString &target);
+
+	/// true if the file name says it's gzipped
+	static bool isGZipped(const QString &path);
+
+	/// read a whole file, decompressing it if it is gzipped
+	static bool readFile(const QString &path, QByteArray &data);
+};
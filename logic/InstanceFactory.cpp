@@ -33,6 +33,7 @@
 #include "logic/OneSixInstance.h"
 #include "logic/BaseVersion.h"
 #include "logic/minecraft/MinecraftVersion.h"
+#include "logic/tasks/CopyDirectoryTask.h"
 
 InstanceFactory InstanceFactory::loader;
 
@@ -128,6 +129,22 @@ InstanceFactory::InstCreateError InstanceFactory::createInstance(InstancePtr &in
 	return InstanceFactory::NoCreateError;
 }
 
+Task *InstanceFactory::copyInstanceFiles(InstancePtr &oldInstance, const QString &instDir,
+										 bool linkMods)
+{
+	// the copy has to see the settings as they are now, not as they were last written
+	INISettingsObject::flushAll();
+	auto task = new CopyDirectoryTask(oldInstance->instanceRoot(), instDir);
+	if (linkMods)
+	{
+		// mod archives are replaced, not modified, so sharing them is safe
+		task->setHardlinkFilter(QRegularExpression(
+			"^((minecraft|\\.minecraft)/(mods|coremods)|instMods)/.*\\.(jar|zip|litemod)$",
+			QRegularExpression::CaseInsensitiveOption));
+	}
+	return task;
+}
+
 InstanceFactory::InstCreateError InstanceFactory::copyInstance(InstancePtr &newInstance,
 															   InstancePtr &oldInstance,
 															   const QString &instDir)
@@ -135,7 +152,7 @@ InstanceFactory::InstCreateError InstanceFactory::copyInstance(InstancePtr &newI
 	QDir rootDir(instDir);
 
 	QLOG_DEBUG() << instDir.toUtf8();
-	if (!copyPath(oldInstance->instanceRoot(), instDir))
+	if (!QFileInfo(PathCombine(instDir, "instance.cfg")).isFile())
 	{
 		rootDir.removeRecursively();
 		return InstanceFactory::CantCreateDir;
@@ -151,6 +168,8 @@ InstanceFactory::InstCreateError InstanceFactory::copyInstance(InstancePtr &newI
 		settings_obj.set("InstanceType", "Legacy");
 
 	oldInstance->copy(instDir);
+	// loadInstance reads the file again
+	settings_obj.saveNow();
 
 	auto error = loadInstance(newInstance, instDir);
 
@@ -24,6 +24,7 @@
 
 struct BaseVersion;
 class BaseInstance;
+class Task;
 
 /*!
  * The \b InstanceFactory\b is a singleton that manages loading and creating instances.
@@ -76,9 +77,19 @@ public:
 	InstCreateError createInstance(InstancePtr &inst, BaseVersionPtr version,
 								   const QString &instDir, const InstType type = NormalInst);
 
+	/*!
+	 * \brief Creates a task that copies the files of an instance into a new directory
+	 *
+	 * Mod files are hardlinked instead of copied when linkMods is set.
+	 * Run this before copyInstance.
+	 */
+	Task *copyInstanceFiles(InstancePtr &oldInstance, const QString &instDir, bool linkMods);
+
 	/*!
 	 * \brief Creates a copy of an existing instance with a new name
 	 *
+	 * The files have to be copied into instDir already, see copyInstanceFiles.
+	 *
 	 * \param newInstance Pointer to store the created instance in.
 	 * \param oldInstance The instance to copy
 	 * \param instDir The new instance's directory.
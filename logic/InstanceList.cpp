@@ -32,6 +32,7 @@
 #include "logic/minecraft/MinecraftVersionList.h"
 #include "logic/BaseInstance.h"
 #include "logic/InstanceFactory.h"
+#include "logic/Metrics.h"
 #include "logger/QsLog.h"
 #include "gui/groupview/GroupView.h"
 
@@ -286,8 +287,10 @@ void InstanceList::loadGroupList(QMap<QString, QString> &groupMap)
 QSet<FTBRecord> InstanceList::discoverFTBInstances()
 {
 	QSet<FTBRecord> records;
-	QDir dir = QDir(MMC->settings()->get("FTBLauncherDataRoot").toString());
-	QDir dataDir = QDir(MMC->settings()->get("FTBRoot").toString());
+	static const SettingKey launcherRootKey("FTBLauncherDataRoot");
+	static const SettingKey rootKey("FTBRoot");
+	QDir dir = QDir(MMC->settings()->get(launcherRootKey).toString());
+	QDir dataDir = QDir(MMC->settings()->get(rootKey).toString());
 	if (!dataDir.exists())
 	{
 		QLOG_INFO() << "The FTB directory specified does not exist. Please check your settings";
@@ -448,6 +451,10 @@ void InstanceList::loadFTBInstances(QMap<QString, QString> &groupMap,
 
 InstanceList::InstListError InstanceList::loadList()
 {
+	static auto &loadTime = Metrics::Registry::instance().histogram(
+		"instance_list_load_ms", "Time it takes to load the instance list, in milliseconds.");
+	Metrics::ScopedTimer timer(loadTime);
+
 	// load the instance groups
 	QMap<QString, QString> groupMap;
 	loadGroupList(groupMap);
@@ -470,7 +477,8 @@ InstanceList::InstListError InstanceList::loadList()
 		}
 	}
 
-	if (MMC->settings()->get("TrackFTBInstances").toBool())
+	static const SettingKey trackFTBKey("TrackFTBInstances");
+	if (MMC->settings()->get(trackFTBKey).toBool())
 	{
 		loadFTBInstances(groupMap, tempList);
 	}
@@ -618,6 +626,7 @@ void InstanceList::propertiesChanged(BaseInstance *inst)
 
 InstanceProxyModel::InstanceProxyModel(QObject *parent) : GroupedProxyModel(parent)
 {
+	m_sortMode = MMC->settings()->handle<QString>("InstSortMode");
 }
 
 bool InstanceProxyModel::subSortLessThan(const QModelIndex &left,
@@ -625,8 +634,7 @@ bool InstanceProxyModel::subSortLessThan(const QModelIndex &left,
 {
 	BaseInstance *pdataLeft = static_cast<BaseInstance *>(left.internalPointer());
 	BaseInstance *pdataRight = static_cast<BaseInstance *>(right.internalPointer());
-	QString sortMode = MMC->settings()->get("InstSortMode").toString();
-	if (sortMode == "LastLaunch")
+	if (m_sortMode.get() == "LastLaunch")
 	{
 		return pdataLeft->lastLaunch() > pdataRight->lastLaunch();
 	}
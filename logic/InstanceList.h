@@ -158,4 +158,8 @@ public:
 
 protected:
 	virtual bool subSortLessThan(const QModelIndex &left, const QModelIndex &right) const;
+
+private:
+	// read for every comparison while sorting
+	SettingHandle<QString> m_sortMode;
 };
@@ -3,6 +3,7 @@
 #include <quazipfile.h>
 #include <JlCompress.h>
 #include <logger/QsLog.h>
+#include "logic/Metrics.h"
 
 namespace JarUtils {
 
@@ -19,22 +20,22 @@ bool mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained,
 		QString filename = modZip.getCurrentFileName();
 		if (!filter(filename))
 		{
-			QLOG_INFO() << "Skipping file " << filename << " from "
+			QCLOG_INFO(Jar) << "Skipping file " << filename << " from "
 						<< from.fileName() << " - filtered";
 			continue;
 		}
 		if (contained.contains(filename))
 		{
-			QLOG_INFO() << "Skipping already contained file " << filename << " from "
+			QCLOG_INFO(Jar) << "Skipping already contained file " << filename << " from "
 						<< from.fileName();
 			continue;
 		}
 		contained.insert(filename);
-		QLOG_INFO() << "Adding file " << filename << " from " << from.fileName();
+		QCLOG_INFO(Jar) << "Adding file " << filename << " from " << from.fileName();
 
 		if (!fileInsideMod.open(QIODevice::ReadOnly))
 		{
-			QLOG_ERROR() << "Failed to open " << filename << " from " << from.fileName();
+			QCLOG_ERROR(Jar) << "Failed to open " << filename << " from " << from.fileName();
 			return false;
 		}
 
@@ -42,7 +43,7 @@ bool mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained,
 
 		if (!zipOutFile.open(QIODevice::WriteOnly, info_out))
 		{
-			QLOG_ERROR() << "Failed to open " << filename << " in the jar";
+			QCLOG_ERROR(Jar) << "Failed to open " << filename << " in the jar";
 			fileInsideMod.close();
 			return false;
 		}
@@ -50,7 +51,7 @@ bool mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained,
 		{
 			zipOutFile.close();
 			fileInsideMod.close();
-			QLOG_ERROR() << "Failed to copy data of " << filename << " into the jar";
+			QCLOG_ERROR(Jar) << "Failed to copy data of " << filename << " into the jar";
 			return false;
 		}
 		zipOutFile.close();
@@ -61,11 +62,14 @@ bool mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained,
 
 bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<Mod>& mods)
 {
+	static auto &buildTime = Metrics::Registry::instance().histogram(
+		"jar_build_ms", "Time it takes to build a modded minecraft.jar, in milliseconds.");
+	Metrics::ScopedTimer timer(buildTime);
 	QuaZip zipOut(targetJarPath);
 	if (!zipOut.open(QuaZip::mdCreate))
 	{
 		QFile::remove(targetJarPath);
-		QLOG_ERROR() << "Failed to open the minecraft.jar for modding";
+		QCLOG_ERROR(Jar) << "Failed to open the minecraft.jar for modding";
 		return false;
 	}
 	// Files already added to the jar.
@@ -87,7 +91,7 @@ bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<M
 			{
 				zipOut.close();
 				QFile::remove(targetJarPath);
-				QLOG_ERROR() << "Failed to add" << mod.filename().fileName() << "to the jar.";
+				QCLOG_ERROR(Jar) << "Failed to add" << mod.filename().fileName() << "to the jar.";
 				return false;
 			}
 		}
@@ -99,11 +103,11 @@ bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<M
 			{
 				zipOut.close();
 				QFile::remove(targetJarPath);
-				QLOG_ERROR() << "Failed to add" << mod.filename().fileName() << "to the jar.";
+				QCLOG_ERROR(Jar) << "Failed to add" << mod.filename().fileName() << "to the jar.";
 				return false;
 			}
 			addedFiles.insert(filename.fileName());
-			QLOG_INFO() << "Adding file " << filename.fileName() << " from "
+			QCLOG_INFO(Jar) << "Adding file " << filename.fileName() << " from "
 						<< filename.absoluteFilePath();
 		}
 		else if (mod.type() == Mod::MOD_FOLDER)
@@ -117,10 +121,10 @@ bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<M
 			{
 				zipOut.close();
 				QFile::remove(targetJarPath);
-				QLOG_ERROR() << "Failed to add" << mod.filename().fileName() << "to the jar.";
+				QCLOG_ERROR(Jar) << "Failed to add" << mod.filename().fileName() << "to the jar.";
 				return false;
 			}
-			QLOG_INFO() << "Adding folder " << filename.fileName() << " from "
+			QCLOG_INFO(Jar) << "Adding folder " << filename.fileName() << " from "
 						<< filename.absoluteFilePath();
 		}
 	}
@@ -129,7 +133,7 @@ bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<M
 	{
 		zipOut.close();
 		QFile::remove(targetJarPath);
-		QLOG_ERROR() << "Failed to insert minecraft.jar contents.";
+		QCLOG_ERROR(Jar) << "Failed to insert minecraft.jar contents.";
 		return false;
 	}
 
@@ -138,7 +142,7 @@ bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<M
 	if (zipOut.getZipError() != 0)
 	{
 		QFile::remove(targetJarPath);
-		QLOG_ERROR() << "Failed to finalize minecraft.jar!";
+		QCLOG_ERROR(Jar) << "Failed to finalize minecraft.jar!";
 		return false;
 	}
 	return true;
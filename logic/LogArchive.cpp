@@ -0,0 +1,169 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "LogArchive.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QRunnable>
+#include <functional>
+
+#include "GZip.h"
+#include "logger/QsLog.h"
+
+namespace
+{
+const qint64 SECONDS_PER_DAY = 24 * 3600;
+
+class ArchiveRunnable : public QRunnable
+{
+public:
+	ArchiveRunnable(std::function<void()> work) : m_work(work)
+	{
+	}
+	void run() override
+	{
+		m_work();
+	}
+
+private:
+	std::function<void()> m_work;
+};
+}
+
+LogArchive::LogArchive(const QString &dir, const QString &prefix)
+	: m_dir(dir), m_prefix(prefix)
+{
+	m_pool.setMaxThreadCount(1);
+	QDir().mkpath(m_dir);
+	// uncompressed leftovers of a session that quit before compressing them
+	QDir logDir(m_dir);
+	for (auto entry : logDir.entryList({m_prefix + "-*.log"}, QDir::Files))
+	{
+		const QString path = logDir.absoluteFilePath(entry);
+		m_pool.start(new ArchiveRunnable([this, path]() { process(path); }));
+	}
+}
+
+LogArchive::~LogArchive()
+{
+	m_pool.waitForDone();
+}
+
+void LogArchive::setLimits(qint64 segmentSize, qint64 totalSize, int maxAgeDays)
+{
+	{
+		QMutexLocker lock(&m_limitsMutex);
+		m_segmentSize = segmentSize;
+		m_totalSize = totalSize;
+		m_maxAgeDays = maxAgeDays;
+	}
+	m_pool.start(new ArchiveRunnable([this]() { prune(); }));
+}
+
+void LogArchive::archive(const QString &path)
+{
+	QFileInfo info(path);
+	if (!info.isFile())
+		return;
+	const QString target = archivePath(info.lastModified());
+	if (QFile::rename(path, target))
+		rotated(target);
+}
+
+QStringList LogArchive::segments() const
+{
+	QDir logDir(m_dir);
+	QStringList result;
+	auto entries = logDir.entryInfoList({m_prefix + "-*.log.gz"}, QDir::Files, QDir::Name);
+	for (auto iter = entries.rbegin(); iter != entries.rend(); iter++)
+	{
+		result.append(iter->absoluteFilePath());
+	}
+	return result;
+}
+
+bool LogArchive::shouldRotate(qint64 size, const QDateTime &started)
+{
+	QMutexLocker lock(&m_limitsMutex);
+	if (m_segmentSize && size >= m_segmentSize)
+		return true;
+	// long sessions still get a segment per 24 hours, so the age limit can do its job.
+	// daysTo would count midnights instead
+	return started.secsTo(QDateTime::currentDateTime()) >= SECONDS_PER_DAY;
+}
+
+QString LogArchive::archivePath(const QDateTime &started)
+{
+	QDir logDir(m_dir);
+	const QString stamp = started.toString("yyyyMMdd-hhmmss");
+	QString name = QString("%1-%2.log").arg(m_prefix, stamp);
+	// the timestamps sort the segments, the counter only breaks ties
+	for (int i = 1; logDir.exists(name) || logDir.exists(name + ".gz"); i++)
+	{
+		name = QString("%1-%2_%3.log").arg(m_prefix, stamp).arg(i, 2, 10, QChar('0'));
+	}
+	return logDir.absoluteFilePath(name);
+}
+
+void LogArchive::rotated(const QString &path)
+{
+	m_pool.start(new ArchiveRunnable([this, path]() { process(path); }));
+}
+
+void LogArchive::process(const QString &path)
+{
+	if (GZip::zipFile(path, path + ".gz"))
+	{
+		QFile::remove(path);
+	}
+	else
+	{
+		QLOG_WARN() << "Could not compress log segment" << path;
+	}
+	prune();
+}
+
+void LogArchive::prune()
+{
+	qint64 totalSize;
+	int maxAgeDays;
+	{
+		QMutexLocker lock(&m_limitsMutex);
+		totalSize = m_totalSize;
+		maxAgeDays = m_maxAgeDays;
+	}
+	const QDateTime now = QDateTime::currentDateTime();
+	qint64 used = 0;
+	for (auto segment : segments())
+	{
+		QFileInfo info(segment);
+		used += info.size();
+		// the name says when the segment was started, the mtime is when it was compressed
+		const QDateTime started = QDateTime::fromString(
+			info.fileName().mid(m_prefix.size() + 1, 15), "yyyyMMdd-hhmmss");
+		const bool tooOld = maxAgeDays && started.isValid() &&
+							 started.secsTo(now) > maxAgeDays * SECONDS_PER_DAY;
+		const bool overCap = totalSize && used > totalSize;
+		if (tooOld || overCap)
+		{
+			QFile::remove(segment);
+			used -= info.size();
+		}
+	}
+}
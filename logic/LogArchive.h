@@ -0,0 +1,76 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QMutex>
+#include <QThreadPool>
+#include <memory>
+
+#include "logger/QsLogDest.h"
+
+/**
+ * Keeps the rotated launcher logs.
+ *
+ * Rotated files are compressed in the background and become <prefix>-<timestamp>.log.gz.
+ * Segments older than the age limit are removed, as are the oldest segments once all of
+ * them together take more space than the total limit.
+ */
+class LogArchive : public QsLogging::RotationHandler
+{
+public:
+	// supply the folder the logs live in and the file name prefix of the segments
+	LogArchive(const QString &dir, const QString &prefix);
+	virtual ~LogArchive();
+
+	/// sizes are in bytes, 0 means unlimited
+	void setLimits(qint64 segmentSize, qint64 totalSize, int maxAgeDays);
+
+	/// move an existing log into the archive, like a rotation would
+	void archive(const QString &path);
+
+	/// the archived segments, newest first
+	QStringList segments() const;
+
+	QString dir() const
+	{
+		return m_dir;
+	}
+
+	bool shouldRotate(qint64 size, const QDateTime &started) override;
+	QString archivePath(const QDateTime &started) override;
+	void rotated(const QString &path) override;
+
+private:
+	/// compresses the segment and enforces the limits. runs on m_pool
+	void process(const QString &path);
+	void prune();
+
+	QString m_dir;
+	QString m_prefix;
+
+	mutable QMutex m_limitsMutex;
+	qint64 m_segmentSize = 8 * 1024 * 1024;
+	qint64 m_totalSize = 64 * 1024 * 1024;
+	int m_maxAgeDays = 30;
+
+	// one thread, so segments are compressed and pruned in order
+	QThreadPool m_pool;
+};
+
+typedef std::shared_ptr<LogArchive> LogArchivePtr;
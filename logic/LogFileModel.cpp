@@ -0,0 +1,374 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "LogFileModel.h"
+
+#include <QFileInfo>
+#include <QtConcurrentRun>
+#include <cstring>
+
+#include "GZip.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+// unmapped files are read in chunks of this size, and the indexer reads blocks of it
+static const qint64 LOG_CHUNK_SIZE = 64 * 1024;
+// how many bytes of chunks are kept around
+static const int LOG_CHUNK_CACHE_SIZE = 4 * 1024 * 1024;
+
+LogFileModel::LogFileModel(QObject *parent) : QAbstractListModel(parent)
+{
+	m_chunks.setMaxCost(LOG_CHUNK_CACHE_SIZE);
+	connect(&m_indexWatcher, SIGNAL(finished()), SLOT(indexFinished()));
+}
+
+LogFileModel::~LogFileModel()
+{
+	// nothing is left to take the result
+	m_indexWatcher.waitForFinished();
+	unmap();
+}
+
+bool LogFileModel::open(const QString &path)
+{
+	close();
+	m_path = path;
+	m_gzipped = GZip::isGZipped(path);
+	if (m_gzipped)
+	{
+		m_indexing = 0;
+		const int generation = m_generation;
+		m_indexWatcher.setFuture(QtConcurrent::run([path, generation]()
+		{
+			IndexResult result = unpackAndIndex(path);
+			result.generation = generation;
+			return result;
+		}));
+		return true;
+	}
+	m_file.setFileName(path);
+	// unbuffered, so reads of a growing file never see stale data
+	if (!m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+	{
+		emit failed(m_file.errorString());
+		return false;
+	}
+	if (!map(m_file.size()))
+	{
+		emit failed(m_file.errorString());
+		return false;
+	}
+	startIndex(0);
+	return true;
+}
+
+void LogFileModel::close()
+{
+	m_indexWatcher.waitForFinished();
+	beginResetModel();
+	// anything the worker still reports belongs to the old file
+	m_generation++;
+	unmap();
+	m_file.close();
+	m_unpacked.clear();
+	m_chunks.clear();
+	m_size = 0;
+	m_path.clear();
+	m_lineStarts.clear();
+	m_indexed = 0;
+	m_refreshPending = false;
+	m_loaded = false;
+	endResetModel();
+}
+
+void LogFileModel::setFollowing(bool following)
+{
+	m_following = following;
+	if (!m_gzipped && m_file.isOpen())
+	{
+		// maps or unmaps the file. without a mapping, chunks are read
+		map(m_size);
+	}
+}
+
+bool LogFileModel::map(qint64 size)
+{
+	unmap();
+	m_size = size;
+	// an empty file can't be mapped, but there is nothing to show either
+	if (!size || m_following)
+		return true;
+	m_map = m_file.map(0, size);
+	return m_map != nullptr;
+}
+
+void LogFileModel::unmap()
+{
+	if (m_map)
+		m_file.unmap(m_map);
+	m_map = nullptr;
+}
+
+bool LogFileModel::mappingIntact() const
+{
+#ifdef Q_OS_UNIX
+	struct stat buf;
+	return ::fstat(m_file.handle(), &buf) == 0 && buf.st_size >= m_size;
+#else
+	// mapped files can't be truncated here
+	return true;
+#endif
+}
+
+QByteArray LogFileModel::bytes(qint64 from, qint64 to) const
+{
+	if (m_gzipped)
+		return m_unpacked.mid(from, to - from);
+	// a file that shrank behind our back is read like a followed one
+	if (m_map && mappingIntact())
+		return QByteArray((const char *)m_map + from, to - from);
+
+	QByteArray result;
+	for (qint64 chunk = from / LOG_CHUNK_SIZE; chunk * LOG_CHUNK_SIZE < to; chunk++)
+	{
+		const qint64 chunkStart = chunk * LOG_CHUNK_SIZE;
+		const qint64 needed = qMin(to - chunkStart, LOG_CHUNK_SIZE);
+		QByteArray *data = m_chunks.object(chunk);
+		// the last chunk grows with the file
+		if (!data || data->size() < needed)
+		{
+			data = new QByteArray();
+			if (m_file.seek(chunkStart))
+				*data = m_file.read(LOG_CHUNK_SIZE);
+			m_chunks.insert(chunk, data, data->size());
+		}
+		const qint64 begin = qMax(from, chunkStart) - chunkStart;
+		result += data->mid(begin, needed - begin);
+		if (data->size() < needed)
+			break;
+	}
+	return result;
+}
+
+void LogFileModel::startIndex(qint64 from)
+{
+	m_indexing = from;
+	const QString path = m_path;
+	const qint64 to = m_size;
+	const int generation = m_generation;
+	m_indexWatcher.setFuture(QtConcurrent::run([path, from, to, generation]()
+	{
+		IndexResult result = indexFile(path, from, to);
+		result.generation = generation;
+		return result;
+	}));
+}
+
+void LogFileModel::findLines(const char *data, qint64 length, qint64 offset,
+							 QVector<qint64> &lineStarts)
+{
+	qint64 pos = 0;
+	while (pos < length)
+	{
+		const char *newline = (const char *)memchr(data + pos, '\n', length - pos);
+		if (!newline)
+			break;
+		pos = newline - data + 1;
+		lineStarts.append(offset + pos);
+	}
+}
+
+LogFileModel::IndexResult LogFileModel::indexFile(QString path, qint64 from, qint64 to)
+{
+	// read, not mapped: the file may shrink while we are at it
+	IndexResult result;
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		result.ok = false;
+		return result;
+	}
+	// the indexer only finds lines after a newline. the first line, or a line that was
+	// started after the last look, have to be added here
+	bool lineStartsAtFrom = true;
+	if (from > 0)
+	{
+		char previous = 0;
+		lineStartsAtFrom = file.seek(from - 1) && file.getChar(&previous) && previous == '\n';
+	}
+	qint64 pos = from;
+	if (file.seek(from))
+	{
+		QByteArray buffer(LOG_CHUNK_SIZE, Qt::Uninitialized);
+		while (pos < to)
+		{
+			const qint64 got = file.read(buffer.data(), qMin(LOG_CHUNK_SIZE, to - pos));
+			if (got <= 0)
+				break;
+			findLines(buffer.constData(), got, pos, result.lineStarts);
+			pos += got;
+		}
+	}
+	if (lineStartsAtFrom && from < pos)
+	{
+		result.lineStarts.prepend(from);
+	}
+	result.end = pos;
+	return result;
+}
+
+LogFileModel::IndexResult LogFileModel::unpackAndIndex(QString path)
+{
+	IndexResult result;
+	if (!GZip::readFile(path, result.unpacked))
+	{
+		result.ok = false;
+		return result;
+	}
+	if (!result.unpacked.isEmpty())
+	{
+		result.lineStarts.append(0);
+	}
+	findLines(result.unpacked.constData(), result.unpacked.size(), 0, result.lineStarts);
+	result.end = result.unpacked.size();
+	return result;
+}
+
+void LogFileModel::indexFinished()
+{
+	IndexResult result = m_indexWatcher.result();
+	if (result.generation != m_generation)
+		return;
+	if (!result.ok)
+	{
+		if (m_gzipped)
+			emit failed(tr("Unable to unpack %1.").arg(QFileInfo(m_path).fileName()));
+		else
+			emit failed(tr("Unable to read %1.").arg(QFileInfo(m_path).fileName()));
+		return;
+	}
+	if (m_gzipped)
+	{
+		m_unpacked = result.unpacked;
+		m_size = m_unpacked.size();
+	}
+	else if (result.end < m_size)
+	{
+		// truncated or replaced while it was read, start over
+		open(m_path);
+		return;
+	}
+
+	// a trailing newline doesn't start a line until something is written after it
+	if (!result.lineStarts.isEmpty() && result.lineStarts.last() == m_size)
+	{
+		result.lineStarts.removeLast();
+	}
+
+	const int oldRows = m_lineStarts.size();
+	// the last line may have grown since we looked at it
+	if (oldRows && m_size > m_indexed)
+	{
+		emit dataChanged(index(oldRows - 1), index(oldRows - 1));
+	}
+	if (!result.lineStarts.isEmpty())
+	{
+		beginInsertRows(QModelIndex(), oldRows, oldRows + result.lineStarts.size() - 1);
+		m_lineStarts += result.lineStarts;
+		endInsertRows();
+	}
+	m_indexed = m_size;
+
+	if (!m_loaded)
+	{
+		m_loaded = true;
+		emit loaded();
+	}
+	if (m_refreshPending)
+	{
+		m_refreshPending = false;
+		refresh();
+	}
+}
+
+void LogFileModel::refresh()
+{
+	if (m_path.isEmpty())
+		return;
+	if (m_indexWatcher.isRunning())
+	{
+		m_refreshPending = true;
+		return;
+	}
+	QFileInfo info(m_path);
+	if (!info.exists())
+	{
+		close();
+		return;
+	}
+	// rotated logs don't grow
+	if (m_gzipped)
+		return;
+	const qint64 newSize = info.size();
+	if (newSize == m_size)
+		return;
+	if (newSize < m_size)
+	{
+		// truncated or replaced, start over
+		open(m_path);
+		return;
+	}
+	if (!map(newSize))
+	{
+		emit failed(m_file.errorString());
+		return;
+	}
+	// look at the last line again, it may not have been complete
+	startIndex(m_indexed);
+}
+
+QString LogFileModel::text() const
+{
+	if (m_path.isEmpty())
+		return QString();
+	return QString::fromUtf8(bytes(0, m_size));
+}
+
+int LogFileModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid())
+		return 0;
+	return m_lineStarts.size();
+}
+
+QVariant LogFileModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= m_lineStarts.size())
+		return QVariant();
+	if (role != Qt::DisplayRole && role != Qt::ToolTipRole)
+		return QVariant();
+
+	const int row = index.row();
+	const qint64 start = m_lineStarts[row];
+	const qint64 end = row + 1 < m_lineStarts.size() ? m_lineStarts[row + 1] : m_indexed;
+	const QByteArray line = bytes(start, end);
+	int length = line.size();
+	while (length && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+		length--;
+	return QString::fromUtf8(line.constData(), length);
+}
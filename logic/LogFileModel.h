@@ -0,0 +1,118 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QVector>
+
+/**
+ * A read-only line model of a log file, for files too big to be shown as one string.
+ *
+ * Plain files are memory mapped, gzipped ones are unpacked in memory. A followed file can be
+ * truncated or rewritten at any time, and touching a mapping past the new end of the file is
+ * fatal, so followed files are read in cached chunks instead. Only the offsets of the line
+ * starts are kept - they are found on a worker thread reading the file on its own, and the
+ * text of a line is only decoded when a view asks for it. refresh() picks up lines appended
+ * to the file.
+ */
+class LogFileModel : public QAbstractListModel
+{
+	Q_OBJECT
+public:
+	explicit LogFileModel(QObject *parent = 0);
+	virtual ~LogFileModel();
+
+	/// start showing the file. the lines appear once the index is built
+	bool open(const QString &path);
+	/// stop showing the file and release the mapping
+	void close();
+
+	/// followed files are read instead of mapped, as they may shrink at any time
+	void setFollowing(bool following);
+
+	QString path() const
+	{
+		return m_path;
+	}
+
+	/// the whole log as text
+	QString text() const;
+
+	virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+public
+slots:
+	/// look at the file again. appended data adds lines, anything else reloads it
+	void refresh();
+
+signals:
+	/// the first index of the current file is done
+	void loaded();
+	void failed(QString reason);
+
+private
+slots:
+	void indexFinished();
+
+private:
+	struct IndexResult
+	{
+		QByteArray unpacked;
+		bool ok = true;
+		int generation = 0;
+		/// where the indexer stopped. before the requested end if the file shrank
+		qint64 end = 0;
+		QVector<qint64> lineStarts;
+	};
+	/// append the offsets following the newlines in data, which starts at offset
+	static void findLines(const char *data, qint64 length, qint64 offset,
+						  QVector<qint64> &lineStarts);
+	static IndexResult indexFile(QString path, qint64 from, qint64 to);
+	static IndexResult unpackAndIndex(QString path);
+
+	bool map(qint64 size);
+	void unmap();
+	/// false if the file shrank below the mapping, which must not be touched then
+	bool mappingIntact() const;
+	/// the bytes in [from, to). shorter if the file shrank
+	QByteArray bytes(qint64 from, qint64 to) const;
+	void startIndex(qint64 from);
+
+	QString m_path;
+	mutable QFile m_file;
+	bool m_gzipped = false;
+	bool m_following = false;
+	uchar *m_map = nullptr;
+	QByteArray m_unpacked;
+	/// chunks of an unmapped file, by chunk number
+	mutable QCache<qint64, QByteArray> m_chunks;
+	qint64 m_size = 0;
+
+	/// offsets of the lines that are known. the last one may still be growing
+	QVector<qint64> m_lineStarts;
+	/// bytes covered by m_lineStarts
+	qint64 m_indexed = 0;
+	qint64 m_indexing = 0;
+	bool m_refreshPending = false;
+	bool m_loaded = false;
+	int m_generation = 0;
+	QFutureWatcher<IndexResult> m_indexWatcher;
+};
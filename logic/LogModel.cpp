@@ -0,0 +1,352 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "LogModel.h"
+
+#include <QColor>
+#include <QDateTime>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <functional>
+
+// the search is split into chunks of this many lines, scanned in parallel
+static const int scanChunkSize = 65536;
+
+LogModel::LogModel(QObject *parent)
+	: QAbstractListModel(parent), m_searchGeneration(std::make_shared<QAtomicInt>(0))
+{
+	connect(&m_scanWatcher, SIGNAL(finished()), SLOT(scanFinished()));
+	m_sources.append(QString());
+	m_sourceIds.insert(QString(), 0);
+}
+
+quint16 LogModel::sourceOf(const QString &text)
+{
+	// vanilla and forge log lines look like '[12:34:56] [Client thread/INFO]: message'
+	if (!text.startsWith('['))
+		return 0;
+	int open = text.indexOf("] [");
+	if (open == -1)
+		return 0;
+	open += 3;
+	int close = text.indexOf(']', open);
+	if (close == -1)
+		return 0;
+	int slash = text.lastIndexOf('/', close);
+	const QString source = text.mid(open, (slash > open ? slash : close) - open);
+	auto iter = m_sourceIds.find(source);
+	if (iter != m_sourceIds.end())
+		return *iter;
+	if (m_sources.size() > 0xffff)
+		return 0;
+	const quint16 id = m_sources.size();
+	m_sources.append(source);
+	m_sourceIds.insert(source, id);
+	return id;
+}
+
+void LogModel::append(const QString &text, MessageLevel::Enum level)
+{
+	QString data = text;
+	if (data.endsWith('\n'))
+		data.chop(1);
+	const QStringList lines = data.split('\n');
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+	const int first = m_lines.size();
+	for (auto &lineText : lines)
+	{
+		Line line;
+		line.text = lineText;
+		line.time = now;
+		line.level = level;
+		line.source = level == MessageLevel::MultiMC ? 0 : sourceOf(lineText);
+		m_lines.append(line);
+	}
+	const bool visible = m_levelMask & (1u << level);
+	if (visible)
+	{
+		beginInsertRows(QModelIndex(), m_visible.size(), m_visible.size() + lines.size() - 1);
+	}
+	for (int i = first; i < m_lines.size(); i++)
+	{
+		m_byLevel[level].append(i);
+		if (visible)
+			m_visible.append(i);
+		// a running search picks these up when it is done
+		if (!m_matchedTerm.isEmpty() && isMatch(i))
+			m_matches.append(i);
+	}
+	if (visible)
+		endInsertRows();
+}
+
+void LogModel::clear()
+{
+	beginResetModel();
+	m_lines.clear();
+	for (auto &lines : m_byLevel)
+		lines.clear();
+	m_visible.clear();
+	m_matches.clear();
+	// a running search was looking at the old lines. with no lines, there is nothing to find
+	m_searchGeneration->fetchAndAddOrdered(1);
+	const bool pending = searchPending();
+	m_matchedTerm = m_searchTerm;
+	endResetModel();
+	if (pending)
+		emit searchFinished();
+}
+
+QString LogModel::toPlainText() const
+{
+	QString result;
+	int size = 0;
+	for (auto &line : m_lines)
+		size += line.text.size() + 1;
+	result.reserve(size);
+	for (auto &line : m_lines)
+	{
+		result.append(line.text);
+		result.append('\n');
+	}
+	return result;
+}
+
+void LogModel::setFont(const QFont &font)
+{
+	m_font = font;
+	if (!m_visible.isEmpty())
+		emit dataChanged(index(0), index(m_visible.size() - 1));
+}
+
+void LogModel::setLevelVisible(MessageLevel::Enum level, bool visible)
+{
+	const quint32 bit = 1u << level;
+	const quint32 newMask = visible ? (m_levelMask | bit) : (m_levelMask & ~bit);
+	if (newMask == m_levelMask)
+		return;
+	m_levelMask = newMask;
+	rebuildVisible();
+}
+
+bool LogModel::levelVisible(MessageLevel::Enum level) const
+{
+	return m_levelMask & (1u << level);
+}
+
+void LogModel::rebuildVisible()
+{
+	beginResetModel();
+	// merge the sorted per-level lists of the visible levels
+	m_visible.clear();
+	for (int level = 0; level < levelCount; level++)
+	{
+		if (!(m_levelMask & (1u << level)) || m_byLevel[level].isEmpty())
+			continue;
+		QVector<int> merged;
+		merged.reserve(m_visible.size() + m_byLevel[level].size());
+		std::merge(m_visible.begin(), m_visible.end(), m_byLevel[level].begin(),
+				   m_byLevel[level].end(), std::back_inserter(merged));
+		m_visible.swap(merged);
+	}
+	endResetModel();
+}
+
+bool LogModel::isMatch(int line) const
+{
+	return m_lines[line].text.contains(m_matchedTerm, Qt::CaseInsensitive);
+}
+
+QVector<int> LogModel::scan(const QVector<Line> &lines, const QVector<int> &candidates,
+							const QString &term, std::shared_ptr<QAtomicInt> latest,
+							int generation)
+{
+	// chunks of candidate positions, [begin, end)
+	QVector<QPair<int, int>> chunks;
+	for (int begin = 0; begin < candidates.size(); begin += scanChunkSize)
+		chunks.append(qMakePair(begin, qMin(begin + scanChunkSize, candidates.size())));
+
+	std::function<QVector<int>(const QPair<int, int> &)> scanChunk =
+		[&](const QPair<int, int> &chunk)
+	{
+		QVector<int> found;
+		// the user typed on, nobody wants this result anymore
+		if (latest->load() != generation)
+			return found;
+		for (int i = chunk.first; i < chunk.second; i++)
+		{
+			const int line = candidates[i];
+			if (lines[line].text.contains(term, Qt::CaseInsensitive))
+				found.append(line);
+		}
+		return found;
+	};
+	// blockingMapped keeps the order, so the result stays sorted
+	QList<QVector<int>> found = QtConcurrent::blockingMapped<QList<QVector<int>>>(chunks, scanChunk);
+	QVector<int> result;
+	for (auto &part : found)
+		result += part;
+	return result;
+}
+
+void LogModel::setSearchTerm(const QString &term)
+{
+	if (term == m_searchTerm)
+		return;
+	m_searchTerm = term;
+	const int generation = m_searchGeneration->fetchAndAddOrdered(1) + 1;
+	if (term.isEmpty())
+	{
+		m_matches.clear();
+		m_matchedTerm = term;
+		if (!m_visible.isEmpty())
+			emit dataChanged(index(0), index(m_visible.size() - 1));
+		emit searchFinished();
+		return;
+	}
+
+	QVector<int> candidates;
+	if (!m_matchedTerm.isEmpty() && term.contains(m_matchedTerm, Qt::CaseInsensitive))
+	{
+		// a longer term can only match lines the shorter one matched
+		candidates = m_matches;
+	}
+	else
+	{
+		candidates.resize(m_lines.size());
+		for (int i = 0; i < candidates.size(); i++)
+			candidates[i] = i;
+	}
+	// the worker gets its own (shared until we append) copy of the lines
+	const QVector<Line> lines = m_lines;
+	auto latest = m_searchGeneration;
+	m_scanWatcher.setFuture(QtConcurrent::run([lines, candidates, term, latest, generation]()
+	{
+		ScanResult result;
+		result.term = term;
+		result.generation = generation;
+		result.scanned = lines.size();
+		result.matches = scan(lines, candidates, term, latest, generation);
+		return result;
+	}));
+}
+
+void LogModel::scanFinished()
+{
+	ScanResult result = m_scanWatcher.result();
+	if (result.generation != m_searchGeneration->load())
+		return;
+	// lines that came in while the worker was busy
+	for (int i = result.scanned; i < m_lines.size(); i++)
+	{
+		if (m_lines[i].text.contains(result.term, Qt::CaseInsensitive))
+			result.matches.append(i);
+	}
+	m_matches.swap(result.matches);
+	m_matchedTerm = result.term;
+	if (!m_visible.isEmpty())
+		emit dataChanged(index(0), index(m_visible.size() - 1));
+	emit searchFinished();
+}
+
+QModelIndex LogModel::findNext(const QModelIndex &from, bool backwards) const
+{
+	if (m_matches.isEmpty() || m_visible.isEmpty())
+		return QModelIndex();
+	const int fromLine = from.isValid() ? m_visible[from.row()] : (backwards ? m_lines.size() : -1);
+
+	// walk the matches from the starting line, wrapping around once
+	auto start = backwards ? std::lower_bound(m_matches.begin(), m_matches.end(), fromLine)
+						   : std::upper_bound(m_matches.begin(), m_matches.end(), fromLine);
+	int pos = start - m_matches.begin();
+	for (int n = 0; n < m_matches.size(); n++)
+	{
+		int i;
+		if (backwards)
+			i = ((pos - 1 - n) % m_matches.size() + m_matches.size()) % m_matches.size();
+		else
+			i = (pos + n) % m_matches.size();
+		const int line = m_matches[i];
+		if (!isVisible(line))
+			continue;
+		auto row = std::lower_bound(m_visible.begin(), m_visible.end(), line);
+		return index(row - m_visible.begin());
+	}
+	return QModelIndex();
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid())
+		return 0;
+	return m_visible.size();
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= m_visible.size())
+		return QVariant();
+	const int lineNumber = m_visible[index.row()];
+	const Line &line = m_lines[lineNumber];
+	switch (role)
+	{
+	case Qt::DisplayRole:
+		return line.text;
+	case Qt::FontRole:
+		return m_font;
+	case Qt::ToolTipRole:
+	{
+		QString tooltip = QDateTime::fromMSecsSinceEpoch(line.time).toString("hh:mm:ss.zzz");
+		if (line.source)
+			tooltip += " - " + m_sources[line.source];
+		return tooltip;
+	}
+	case Qt::ForegroundRole:
+		switch (line.level)
+		{
+		case MessageLevel::MultiMC:
+			return QColor("blue");
+		case MessageLevel::Debug:
+			return QColor("green");
+		case MessageLevel::Warning:
+			return QColor("orange");
+		case MessageLevel::Error:
+		case MessageLevel::Fatal:
+			return QColor("red");
+		case MessageLevel::PrePost:
+			return QColor("grey");
+		default:
+			return QVariant();
+		}
+	case Qt::BackgroundRole:
+		if (!m_matchedTerm.isEmpty() &&
+			std::binary_search(m_matches.begin(), m_matches.end(), lineNumber))
+			return QColor("yellow");
+		if (line.level == MessageLevel::Fatal)
+			return QColor("black");
+		return QVariant();
+	case LevelRole:
+		return line.level;
+	case TimeRole:
+		return line.time;
+	case SourceRole:
+		return m_sources[line.source];
+	default:
+		return QVariant();
+	}
+}
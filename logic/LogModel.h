@@ -0,0 +1,144 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QAtomicInt>
+#include <QFont>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+#include "logic/MinecraftProcess.h"
+
+/**
+ * The lines of a game log, with their level, arrival time and source.
+ *
+ * Every level has a list of the lines that have it, so changing the level filter merges a few
+ * sorted lists instead of looking at every line. The lines matching the search term are kept
+ * in another sorted list - typing more of the term only narrows it down. Searching runs on
+ * worker threads, the matches are replaced when it is done and searchFinished() is emitted.
+ * The model rows are the lines that pass the level filter.
+ */
+class LogModel : public QAbstractListModel
+{
+	Q_OBJECT
+public:
+	enum Roles
+	{
+		LevelRole = Qt::UserRole,
+		TimeRole,
+		SourceRole
+	};
+	static const int levelCount = MessageLevel::PrePost + 1;
+
+	explicit LogModel(QObject *parent = 0);
+
+	/// add lines. the text is split on newlines, all of them get the level
+	void append(const QString &text, MessageLevel::Enum level);
+	void clear();
+
+	/// all lines, as plain text. not affected by the filter
+	QString toPlainText() const;
+
+	void setFont(const QFont &font);
+
+	void setLevelVisible(MessageLevel::Enum level, bool visible);
+	bool levelVisible(MessageLevel::Enum level) const;
+
+	/// highlight lines containing term and use them for findNext. case insensitive.
+	/// returns right away, the matches are updated when searchFinished() is emitted
+	void setSearchTerm(const QString &term);
+	QString searchTerm() const
+	{
+		return m_searchTerm;
+	}
+	/// true until the matches for searchTerm() are in
+	bool searchPending() const
+	{
+		return m_matchedTerm != m_searchTerm;
+	}
+	/// number of matching lines, including the filtered ones
+	int matchCount() const
+	{
+		return m_matches.size();
+	}
+	/// the next visible match after (or before) from. wraps around, invalid if there is none
+	QModelIndex findNext(const QModelIndex &from, bool backwards = false) const;
+
+	virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+signals:
+	/// the matches for searchTerm() are in
+	void searchFinished();
+
+private
+slots:
+	void scanFinished();
+
+private:
+	struct Line
+	{
+		QString text;
+		qint64 time;
+		quint16 source;
+		quint8 level;
+	};
+
+	bool isVisible(int line) const
+	{
+		return m_levelMask & (1u << m_lines[line].level);
+	}
+	bool isMatch(int line) const;
+	quint16 sourceOf(const QString &text);
+	struct ScanResult
+	{
+		QString term;
+		int generation = 0;
+		/// the lines up to here were looked at
+		int scanned = 0;
+		QVector<int> matches;
+	};
+	/// line numbers of matches within the given lines. gives up once generation is outdated
+	static QVector<int> scan(const QVector<Line> &lines, const QVector<int> &candidates,
+							 const QString &term, std::shared_ptr<QAtomicInt> latest,
+							 int generation);
+	void rebuildVisible();
+
+	QVector<Line> m_lines;
+	QVector<int> m_byLevel[levelCount];
+	/// line numbers of the rows
+	QVector<int> m_visible;
+	quint32 m_levelMask = ~0u;
+
+	/// the term that was asked for
+	QString m_searchTerm;
+	/// the term m_matches belong to. differs from m_searchTerm while a search runs
+	QString m_matchedTerm;
+	/// line numbers of all lines containing m_matchedTerm
+	QVector<int> m_matches;
+	/// generation of the newest search, scans of older ones stop early
+	std::shared_ptr<QAtomicInt> m_searchGeneration;
+	QFutureWatcher<ScanResult> m_scanWatcher;
+
+	QStringList m_sources;
+	QHash<QString, quint16> m_sourceIds;
+	QFont m_font;
+};
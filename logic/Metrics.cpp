@@ -0,0 +1,285 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Metrics.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QCoreApplication>
+#include <QThread>
+#include <algorithm>
+
+#include "logger/QsLog.h"
+
+namespace Metrics
+{
+Histogram::Histogram(const QVector<double> &bounds, const QString &name) : m_name(name)
+{
+	m_data.bounds = bounds;
+	m_data.buckets.fill(0, bounds.size() + 1);
+}
+
+void Histogram::observe(double value)
+{
+	// the first bucket whose upper bound isn't below the value
+	int bucket = std::lower_bound(m_data.bounds.begin(), m_data.bounds.end(), value) -
+				 m_data.bounds.begin();
+	QMutexLocker locker(&m_mutex);
+	m_data.buckets[bucket]++;
+	m_data.count++;
+	m_data.sum += value;
+	if (m_data.count == 1 || value > m_data.max)
+		m_data.max = value;
+}
+
+Histogram::Snapshot Histogram::snapshot() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_data;
+}
+
+namespace
+{
+QMutex g_phaseMutex;
+QStringList g_phases;
+
+bool onGuiThread()
+{
+	auto app = QCoreApplication::instance();
+	return app && QThread::currentThread() == app->thread();
+}
+}
+
+PhaseMarker::PhaseMarker(const QString &name) : m_tracked(onGuiThread())
+{
+	if (!m_tracked)
+		return;
+	QMutexLocker locker(&g_phaseMutex);
+	g_phases.append(name);
+}
+
+PhaseMarker::~PhaseMarker()
+{
+	if (!m_tracked)
+		return;
+	QMutexLocker locker(&g_phaseMutex);
+	g_phases.removeLast();
+}
+
+QString currentPhase()
+{
+	QMutexLocker locker(&g_phaseMutex);
+	return g_phases.isEmpty() ? QString() : g_phases.last();
+}
+
+ScopedTimer::ScopedTimer(Histogram &histogram)
+	: m_histogram(histogram), m_phase(histogram.name())
+{
+	m_timer.start();
+}
+
+ScopedTimer::~ScopedTimer()
+{
+	m_histogram.observe(m_timer.nsecsElapsed() / 1000000.0);
+}
+
+Registry &Registry::instance()
+{
+	static Registry registry;
+	return registry;
+}
+
+QVector<double> Registry::durationBuckets()
+{
+	return {1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000};
+}
+
+QVector<double> Registry::sizeBuckets()
+{
+	return {1024, 16 * 1024, 128 * 1024, 1024 * 1024, 8 * 1024 * 1024, 64 * 1024 * 1024,
+			512 * 1024 * 1024};
+}
+
+Counter &Registry::counter(const QString &name, const QString &help)
+{
+	QMutexLocker locker(&m_mutex);
+	auto &metric = m_metrics[name];
+	if (!metric)
+	{
+		metric = std::make_shared<Metric>();
+		metric->help = help;
+		metric->counter.reset(new Counter);
+	}
+	if (!metric->counter)
+	{
+		// a programming error - hand out a counter nobody reads rather than crash
+		QLOG_ERROR() << "Metric" << name << "is not a counter";
+		static Counter dummy;
+		return dummy;
+	}
+	return *metric->counter;
+}
+
+Histogram &Registry::histogram(const QString &name, const QString &help,
+							   const QVector<double> &bounds)
+{
+	QMutexLocker locker(&m_mutex);
+	auto &metric = m_metrics[name];
+	if (!metric)
+	{
+		metric = std::make_shared<Metric>();
+		metric->help = help;
+		metric->histogram.reset(new Histogram(bounds, name));
+	}
+	if (!metric->histogram)
+	{
+		QLOG_ERROR() << "Metric" << name << "is not a histogram";
+		static Histogram dummy(durationBuckets());
+		return dummy;
+	}
+	return *metric->histogram;
+}
+
+void Registry::setInfo(const QString &key, const QString &value)
+{
+	QMutexLocker locker(&m_mutex);
+	m_info[key] = value;
+}
+
+QList<Registry::Entry> Registry::entries() const
+{
+	QMutexLocker locker(&m_mutex);
+	QList<Entry> result;
+	for (auto iter = m_metrics.begin(); iter != m_metrics.end(); ++iter)
+	{
+		Entry entry;
+		entry.name = iter.key();
+		entry.help = iter.value()->help;
+		entry.counter = iter.value()->counter.get();
+		entry.histogram = iter.value()->histogram.get();
+		entry.type = entry.counter ? CounterType : HistogramType;
+		result.append(entry);
+	}
+	return result;
+}
+
+QByteArray Registry::toJson() const
+{
+	QJsonObject info;
+	{
+		QMutexLocker locker(&m_mutex);
+		for (auto iter = m_info.begin(); iter != m_info.end(); ++iter)
+			info.insert(iter.key(), iter.value());
+	}
+	QJsonObject metrics;
+	for (auto &entry : entries())
+	{
+		QJsonObject obj;
+		obj.insert("help", entry.help);
+		if (entry.type == CounterType)
+		{
+			obj.insert("type", QString("counter"));
+			obj.insert("value", double(entry.counter->value()));
+		}
+		else
+		{
+			auto data = entry.histogram->snapshot();
+			obj.insert("type", QString("histogram"));
+			obj.insert("count", double(data.count));
+			obj.insert("sum", data.sum);
+			obj.insert("max", data.max);
+			QJsonArray buckets;
+			for (int i = 0; i < data.buckets.size(); i++)
+			{
+				QJsonObject bucket;
+				if (i < data.bounds.size())
+					bucket.insert("le", data.bounds[i]);
+				else
+					bucket.insert("le", QString("+Inf"));
+				bucket.insert("count", double(data.buckets[i]));
+				buckets.append(bucket);
+			}
+			obj.insert("buckets", buckets);
+		}
+		metrics.insert(entry.name, obj);
+	}
+	QJsonObject root;
+	root.insert("info", info);
+	root.insert("metrics", metrics);
+	return QJsonDocument(root).toJson();
+}
+
+// the default 6 digits turn byte sizes into things like 8.38861e+06
+static QString formatNumber(double value)
+{
+	if (value == qint64(value) && qAbs(value) < 9007199254740992.0)
+		return QString::number(qint64(value));
+	// the shortest of these that reads back as the same number
+	QString text = QString::number(value, 'g', 15);
+	if (text.toDouble() != value)
+		text = QString::number(value, 'g', 17);
+	return text;
+}
+
+static QString escapeLabel(QString value)
+{
+	return value.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+}
+
+QByteArray Registry::toPrometheus() const
+{
+	QStringList lines;
+	{
+		QMutexLocker locker(&m_mutex);
+		if (!m_info.isEmpty())
+		{
+			QStringList labels;
+			for (auto iter = m_info.begin(); iter != m_info.end(); ++iter)
+				labels.append(QString("%1=\"%2\"").arg(iter.key(), escapeLabel(iter.value())));
+			lines.append("# HELP multimc_build_info The build and machine this came from.");
+			lines.append("# TYPE multimc_build_info gauge");
+			lines.append("multimc_build_info{" + labels.join(',') + "} 1");
+		}
+	}
+	for (auto &entry : entries())
+	{
+		const QString name = "multimc_" + entry.name;
+		lines.append("# HELP " + name + " " + QString(entry.help).replace('\n', ' '));
+		if (entry.type == CounterType)
+		{
+			lines.append("# TYPE " + name + " counter");
+			lines.append(name + " " + QString::number(entry.counter->value()));
+			continue;
+		}
+		auto data = entry.histogram->snapshot();
+		lines.append("# TYPE " + name + " histogram");
+		qint64 cumulative = 0;
+		for (int i = 0; i < data.bounds.size(); i++)
+		{
+			cumulative += data.buckets[i];
+			lines.append(QString("%1_bucket{le=\"%2\"} %3")
+							 .arg(name, formatNumber(data.bounds[i]))
+							 .arg(cumulative));
+		}
+		lines.append(QString("%1_bucket{le=\"+Inf\"} %2").arg(name).arg(data.count));
+		lines.append(QString("%1_sum %2").arg(name, formatNumber(data.sum)));
+		lines.append(QString("%1_count %2").arg(name).arg(data.count));
+	}
+	return (lines.join('\n') + '\n').toUtf8();
+}
+}
@@ -0,0 +1,182 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <atomic>
+#include <memory>
+
+/**
+ * Counters and histograms that the subsystems report into, for the diagnostics page and for
+ * comparing machines.
+ *
+ * Metrics are created on first use and live until the application exits, so call sites can
+ * keep a reference in a function local static:
+ *
+ *     static auto &hits = Metrics::Registry::instance().counter("cache_hits_total", "...");
+ *     hits.add();
+ *
+ * Updating a metric is safe from any thread.
+ */
+namespace Metrics
+{
+class Counter
+{
+public:
+	void add(qint64 amount = 1)
+	{
+		m_value.fetch_add(amount, std::memory_order_relaxed);
+	}
+	qint64 value() const
+	{
+		return m_value.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<qint64> m_value{0};
+};
+
+class Histogram
+{
+public:
+	struct Snapshot
+	{
+		/// upper bounds of the buckets. there is one more bucket for everything above
+		QVector<double> bounds;
+		/// observations per bucket, not cumulative
+		QVector<qint64> buckets;
+		qint64 count = 0;
+		double sum = 0;
+		double max = 0;
+	};
+
+	explicit Histogram(const QVector<double> &bounds, const QString &name = QString());
+	void observe(double value);
+	Snapshot snapshot() const;
+	QString name() const
+	{
+		return m_name;
+	}
+
+private:
+	const QString m_name;
+	mutable QMutex m_mutex;
+	Snapshot m_data;
+};
+
+/**
+ * Marks a phase of work, for attributing GUI thread stalls to it.
+ *
+ * Only phases on the GUI thread are tracked, everywhere else this does nothing. Phases nest,
+ * the innermost one is the current one.
+ */
+class PhaseMarker
+{
+public:
+	explicit PhaseMarker(const QString &name);
+	~PhaseMarker();
+
+private:
+	PhaseMarker(const PhaseMarker &) = delete;
+	PhaseMarker &operator=(const PhaseMarker &) = delete;
+
+	bool m_tracked;
+};
+
+/// the innermost phase running on the GUI thread right now. safe to call from any thread
+QString currentPhase();
+
+/// observes the time from construction to destruction in a histogram, in milliseconds.
+/// the histogram name is the phase for the stall detector while it runs
+class ScopedTimer
+{
+public:
+	explicit ScopedTimer(Histogram &histogram);
+	~ScopedTimer();
+
+private:
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+	Histogram &m_histogram;
+	PhaseMarker m_phase;
+	QElapsedTimer m_timer;
+};
+
+class Registry
+{
+public:
+	enum Type
+	{
+		CounterType,
+		HistogramType
+	};
+	struct Entry
+	{
+		QString name;
+		QString help;
+		Type type;
+		Counter *counter = nullptr;
+		Histogram *histogram = nullptr;
+	};
+
+	static Registry &instance();
+
+	/// buckets for durations in milliseconds
+	static QVector<double> durationBuckets();
+	/// buckets for sizes in bytes
+	static QVector<double> sizeBuckets();
+
+	/// get or create the counter with this name
+	Counter &counter(const QString &name, const QString &help);
+	/// get or create the histogram with this name. bounds only matter when it's created
+	Histogram &histogram(const QString &name, const QString &help,
+						 const QVector<double> &bounds = durationBuckets());
+
+	/// describes the machine and build, exported along with the metrics
+	void setInfo(const QString &key, const QString &value);
+
+	/// all metrics, sorted by name
+	QList<Entry> entries() const;
+
+	QByteArray toJson() const;
+	/// the Prometheus text exposition format. names get a 'multimc_' prefix
+	QByteArray toPrometheus() const;
+
+private:
+	Registry() = default;
+	Registry(const Registry &) = delete;
+	Registry &operator=(const Registry &) = delete;
+
+	struct Metric
+	{
+		QString help;
+		std::unique_ptr<Counter> counter;
+		std::unique_ptr<Histogram> histogram;
+	};
+
+	mutable QMutex m_mutex;
+	QMap<QString, std::shared_ptr<Metric>> m_metrics;
+	QMap<QString, QString> m_info;
+};
+}
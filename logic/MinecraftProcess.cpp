@@ -31,9 +31,22 @@
 #include "osutils.h"
 #include "pathutils.h"
 #include "cmdutils.h"
+#include "logic/Metrics.h"
 
 #define IBUS "@im=ibus"
 
+namespace
+{
+// the instance settings read while launching
+const SettingKey logPrePostOutputKey("LogPrePostOutput");
+const SettingKey preLaunchCommandKey("PreLaunchCommand");
+const SettingKey postExitCommandKey("PostExitCommand");
+const SettingKey javaPathKey("JavaPath");
+const SettingKey minMemAllocKey("MinMemAlloc");
+const SettingKey maxMemAllocKey("MaxMemAlloc");
+const SettingKey permGenKey("PermGen");
+}
+
 // constructor
 MinecraftProcess::MinecraftProcess(InstancePtr inst) : m_instance(inst)
 {
@@ -52,20 +65,20 @@ MinecraftProcess::MinecraftProcess(InstancePtr inst) : m_instance(inst)
 		// filter out dangerous java crap
 		if(ignored.contains(key))
 		{
-			QLOG_INFO() << "Env: ignoring" << key << value;
+			QCLOG_INFO(Process) << "Env: ignoring" << key << value;
 			continue;
 		}
 		// filter MultiMC-related things
 		if(key.startsWith("QT_"))
 		{
-			QLOG_INFO() << "Env: ignoring" << key << value;
+			QCLOG_INFO(Process) << "Env: ignoring" << key << value;
 			continue;
 		}
 #ifdef LINUX
 		// Do not pass LD_* variables to java. They were intended for MultiMC
 		if(key.startsWith("LD_"))
 		{
-			QLOG_INFO() << "Env: ignoring" << key << value;
+			QCLOG_INFO(Process) << "Env: ignoring" << key << value;
 			continue;
 		}
 		// Strip IBus
@@ -74,10 +87,10 @@ MinecraftProcess::MinecraftProcess(InstancePtr inst) : m_instance(inst)
 		{
 			QString save = value;
 			value.replace(IBUS, "");
-			QLOG_INFO() << "Env: stripped" << IBUS << "from" << save << ":" << value;
+			QCLOG_INFO(Process) << "Env: stripped" << IBUS << "from" << save << ":" << value;
 		}
 #endif
-		QLOG_INFO() << "Env: " << key << value;
+		QCLOG_INFO(Process) << "Env: " << key << value;
 		env.insert(key, value);
 	}
 #ifdef LINUX
@@ -100,7 +113,7 @@ MinecraftProcess::MinecraftProcess(InstancePtr inst) : m_instance(inst)
 	connect(this, SIGNAL(readyReadStandardOutput()), SLOT(on_stdOut()));
 
 	// Log prepost launch command output (can be disabled.)
-	if (m_instance->settings().get("LogPrePostOutput").toBool())
+	if (m_instance->settings().get(logPrePostOutputKey).toBool())
 	{
 		connect(&m_prepostlaunchprocess, &QProcess::readyReadStandardError, this,
 				&MinecraftProcess::on_prepost_stdErr);
@@ -119,20 +132,20 @@ void MinecraftProcess::setWorkdir(QString path)
 	m_prepostlaunchprocess.setWorkingDirectory(mcDir.absolutePath());
 }
 
-QString MinecraftProcess::censorPrivateInfo(QString in)
+QString MinecraftProcess::censorPrivateInfo(QString in, AuthSessionPtr session)
 {
-	if (!m_session)
+	if (!session)
 		return in;
 
-	if (m_session->session != "-")
-		in.replace(m_session->session, "<SESSION ID>");
-	in.replace(m_session->access_token, "<ACCESS TOKEN>");
-	in.replace(m_session->client_token, "<CLIENT TOKEN>");
-	in.replace(m_session->uuid, "<PROFILE ID>");
-	in.replace(m_session->player_name, "<PROFILE NAME>");
+	if (session->session != "-")
+		in.replace(session->session, "<SESSION ID>");
+	in.replace(session->access_token, "<ACCESS TOKEN>");
+	in.replace(session->client_token, "<CLIENT TOKEN>");
+	in.replace(session->uuid, "<PROFILE ID>");
+	in.replace(session->player_name, "<PROFILE NAME>");
 
-	auto i = m_session->u.properties.begin();
-	while (i != m_session->u.properties.end())
+	auto i = session->u.properties.begin();
+	while (i != session->u.properties.end())
 	{
 		in.replace(i.value(), "<" + i.key().toUpper() + ">");
 		++i;
@@ -206,6 +219,13 @@ MessageLevel::Enum MinecraftProcess::getLevel(const QString &levelName)
 void MinecraftProcess::logOutput(const QStringList &lines, MessageLevel::Enum defaultLevel,
 								 bool guessLevel, bool censor)
 {
+	static auto &logLines = Metrics::Registry::instance().counter(
+		"minecraft_log_lines_total", "Lines of output from Minecraft and the launch commands.");
+	static auto &logTime = Metrics::Registry::instance().histogram(
+		"minecraft_log_batch_ms",
+		"Time spent classifying and censoring one batch of Minecraft output, in milliseconds.");
+	Metrics::ScopedTimer timer(logTime);
+	logLines.add(lines.size());
 	for (int i = 0; i < lines.size(); ++i)
 		logOutput(lines[i], defaultLevel, guessLevel, censor);
 }
@@ -224,10 +244,10 @@ void MinecraftProcess::logOutput(QString line, MessageLevel::Enum defaultLevel,
 	}
 	// Guess level
 	else if (guessLevel)
-		level = this->guessLevel(line, defaultLevel);
+		level = MinecraftProcess::guessLevel(line, defaultLevel);
 
 	if (censor)
-		line = censorPrivateInfo(line);
+		line = censorPrivateInfo(line, m_session);
 
 	emit log(line, level);
 }
@@ -339,7 +359,7 @@ void MinecraftProcess::killMinecraft()
 
 bool MinecraftProcess::preLaunch()
 {
-	QString prelaunch_cmd = m_instance->settings().get("PreLaunchCommand").toString();
+	QString prelaunch_cmd = m_instance->settings().get(preLaunchCommandKey).toString();
 	if (!prelaunch_cmd.isEmpty())
 	{
 		prelaunch_cmd = substituteVariables(prelaunch_cmd);
@@ -384,7 +404,7 @@ bool MinecraftProcess::preLaunch()
 }
 bool MinecraftProcess::postLaunch()
 {
-	QString postlaunch_cmd = m_instance->settings().get("PostExitCommand").toString();
+	QString postlaunch_cmd = m_instance->settings().get(postExitCommandKey).toString();
 	if (!postlaunch_cmd.isEmpty())
 	{
 		postlaunch_cmd = substituteVariables(postlaunch_cmd);
@@ -448,7 +468,7 @@ QMap<QString, QString> MinecraftProcess::getVariables() const
 	out.insert("INST_ID", m_instance->id());
 	out.insert("INST_DIR", QDir(m_instance->instanceRoot()).absolutePath());
 	out.insert("INST_MC_DIR", QDir(m_instance->minecraftRoot()).absolutePath());
-	out.insert("INST_JAVA", m_instance->settings().get("JavaPath").toString());
+	out.insert("INST_JAVA", m_instance->settings().get(javaPathKey).toString());
 	out.insert("INST_JAVA_ARGS", javaArguments().join(' '));
 	return out;
 }
@@ -487,9 +507,9 @@ QStringList MinecraftProcess::javaArguments() const
 					"minecraft.exe.heapdump");
 #endif
 
-	args << QString("-Xms%1m").arg(m_instance->settings().get("MinMemAlloc").toInt());
-	args << QString("-Xmx%1m").arg(m_instance->settings().get("MaxMemAlloc").toInt());
-	auto permgen = m_instance->settings().get("PermGen").toInt();
+	args << QString("-Xms%1m").arg(m_instance->settings().get(minMemAllocKey).toInt());
+	args << QString("-Xmx%1m").arg(m_instance->settings().get(maxMemAllocKey).toInt());
+	auto permgen = m_instance->settings().get(permGenKey).toInt();
 	if (permgen != 64)
 	{
 		args << QString("-XX:PermSize=%1m").arg(permgen);
@@ -517,10 +537,10 @@ void MinecraftProcess::arm()
 
 	QStringList args = javaArguments();
 
-	QString JavaPath = m_instance->settings().get("JavaPath").toString();
+	QString JavaPath = m_instance->settings().get(javaPathKey).toString();
 	emit log("Java path is:\n" + JavaPath + "\n\n");
 	QString allArgs = args.join(", ");
-	emit log("Java Arguments:\n[" + censorPrivateInfo(allArgs) + "]\n\n");
+	emit log("Java Arguments:\n[" + censorPrivateInfo(allArgs, m_session) + "]\n\n");
 
 	auto realJavaPath = QStandardPaths::findExecutable(JavaPath);
 	if (realJavaPath.isEmpty())
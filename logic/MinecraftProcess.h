@@ -98,6 +98,12 @@ public:
 		m_session = session;
 	}
 
+	/// replace the secrets of the session in a line of output
+	static QString censorPrivateInfo(QString in, AuthSessionPtr session);
+
+	/// guess the level of a line of output from the usual log formats
+	static MessageLevel::Enum guessLevel(const QString &message, MessageLevel::Enum defaultLevel);
+
 signals:
 	/**
 	 * @brief emitted when Minecraft immediately fails to run
@@ -159,7 +165,5 @@ slots:
 				   bool guessLevel = true, bool censor = true);
 
 private:
-	QString censorPrivateInfo(QString in);
-	MessageLevel::Enum guessLevel(const QString &message, MessageLevel::Enum defaultLevel);
 	MessageLevel::Enum getLevel(const QString &levelName);
 };
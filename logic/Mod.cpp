@@ -23,6 +23,8 @@
 #include <quazipfile.h>
 
 #include "Mod.h"
+#include "ModStore.h"
+#include "MultiMC.h"
 #include <pathutils.h>
 #include "logic/settings/INIFile.h"
 #include "logger/QsLog.h"
@@ -209,8 +211,8 @@ void Mod::ReadMCModInfo(QByteArray contents)
 		int version = val.toDouble();
 		if (version != 2)
 		{
-			QLOG_ERROR() << "BAD stuff happened to mod json:";
-			QLOG_ERROR() << contents;
+			QCLOG_ERROR(Mods) << "BAD stuff happened to mod json:";
+			QCLOG_ERROR(Mods) << contents;
 			return;
 		}
 		auto arrVal = jsonDoc.object().value("modlist");
@@ -273,8 +275,8 @@ bool Mod::replace(Mod &with)
 
 	if (t == MOD_ZIPFILE || t == MOD_SINGLEFILE || t == MOD_LITEMOD)
 	{
-		QLOG_DEBUG() << "Copy: " << with.m_file.filePath() << " to " << m_file.filePath();
-		success = QFile::copy(with.m_file.filePath(), m_file.filePath());
+		QCLOG_DEBUG(Mods) << "Copy: " << with.m_file.filePath() << " to " << m_file.filePath();
+		success = MMC->modstore()->install(with.m_file.filePath(), m_file.filePath());
 	}
 	if (t == MOD_FOLDER)
 	{
@@ -15,13 +15,16 @@
 
 #include "ModList.h"
 #include "LegacyInstance.h"
+#include "ModStore.h"
+#include "MultiMC.h"
 #include <pathutils.h>
 #include <QMimeData>
 #include <QUrl>
 #include <QUuid>
 #include <QString>
-#include <QFileSystemWatcher>
 #include "logger/QsLog.h"
+#include "logic/Metrics.h"
+#include "logic/WatchHub.h"
 
 ModList::ModList(const QString &dir, const QString &list_file)
 	: QAbstractListModel(), m_dir(dir), m_list_file(list_file)
@@ -31,36 +34,33 @@ ModList::ModList(const QString &dir, const QString &list_file)
 					QDir::NoSymLinks);
 	m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
 	m_list_id = QUuid::createUuid().toString();
-	m_watcher = new QFileSystemWatcher(this);
 	is_watching = false;
-	connect(m_watcher, SIGNAL(directoryChanged(QString)), this,
-			SLOT(directoryChanged(QString)));
 }
 
 void ModList::startWatching()
 {
-	is_watching = m_watcher->addPath(m_dir.absolutePath());
 	if (is_watching)
-	{
-		QLOG_INFO() << "Started watching " << m_dir.absolutePath();
-	}
-	else
-	{
-		QLOG_INFO() << "Failed to start watching " << m_dir.absolutePath();
-	}
+		return;
+	// shared with every other list of the same folder
+	m_watch = MMC->watches()->watch(m_dir.absolutePath());
+	connect(m_watch.get(), SIGNAL(changed(QString)), this, SLOT(directoryChanged(QString)));
+	is_watching = true;
+	QCLOG_INFO(Mods) << "Started watching " << m_dir.absolutePath();
 }
 
 void ModList::stopWatching()
 {
-	is_watching = !m_watcher->removePath(m_dir.absolutePath());
 	if (!is_watching)
-	{
-		QLOG_INFO() << "Stopped watching " << m_dir.absolutePath();
-	}
-	else
-	{
-		QLOG_INFO() << "Failed to stop watching " << m_dir.absolutePath();
-	}
+		return;
+	disconnect(m_watch.get(), 0, this, 0);
+	m_watch.reset();
+	is_watching = false;
+	QCLOG_INFO(Mods) << "Stopped watching " << m_dir.absolutePath();
+}
+
+WatchSuspension ModList::suspendWatching()
+{
+	return MMC->watches()->suspend(m_dir.absolutePath());
 }
 
 void ModList::internalSort(QList<Mod> &what)
@@ -81,10 +81,18 @@ bool ModList::update()
 	if (!isValid())
 		return false;
 
+	auto &registry = Metrics::Registry::instance();
+	static auto &scanTime = registry.histogram(
+		"mod_scan_ms", "Time it takes to scan a mod folder, in milliseconds.");
+	static auto &scannedFiles =
+		registry.counter("mod_scan_files_total", "Files looked at by mod folder scans.");
+	Metrics::ScopedTimer timer(scanTime);
+
 	QList<Mod> orderedMods;
 	QList<Mod> newMods;
 	m_dir.refresh();
 	auto folderContents = m_dir.entryInfoList();
+	scannedFiles.add(folderContents.size());
 	bool orderOrStateChanged = false;
 
 	// first, process the ordered items (if any)
@@ -162,7 +170,7 @@ bool ModList::update()
 	endResetModel();
 	if (orderOrStateChanged && !m_list_file.isEmpty())
 	{
-		QLOG_INFO() << "Mod list " << m_list_file << " changed!";
+		QCLOG_INFO(Mods) << "Mod list " << m_list_file << " changed!";
 		saveListFile();
 		emit changed();
 	}
@@ -244,6 +252,7 @@ bool ModList::installMod(const QFileInfo &filename, int index)
 	Mod m(filename);
 	if (!m.valid())
 		return false;
+	auto suspension = suspendWatching();
 
 	// if it's already there, replace the original mod (in place)
 	int idx = mods.indexOf(m);
@@ -271,7 +280,7 @@ bool ModList::installMod(const QFileInfo &filename, int index)
 	if (type == Mod::MOD_SINGLEFILE || type == Mod::MOD_ZIPFILE || type == Mod::MOD_LITEMOD)
 	{
 		QString newpath = PathCombine(m_dir.path(), filename.fileName());
-		if (!QFile::copy(filename.filePath(), newpath))
+		if (!MMC->modstore()->install(filename.filePath(), newpath))
 			return false;
 		m.repath(newpath);
 		beginInsertRows(QModelIndex(), index, index);
@@ -303,6 +312,7 @@ bool ModList::deleteMod(int index)
 {
 	if (index >= mods.size() || index < 0)
 		return false;
+	auto suspension = suspendWatching();
 	Mod &m = mods[index];
 	if (m.destroy())
 	{
@@ -311,6 +321,7 @@ bool ModList::deleteMod(int index)
 		endRemoveRows();
 		saveListFile();
 		emit changed();
+		releaseStoreObjects();
 		return true;
 	}
 	return false;
@@ -318,6 +329,7 @@ bool ModList::deleteMod(int index)
 
 bool ModList::deleteMods(int first, int last)
 {
+	auto suspension = suspendWatching();
 	for (int i = first; i <= last; i++)
 	{
 		Mod &m = mods[i];
@@ -328,9 +340,18 @@ bool ModList::deleteMods(int first, int last)
 	endRemoveRows();
 	saveListFile();
 	emit changed();
+	releaseStoreObjects();
 	return true;
 }
 
+void ModList::releaseStoreObjects()
+{
+	// deleting a linked mod drops its reference, the object may be unused now
+	auto store = MMC->modstore();
+	if (store->enabled())
+		store->collectGarbageEventually();
+}
+
 bool ModList::moveModTo(int from, int to)
 {
 	if (from < 0 || from >= mods.size())
@@ -448,6 +469,7 @@ bool ModList::setData(const QModelIndex &index, const QVariant &value, int role)
 	if (role == Qt::CheckStateRole)
 	{
 		auto &mod = mods[index.row()];
+		auto suspension = suspendWatching();
 		if (mod.enable(!mod.enabled()))
 		{
 			emit dataChanged(index, index);
@@ -559,14 +581,12 @@ bool ModList::dropMimeData(const QMimeData *data, Qt::DropAction action, int row
 		row = rowCount();
 	if (column == -1)
 		column = 0;
-	QLOG_INFO() << "Drop row: " << row << " column: " << column;
+	QCLOG_INFO(Mods) << "Drop row: " << row << " column: " << column;
 
 	// files dropped from outside?
 	if (data->hasUrls())
 	{
-		bool was_watching = is_watching;
-		if (was_watching)
-			stopWatching();
+		auto suspension = suspendWatching();
 		auto urls = data->urls();
 		for (auto url : urls)
 		{
@@ -575,7 +595,7 @@ bool ModList::dropMimeData(const QMimeData *data, Qt::DropAction action, int row
 				continue;
 			QString filename = url.toLocalFile();
 			installMod(filename, row);
-			QLOG_INFO() << "installing: " << filename;
+			QCLOG_INFO(Mods) << "installing: " << filename;
 			// if there is no ordering, re-sort the list
 			if (m_list_file.isEmpty())
 			{
@@ -584,8 +604,6 @@ bool ModList::dropMimeData(const QMimeData *data, Qt::DropAction action, int row
 				endResetModel();
 			}
 		}
-		if (was_watching)
-			startWatching();
 		return true;
 	}
 	else if (data->hasText())
@@ -596,7 +614,7 @@ bool ModList::dropMimeData(const QMimeData *data, Qt::DropAction action, int row
 			return false;
 		QString remoteId = list[0];
 		int remoteIndex = list[1].toInt();
-		QLOG_INFO() << "move: " << sourcestr;
+		QCLOG_INFO(Mods) << "move: " << sourcestr;
 		// no moving of things between two lists
 		if (remoteId != m_list_id)
 			return false;
@@ -21,10 +21,10 @@
 #include <QAbstractListModel>
 
 #include "logic/Mod.h"
+#include "logic/WatchHub.h"
 
 class LegacyInstance;
 class BaseInstance;
-class QFileSystemWatcher;
 
 /**
  * A legacy mod list.
@@ -118,6 +118,8 @@ public:
 
 	void startWatching();
 	void stopWatching();
+	/// the list changes the folder itself while this is held, don't rescan because of it
+	WatchSuspension suspendWatching();
 
 	virtual bool isValid();
 
@@ -141,6 +143,7 @@ private:
 	typedef QList<OrderItem> OrderList;
 	OrderList readListFile();
 	bool saveListFile();
+	void releaseStoreObjects();
 private
 slots:
 	void directoryChanged(QString path);
@@ -149,7 +152,7 @@ signals:
 	void changed();
 
 protected:
-	QFileSystemWatcher *m_watcher;
+	WatchHandlePtr m_watch;
 	bool is_watching;
 	QDir m_dir;
 	QString m_list_file;
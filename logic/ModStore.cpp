@@ -0,0 +1,170 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ModStore.h"
+#include "MultiMC.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <QUuid>
+
+#include <pathutils.h>
+#include "logic/settings/SettingsObject.h"
+#include "logger/QsLog.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#endif
+
+ModStore::ModStore(QString path) : QObject()
+{
+	m_root = path;
+	gcBatchingTimer.setSingleShot(true);
+	gcBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
+	connect(&gcBatchingTimer, SIGNAL(timeout()), SLOT(collectGarbage()));
+}
+
+bool ModStore::enabled() const
+{
+#ifdef Q_OS_UNIX
+	return MMC->settings()->get("UseModStore").toBool();
+#else
+	return false;
+#endif
+}
+
+int ModStore::linkCount(const QString &path)
+{
+#ifdef Q_OS_UNIX
+	struct stat buf;
+	if (::lstat(QFile::encodeName(path).constData(), &buf) != 0)
+		return 0;
+	return buf.st_nlink;
+#else
+	Q_UNUSED(path);
+	return 0;
+#endif
+}
+
+QString ModStore::hashFile(const QString &path)
+{
+	QFile input(path);
+	if (!input.open(QIODevice::ReadOnly))
+		return QString();
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if (!hash.addData(&input))
+		return QString();
+	return hash.result().toHex();
+}
+
+bool ModStore::sameFilesystem(const QString &path) const
+{
+#ifdef Q_OS_UNIX
+	QString objects = PathCombine(m_root, "objects");
+	if (!ensureFolderPathExists(objects))
+		return false;
+	struct stat fileStat, storeStat;
+	if (::stat(QFile::encodeName(path).constData(), &fileStat) != 0 ||
+		::stat(QFile::encodeName(objects).constData(), &storeStat) != 0)
+		return false;
+	return fileStat.st_dev == storeStat.st_dev;
+#else
+	Q_UNUSED(path);
+	return false;
+#endif
+}
+
+QString ModStore::objectPath(const QString &hash) const
+{
+	return PathCombine(m_root, "objects", PathCombine(hash.left(2), hash));
+}
+
+QString ModStore::storeFile(const QString &path, const QString &hash)
+{
+	QString object = objectPath(hash);
+	if (QFileInfo(object).isFile())
+		return object;
+	if (!ensureFilePathExists(object))
+		return QString();
+
+	// copy under a temporary name first, so a half-written object never shows up
+	QString temp = object + "." + QUuid::createUuid().toString().mid(1, 8);
+	if (!QFile::copy(path, temp))
+		return QString();
+	// objects are shared, nobody should modify them in place
+	QFile::setPermissions(temp, QFile::ReadOwner | QFile::ReadGroup | QFile::ReadOther);
+	if (!QFile::rename(temp, object))
+	{
+		QFile::remove(temp);
+		// somebody else stored the same thing in the meantime
+		if (!QFileInfo(object).isFile())
+			return QString();
+	}
+	return object;
+}
+
+bool ModStore::install(const QString &source, const QString &target)
+{
+	// hardlinks can't cross filesystems, don't bother storing anything then
+	if (enabled() && sameFilesystem(QFileInfo(target).absolutePath()))
+	{
+		QString hash = hashFile(source);
+		QString object = hash.isEmpty() ? QString() : storeFile(source, hash);
+#ifdef Q_OS_UNIX
+		if (!object.isEmpty() &&
+			::link(QFile::encodeName(object).constData(), QFile::encodeName(target).constData()) == 0)
+		{
+			QCLOG_DEBUG(Mods) << "Linked" << target << "to mod store object" << object;
+			return true;
+		}
+#endif
+		QCLOG_WARN(Mods) << "Couldn't link" << target << "into the mod store, copying it instead.";
+	}
+	return QFile::copy(source, target);
+}
+
+void ModStore::collectGarbageEventually()
+{
+	// reset the timer
+	gcBatchingTimer.stop();
+	gcBatchingTimer.start(10000);
+}
+
+int ModStore::collectGarbage()
+{
+	int removed = 0;
+	QDirIterator iter(PathCombine(m_root, "objects"), QDir::Files, QDirIterator::Subdirectories);
+	while (iter.hasNext())
+	{
+		QString object = iter.next();
+		// only the store itself links to it
+		if (linkCount(object) == 1)
+		{
+			QFile::setPermissions(object, QFile::ReadOwner | QFile::WriteOwner);
+			if (QFile::remove(object))
+				removed++;
+		}
+	}
+	if (removed)
+	{
+		QCLOG_INFO(Mods) << "Removed" << removed << "unused objects from the mod store.";
+	}
+	return removed;
+}
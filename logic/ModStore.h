@@ -0,0 +1,75 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <memory>
+
+/**
+ * A content addressed store for mod files, shared by all instances.
+ *
+ * Objects are kept as objects/<first two hex digits>/<sha1>, like the assets. Instance mod
+ * folders contain hardlinks to them, so the link count of an object is its reference count:
+ * renaming a mod (enabling/disabling it) keeps the reference, deleting it drops the reference.
+ * Objects nobody links to anymore are removed by collectGarbage().
+ *
+ * Objects are read-only, and so are the mod files linked to them, since they share the inode.
+ * Only files the launcher installs itself are linked. Files the user put into a mod folder
+ * are left alone, they stay the user's own writable files.
+ */
+class ModStore : public QObject
+{
+	Q_OBJECT
+public:
+	// supply path to the store root
+	ModStore(QString path);
+
+	/// true if the store is turned on and the platform can do hardlinks
+	bool enabled() const;
+
+	/**
+	 * Put a copy of source at target.
+	 * If the store is enabled, the copy is a link to the store object. Otherwise, or if linking
+	 * fails (different filesystem...), a plain copy is made.
+	 */
+	bool install(const QString &source, const QString &target);
+
+	/// The number of hardlinks of the file, 0 if it can't be determined
+	static int linkCount(const QString &path);
+
+	/// (re)start a timer that calls collectGarbage later.
+	void collectGarbageEventually();
+
+public
+slots:
+	/// remove objects that aren't linked from anywhere. returns the number removed
+	int collectGarbage();
+
+private:
+	/// Get the object for the file with the given hash, creating it by copying the file
+	QString storeFile(const QString &path, const QString &hash);
+	QString objectPath(const QString &hash) const;
+	static QString hashFile(const QString &path);
+	/// true if the file is on the same filesystem as the store, so it can be linked
+	bool sameFilesystem(const QString &path) const;
+
+	QString m_root;
+	QTimer gcBatchingTimer;
+};
+
+typedef std::shared_ptr<ModStore> ModStorePtr;
@@ -26,6 +26,7 @@
 #include "minecraft/VersionBuildError.h"
 
 #include "logic/assets/AssetsUtils.h"
+#include "logic/Metrics.h"
 #include "icons/IconList.h"
 #include "logic/MinecraftProcess.h"
 #include "gui/pagedialog/PageDialog.h"
@@ -70,7 +71,7 @@ QList<BasePage *> OneSixInstance::getPages()
 	values.append(new NotesPage(this));
 	values.append(new ScreenshotsPage(this));
 	values.append(new InstanceSettingsPage(this));
-	values.append(new OtherLogsPage(this));
+	values.append(new OtherLogsPage(minecraftRoot()));
 	return values;
 }
 
@@ -121,6 +122,9 @@ QString replaceTokensIn(QString text, QMap<QString, QString> with)
 
 QDir OneSixInstance::reconstructAssets(std::shared_ptr<InstanceVersion> version)
 {
+	static auto &reconstructTime = Metrics::Registry::instance().histogram(
+		"assets_reconstruct_ms", "Time it takes to reconstruct virtual assets, in milliseconds.");
+	Metrics::ScopedTimer timer(reconstructTime);
 	QDir assetsDir = QDir("assets/");
 	QDir indexDir = QDir(PathCombine(assetsDir.path(), "indexes"));
 	QDir objectDir = QDir(PathCombine(assetsDir.path(), "objects"));
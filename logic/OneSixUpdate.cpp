@@ -34,6 +34,7 @@
 #include "logic/net/URLConstants.h"
 #include "logic/assets/AssetsUtils.h"
 #include "JarUtils.h"
+#include "logic/Metrics.h"
 
 OneSixUpdate::OneSixUpdate(OneSixInstance *inst, QObject *parent) : Task(parent), m_inst(inst)
 {
@@ -285,6 +286,10 @@ void OneSixUpdate::jarlibStart()
 
 void OneSixUpdate::jarlibFinished()
 {
+	static auto &finishTime = Metrics::Registry::instance().histogram(
+		"onesix_jar_prepare_ms",
+		"Time it takes to prepare the minecraft.jar after downloading libraries, in milliseconds.");
+	Metrics::ScopedTimer timer(finishTime);
 	OneSixInstance *inst = (OneSixInstance *)m_inst;
 	std::shared_ptr<InstanceVersion> version = inst->getFullVersion();
 
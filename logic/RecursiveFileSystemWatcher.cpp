@@ -1,15 +1,61 @@
 #include "RecursiveFileSystemWatcher.h"
 
-#include <QRegularExpression>
-#include <QDebug>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include "logger/QsLog.h"
+#include "MultiMC.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#include <climits>
+#include <cstring>
+
+static const uint32_t dirEvents = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+								  IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+static const uint32_t fileEvents = IN_CLOSE_WRITE | IN_MODIFY;
+#endif
+
+// how long changes are collected before the file list is updated
+static const int coalesceWindow = 200;
+static const int pollInterval = 2000;
 
 RecursiveFileSystemWatcher::RecursiveFileSystemWatcher(QObject *parent)
-	: QObject(parent), m_exp(".*"), m_watcher(new QFileSystemWatcher(this))
+	: QObject(parent), m_exp(".*")
+{
+	m_coalesceTimer.setSingleShot(true);
+	m_coalesceTimer.setInterval(coalesceWindow);
+	connect(&m_coalesceTimer, SIGNAL(timeout()), SLOT(processChanges()));
+	m_pollTimer.setInterval(pollInterval);
+	connect(&m_pollTimer, SIGNAL(timeout()), SLOT(poll()));
+
+#ifdef Q_OS_LINUX
+	m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_inotify == -1)
+	{
+		QLOG_WARN() << "inotify is not available, using the shared watches:"
+					<< strerror(errno);
+	}
+	else
+	{
+		m_notifier = new QSocketNotifier(m_inotify, QSocketNotifier::Read, this);
+		connect(m_notifier, SIGNAL(activated(int)), SLOT(readInotify()));
+	}
+#endif
+}
+
+RecursiveFileSystemWatcher::~RecursiveFileSystemWatcher()
 {
-	connect(m_watcher, &QFileSystemWatcher::fileChanged, this,
-			&RecursiveFileSystemWatcher::fileChange);
-	connect(m_watcher, &QFileSystemWatcher::directoryChanged, this,
-			&RecursiveFileSystemWatcher::directoryChange);
+#ifdef Q_OS_LINUX
+	if (m_inotify != -1)
+	{
+		// closing the descriptor drops all the watches
+		delete m_notifier;
+		::close(m_inotify);
+	}
+#endif
 }
 
 void RecursiveFileSystemWatcher::setRootDir(const QDir &root)
@@ -17,7 +63,8 @@ void RecursiveFileSystemWatcher::setRootDir(const QDir &root)
 	bool wasEnabled = m_isEnabled;
 	disable();
 	m_root = root;
-	setFiles(scanRecursive(m_root));
+	scanAll();
+	updateFiles();
 	if (wasEnabled)
 	{
 		enable();
@@ -34,6 +81,18 @@ void RecursiveFileSystemWatcher::setWatchFiles(const bool watchFiles)
 	}
 }
 
+void RecursiveFileSystemWatcher::setFileExpression(const QString &exp)
+{
+	// compiled once here, not for every scan
+	m_exp = QRegularExpression(exp);
+	m_exp.optimize();
+	if (!m_dirs.isEmpty())
+	{
+		scanAll();
+		updateFiles();
+	}
+}
+
 void RecursiveFileSystemWatcher::enable()
 {
 	if (m_isEnabled)
@@ -41,8 +100,14 @@ void RecursiveFileSystemWatcher::enable()
 		return;
 	}
 	Q_ASSERT(m_root != QDir::root());
-	addFilesToWatcherRecursive(m_root);
 	m_isEnabled = true;
+	// pick up whatever happened while we weren't looking, and add the watches
+	scanAll();
+	updateFiles();
+	if (m_polling)
+	{
+		m_pollTimer.start();
+	}
 }
 void RecursiveFileSystemWatcher::disable()
 {
@@ -51,12 +116,108 @@ void RecursiveFileSystemWatcher::disable()
 		return;
 	}
 	m_isEnabled = false;
-	m_watcher->removePaths(m_watcher->files());
-	m_watcher->removePaths(m_watcher->directories());
+	m_pollTimer.stop();
+	m_coalesceTimer.stop();
+	m_dirtyDirs.clear();
+	m_changedFiles.clear();
+	unwatchAll();
 }
 
-void RecursiveFileSystemWatcher::setFiles(const QStringList &files)
+QString RecursiveFileSystemWatcher::absolutePath(const QString &relDir) const
 {
+	return relDir.isEmpty() ? m_root.absolutePath() : m_root.absoluteFilePath(relDir);
+}
+
+QString RecursiveFileSystemWatcher::childPath(const QString &relDir, const QString &name)
+{
+	return relDir.isEmpty() ? name : relDir + '/' + name;
+}
+
+void RecursiveFileSystemWatcher::scanAll()
+{
+	for (auto dir : m_dirs.keys())
+	{
+		unwatchDir(dir);
+	}
+	m_dirs.clear();
+	m_fullRescan = false;
+	scanDir(QString(), true);
+}
+
+void RecursiveFileSystemWatcher::scanDir(const QString &relDir, bool recursive)
+{
+	QDir dir(absolutePath(relDir));
+	if (!dir.exists())
+	{
+		removeDir(relDir);
+		return;
+	}
+	// watch before listing, anything created in between then still causes another scan
+	const bool known = m_dirs.contains(relDir);
+	if (m_isEnabled && !m_polling && !isWatched(relDir, known))
+	{
+		watchDir(relDir);
+	}
+
+	DirEntry entry;
+	for (const QString &file : dir.entryList(QDir::Files))
+	{
+		if (m_exp.match(file).hasMatch())
+		{
+			entry.files.append(childPath(relDir, file));
+		}
+	}
+	entry.subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+	const DirEntry oldEntry = m_dirs.value(relDir);
+	m_dirs.insert(relDir, entry);
+	if (m_isEnabled && !m_polling)
+	{
+		updateFileWatches(relDir, oldEntry.files);
+	}
+
+	for (const QString &subdir : oldEntry.subdirs)
+	{
+		if (!entry.subdirs.contains(subdir))
+		{
+			removeDir(childPath(relDir, subdir));
+		}
+	}
+	for (const QString &subdir : entry.subdirs)
+	{
+		const QString child = childPath(relDir, subdir);
+		if (recursive || !m_dirs.contains(child))
+		{
+			scanDir(child, true);
+		}
+	}
+}
+
+void RecursiveFileSystemWatcher::removeDir(const QString &relDir)
+{
+	auto iter = m_dirs.find(relDir);
+	if (iter == m_dirs.end())
+	{
+		return;
+	}
+	const QStringList subdirs = iter->subdirs;
+	// the shared file watches are found through the entry
+	unwatchDir(relDir);
+	m_dirs.remove(relDir);
+	for (const QString &subdir : subdirs)
+	{
+		removeDir(childPath(relDir, subdir));
+	}
+}
+
+void RecursiveFileSystemWatcher::updateFiles()
+{
+	QStringList files;
+	for (auto &entry : m_dirs)
+	{
+		files.append(entry.files);
+	}
+	files.sort();
 	if (files != m_files)
 	{
 		m_files = files;
@@ -64,44 +225,289 @@ void RecursiveFileSystemWatcher::setFiles(const QStringList &files)
 	}
 }
 
-void RecursiveFileSystemWatcher::addFilesToWatcherRecursive(const QDir &dir)
+bool RecursiveFileSystemWatcher::isWatched(const QString &relDir, bool known) const
 {
-	m_watcher->addPath(dir.absolutePath());
-	for (const QString &directory : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+#ifdef Q_OS_LINUX
+	// a directory that was replaced is known, but its watch went away with the old one
+	if (m_inotify != -1)
 	{
-		addFilesToWatcherRecursive(dir.absoluteFilePath(directory));
+		return m_dirToWatch.contains(relDir);
 	}
-	if (m_watchFiles)
+#endif
+	return known;
+}
+
+bool RecursiveFileSystemWatcher::watchDir(const QString &relDir)
+{
+	const QString path = absolutePath(relDir);
+#ifdef Q_OS_LINUX
+	if (m_inotify != -1)
+	{
+		const uint32_t mask = dirEvents | (m_watchFiles ? fileEvents : 0);
+		int wd = -1;
+		if (m_watchLimit == -1 || m_dirToWatch.size() < m_watchLimit)
+		{
+			wd = inotify_add_watch(m_inotify, QFile::encodeName(path).constData(), mask);
+		}
+		else
+		{
+			errno = ENOSPC;
+		}
+		if (wd == -1)
+		{
+			if (errno == ENOSPC || errno == ENOMEM)
+			{
+				QLOG_WARN() << "Out of inotify watches, polling" << m_root.absolutePath()
+							<< "instead.";
+				startPolling();
+			}
+			return false;
+		}
+		m_watchToDir.insert(wd, relDir);
+		m_dirToWatch.insert(relDir, wd);
+		return true;
+	}
+#endif
+	auto watch = MMC->watches()->watch(path);
+	if (!watch->isActive() || (m_watchLimit != -1 && m_watches.size() >= m_watchLimit))
+	{
+		QLOG_WARN() << "Can't watch" << path << "- polling" << m_root.absolutePath()
+					<< "instead.";
+		startPolling();
+		return false;
+	}
+	connect(watch.get(), SIGNAL(changed(QString)), SLOT(directoryChange(QString)));
+	m_watches.insert(path, watch);
+	return true;
+}
+
+void RecursiveFileSystemWatcher::updateFileWatches(const QString &relDir,
+												   const QStringList &oldFiles)
+{
+#ifdef Q_OS_LINUX
+	// the directory watch covers its files
+	if (m_inotify != -1)
+	{
+		return;
+	}
+#endif
+	if (!m_watchFiles)
+	{
+		return;
+	}
+	const QStringList files = m_dirs.value(relDir).files;
+	for (const QString &file : oldFiles)
 	{
-		for (const QFileInfo &info : dir.entryInfoList(QDir::Files))
+		if (!files.contains(file))
 		{
-			m_watcher->addPath(info.absoluteFilePath());
+			auto watch = m_watches.take(m_root.absoluteFilePath(file));
+			if (watch)
+				disconnect(watch.get(), 0, this, 0);
 		}
 	}
+	for (const QString &file : files)
+	{
+		const QString filePath = m_root.absoluteFilePath(file);
+		if (m_watches.contains(filePath))
+		{
+			continue;
+		}
+		auto fileWatch = MMC->watches()->watch(filePath);
+		connect(fileWatch.get(), SIGNAL(changed(QString)), SLOT(fileChange(QString)));
+		m_watches.insert(filePath, fileWatch);
+	}
 }
-QStringList RecursiveFileSystemWatcher::scanRecursive(const QDir &directory)
+
+void RecursiveFileSystemWatcher::unwatchDir(const QString &relDir)
 {
-	QStringList ret;
-	QRegularExpression exp(m_exp);
-	for (const QString &dir : directory.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+#ifdef Q_OS_LINUX
+	if (m_inotify != -1)
 	{
-		ret.append(scanRecursive(directory.absoluteFilePath(dir)));
+		auto iter = m_dirToWatch.find(relDir);
+		if (iter != m_dirToWatch.end())
+		{
+			inotify_rm_watch(m_inotify, *iter);
+			m_watchToDir.remove(*iter);
+			m_dirToWatch.erase(iter);
+		}
+		return;
 	}
-	for (const QString &file : directory.entryList(QDir::Files))
+#endif
+	auto dropWatch = [this](const QString &path)
+	{
+		auto watch = m_watches.take(path);
+		if (watch)
+			disconnect(watch.get(), 0, this, 0);
+	};
+	dropWatch(absolutePath(relDir));
+	if (m_watchFiles)
 	{
-		if (exp.match(file).hasMatch())
+		for (const QString &file : m_dirs.value(relDir).files)
 		{
-			ret.append(m_root.relativeFilePath(directory.absoluteFilePath(file)));
+			dropWatch(m_root.absoluteFilePath(file));
 		}
 	}
-	return ret;
+}
+
+void RecursiveFileSystemWatcher::unwatchAll()
+{
+#ifdef Q_OS_LINUX
+	for (int wd : m_watchToDir.keys())
+	{
+		inotify_rm_watch(m_inotify, wd);
+	}
+	m_watchToDir.clear();
+	m_dirToWatch.clear();
+#endif
+	for (auto watch : m_watches)
+	{
+		disconnect(watch.get(), 0, this, 0);
+	}
+	m_watches.clear();
+}
+
+void RecursiveFileSystemWatcher::startPolling()
+{
+	if (m_polling)
+	{
+		return;
+	}
+	m_polling = true;
+	// the watches we got are useless without the rest
+	unwatchAll();
+	if (m_isEnabled)
+	{
+		m_pollTimer.start();
+	}
+}
+
+void RecursiveFileSystemWatcher::scheduleChanges()
+{
+	// not restarted by further events, so a steady stream of them still gets through
+	if (!m_coalesceTimer.isActive())
+	{
+		m_coalesceTimer.start();
+	}
 }
 
 void RecursiveFileSystemWatcher::fileChange(const QString &path)
 {
-	emit fileChanged(path);
+	m_changedFiles.insert(path);
+	scheduleChanges();
 }
 void RecursiveFileSystemWatcher::directoryChange(const QString &path)
 {
-	setFiles(scanRecursive(m_root));
+	QString relDir = m_root.relativeFilePath(path);
+	if (relDir == ".")
+	{
+		relDir = QString();
+	}
+	m_dirtyDirs.insert(relDir);
+	scheduleChanges();
+}
+
+#ifdef Q_OS_LINUX
+void RecursiveFileSystemWatcher::readInotify()
+{
+	alignas(struct inotify_event) char buffer[64 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+	while (true)
+	{
+		ssize_t length = ::read(m_inotify, buffer, sizeof(buffer));
+		if (length <= 0)
+		{
+			break;
+		}
+		for (char *ptr = buffer; ptr < buffer + length;)
+		{
+			auto event = (struct inotify_event *)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				// events were lost, only a full scan can tell what happened
+				m_fullRescan = true;
+				continue;
+			}
+			auto iter = m_watchToDir.find(event->wd);
+			if (iter == m_watchToDir.end())
+			{
+				continue;
+			}
+			const QString relDir = *iter;
+			if (event->mask & IN_IGNORED)
+			{
+				// the kernel dropped the watch, the directory is gone
+				m_dirToWatch.remove(relDir);
+				m_watchToDir.erase(iter);
+				continue;
+			}
+			if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+			{
+				m_dirtyDirs.insert(relDir);
+				continue;
+			}
+			if (event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO))
+			{
+				m_dirtyDirs.insert(relDir);
+			}
+			else if ((event->mask & fileEvents) && event->len && !(event->mask & IN_ISDIR))
+			{
+				m_changedFiles.insert(
+					m_root.absoluteFilePath(childPath(relDir, QFile::decodeName(event->name))));
+			}
+		}
+	}
+	scheduleChanges();
+}
+#endif
+
+void RecursiveFileSystemWatcher::processChanges()
+{
+	if (!m_isEnabled)
+	{
+		return;
+	}
+	if (m_fullRescan)
+	{
+		scanAll();
+	}
+	else
+	{
+		for (const QString &relDir : m_dirtyDirs)
+		{
+			scanDir(relDir, false);
+		}
+	}
+	m_dirtyDirs.clear();
+	updateFiles();
+
+	const QSet<QString> changed = m_changedFiles;
+	m_changedFiles.clear();
+	for (const QString &path : changed)
+	{
+		emit fileChanged(path);
+	}
+}
+
+void RecursiveFileSystemWatcher::poll()
+{
+	scanAll();
+	updateFiles();
+	if (!m_watchFiles)
+	{
+		return;
+	}
+	QHash<QString, QDateTime> times;
+	for (const QString &file : m_files)
+	{
+		const QString path = m_root.absoluteFilePath(file);
+		const QDateTime modified = QFileInfo(path).lastModified();
+		auto old = m_polledTimes.find(path);
+		if (old != m_polledTimes.end() && *old != modified)
+		{
+			emit fileChanged(path);
+		}
+		times.insert(path, modified);
+	}
+	m_polledTimes = times;
 }
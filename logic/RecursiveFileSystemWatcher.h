@@ -1,26 +1,46 @@
 #pragma once
 
-#include <QFileSystemWatcher>
 #include <QDir>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QRegularExpression>
 
+#include "logic/WatchHub.h"
+
+class QSocketNotifier;
+
+/**
+ * Keeps a list of the files below a directory that match an expression.
+ *
+ * On Linux, one inotify instance watches all the directories - files are covered by the watch
+ * of their directory. Elsewhere the watches come from the shared WatchHub. Changes are collected for a short
+ * while and then only the directories that changed are listed again.
+ * If the system runs out of watches, the watcher falls back to polling.
+ */
 class RecursiveFileSystemWatcher : public QObject
 {
 	Q_OBJECT
+	friend class RecursiveFileSystemWatcherTest;
 public:
 	RecursiveFileSystemWatcher(QObject *parent);
+	~RecursiveFileSystemWatcher();
 
 	void setRootDir(const QDir &root);
 	QDir rootDir() const { return m_root; }
 
-	// WARNING: setting this to true may be bad for performance
+	// WARNING: setting this to true may be bad for performance (without inotify)
 	void setWatchFiles(const bool watchFiles);
 	bool watchFiles() const { return m_watchFiles; }
 
-	void setFileExpression(const QString &exp) { m_exp = exp; }
-	QString fileExpression() const { return m_exp; }
+	void setFileExpression(const QString &exp);
+	QString fileExpression() const { return m_exp.pattern(); }
 
 	QStringList files() const { return m_files; }
 
+	/// true if the watcher gave up on watches and polls instead
+	bool isPolling() const { return m_polling; }
+
 signals:
 	void filesChanged();
 	void fileChanged(const QString &path);
@@ -30,20 +50,68 @@ public slots:
 	void disable();
 
 private:
+	struct DirEntry
+	{
+		/// matching files, relative to the root
+		QStringList files;
+		/// names of the subdirectories
+		QStringList subdirs;
+	};
+
 	QDir m_root;
 	bool m_watchFiles = false;
 	bool m_isEnabled = false;
-	QString m_exp;
+	bool m_polling = false;
+	QRegularExpression m_exp;
 
-	QFileSystemWatcher *m_watcher;
+	/// watches from the hub, by absolute path. unused with inotify
+	QHash<QString, WatchHandlePtr> m_watches;
 
 	QStringList m_files;
-	void setFiles(const QStringList &files);
+	/// every known directory, relative to the root ("" is the root)
+	QHash<QString, DirEntry> m_dirs;
+
+	/// collected changes, processed when the coalescing timer fires
+	QSet<QString> m_dirtyDirs;
+	QSet<QString> m_changedFiles;
+	bool m_fullRescan = false;
+	QTimer m_coalesceTimer;
+	QTimer m_pollTimer;
+	QHash<QString, QDateTime> m_polledTimes;
+	/// act as if the system ran out of watches past this many, -1 for no limit. for tests
+	int m_watchLimit = -1;
+
+#ifdef Q_OS_LINUX
+	int m_inotify = -1;
+	QSocketNotifier *m_notifier = nullptr;
+	QHash<int, QString> m_watchToDir;
+	QHash<QString, int> m_dirToWatch;
+#endif
+
+	QString absolutePath(const QString &relDir) const;
+	static QString childPath(const QString &relDir, const QString &name);
+
+	void scanAll();
+	/// list the directory again. new subdirectories are scanned, vanished ones forgotten
+	void scanDir(const QString &relDir, bool recursive);
+	void removeDir(const QString &relDir);
+	void updateFiles();
 
-	void addFilesToWatcherRecursive(const QDir &dir);
-	QStringList scanRecursive(const QDir &dir);
+	bool isWatched(const QString &relDir, bool known) const;
+	bool watchDir(const QString &relDir);
+	/// keeps the shared file watches in line with the listing. unused with inotify
+	void updateFileWatches(const QString &relDir, const QStringList &oldFiles);
+	void unwatchDir(const QString &relDir);
+	void unwatchAll();
+	void startPolling();
+	void scheduleChanges();
 
 private slots:
 	void fileChange(const QString &path);
 	void directoryChange(const QString &path);
+	void processChanges();
+	void poll();
+#ifdef Q_OS_LINUX
+	void readInotify();
+#endif
 };
@@ -0,0 +1,150 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "StallDetector.h"
+
+#include <QStringList>
+#include <algorithm>
+
+#include "logic/Metrics.h"
+#include "logger/QsLog.h"
+
+// how often the GUI thread beats, in milliseconds
+static const int HEARTBEAT_INTERVAL = 50;
+
+StallDetector::StallDetector(int threshold, QObject *parent)
+	: QThread(parent), m_threshold(threshold), m_lastBeat(0), m_stopping(false)
+{
+	m_clock.start();
+	m_heartbeat.setTimerType(Qt::PreciseTimer);
+	m_heartbeat.setInterval(HEARTBEAT_INTERVAL);
+	connect(&m_heartbeat, SIGNAL(timeout()), SLOT(heartbeat()));
+	m_heartbeat.start();
+}
+
+StallDetector::~StallDetector()
+{
+	stop();
+}
+
+void StallDetector::stop()
+{
+	m_stopping.store(true);
+	{
+		QMutexLocker locker(&m_sleepMutex);
+		m_sleep.wakeAll();
+	}
+	wait();
+}
+
+void StallDetector::run()
+{
+	// sample a few times per threshold, so short stalls still get a phase
+	const int poll = qMax(5, m_threshold / 4);
+	while (!m_stopping.load())
+	{
+		{
+			QMutexLocker locker(&m_sleepMutex);
+			if (m_stopping.load())
+				break;
+			m_sleep.wait(&m_sleepMutex, poll);
+		}
+		const qint64 late = m_clock.elapsed() - m_lastBeat.load() - HEARTBEAT_INTERVAL;
+		if (late < m_threshold)
+			continue;
+		const QString phase = Metrics::currentPhase();
+		QMutexLocker locker(&m_samplesMutex);
+		m_samples[phase]++;
+	}
+}
+
+void StallDetector::heartbeat()
+{
+	const qint64 now = m_clock.elapsed();
+	const qint64 previous = m_lastBeat.exchange(now);
+	const qint64 late = now - previous - HEARTBEAT_INTERVAL;
+
+	QMap<QString, int> samples;
+	{
+		QMutexLocker locker(&m_samplesMutex);
+		samples.swap(m_samples);
+	}
+	// the very first beat has nothing to compare with
+	if (previous == 0 || late < m_threshold)
+		return;
+
+	// blame the phase the watchdog saw the most
+	QString phase;
+	int seen = 0;
+	for (auto iter = samples.begin(); iter != samples.end(); ++iter)
+	{
+		if (iter.value() > seen)
+		{
+			phase = iter.key();
+			seen = iter.value();
+		}
+	}
+	if (phase.isEmpty())
+		phase = "unattributed";
+	record(late, phase);
+}
+
+void StallDetector::record(qint64 duration, const QString &phase)
+{
+	auto &registry = Metrics::Registry::instance();
+	static auto &stalls =
+		registry.histogram("gui_stall_ms", "GUI event loop stalls, in milliseconds.");
+	static auto &stallTime =
+		registry.counter("gui_stall_total_ms", "Time the GUI event loop spent stalled.");
+	stalls.observe(duration);
+	stallTime.add(duration);
+
+	{
+		QMutexLocker locker(&m_statsMutex);
+		auto &stats = m_stats[phase];
+		stats.count++;
+		stats.total += duration;
+		stats.max = qMax(stats.max, duration);
+	}
+	QLOG_WARN() << "GUI thread stalled for" << duration << "ms in" << phase;
+	emit stalled(duration, phase);
+}
+
+QMap<QString, StallDetector::PhaseStats> StallDetector::stats() const
+{
+	QMutexLocker locker(&m_statsMutex);
+	return m_stats;
+}
+
+QString StallDetector::report() const
+{
+	auto all = stats();
+	QList<QString> phases = all.keys();
+	std::sort(phases.begin(), phases.end(), [&all](const QString &a, const QString &b)
+	{ return all[a].total > all[b].total; });
+
+	QStringList lines;
+	for (auto phase : phases)
+	{
+		const auto &stats = all[phase];
+		lines.append(QString("%1: %2 stall(s), %3 ms total, %4 ms max")
+						 .arg(phase)
+						 .arg(stats.count)
+						 .arg(stats.total)
+						 .arg(stats.max));
+	}
+	return lines.join('\n');
+}
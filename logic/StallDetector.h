@@ -0,0 +1,96 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QMap>
+#include <atomic>
+
+/**
+ * Watches the GUI event loop for stalls.
+ *
+ * A timer on the GUI thread beats regularly. A watchdog thread checks the beat and, while it
+ * is late by more than the threshold, samples which phase (see Metrics::PhaseMarker) the GUI
+ * thread is in. When the loop comes back, the stall is logged with its duration and the phase
+ * it was seen in most, and added to the report.
+ *
+ * The object itself lives on the GUI thread - create it there.
+ */
+class StallDetector : public QThread
+{
+	Q_OBJECT
+public:
+	struct PhaseStats
+	{
+		int count = 0;
+		qint64 total = 0;
+		qint64 max = 0;
+	};
+
+	/// stalls longer than threshold milliseconds are recorded
+	explicit StallDetector(int threshold = 200, QObject *parent = 0);
+	virtual ~StallDetector();
+
+	int threshold() const
+	{
+		return m_threshold;
+	}
+
+	/// stop the watchdog thread and wait for it
+	void stop();
+
+	/// the stalls so far, by phase
+	QMap<QString, StallDetector::PhaseStats> stats() const;
+
+	/// the stalls so far as text, worst phase first
+	QString report() const;
+
+signals:
+	/// emitted on the GUI thread after a stall is over
+	void stalled(qint64 duration, QString phase);
+
+protected:
+	void run() override;
+
+private
+slots:
+	void heartbeat();
+
+private:
+	void record(qint64 duration, const QString &phase);
+
+	const int m_threshold;
+	QTimer m_heartbeat;
+	QElapsedTimer m_clock;
+	std::atomic<qint64> m_lastBeat;
+	std::atomic<bool> m_stopping;
+
+	// for waking the watchdog up early when stopping
+	QMutex m_sleepMutex;
+	QWaitCondition m_sleep;
+
+	// phases seen by the watchdog during the current stall
+	QMutex m_samplesMutex;
+	QMap<QString, int> m_samples;
+
+	mutable QMutex m_statsMutex;
+	QMap<QString, PhaseStats> m_stats;
+};
@@ -0,0 +1,169 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "StartupTrace.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThread>
+
+StartupTrace::Phase::Phase(StartupTrace *trace, const QString &name, const QString &category)
+	: m_trace(trace), m_name(name), m_category(category), m_start(trace->elapsed())
+{
+}
+
+StartupTrace::Phase::Phase(Phase &&other)
+	: m_trace(other.m_trace), m_name(other.m_name), m_category(other.m_category),
+	  m_start(other.m_start)
+{
+	other.m_trace = nullptr;
+}
+
+StartupTrace::Phase::~Phase()
+{
+	end();
+}
+
+void StartupTrace::Phase::end()
+{
+	if (!m_trace)
+		return;
+	m_trace->record(m_name, m_category, m_start, m_trace->elapsed() - m_start);
+	m_trace = nullptr;
+}
+
+StartupTrace::StartupTrace()
+{
+	m_timer.start();
+}
+
+StartupTrace::Phase StartupTrace::phase(const QString &name, const QString &category)
+{
+	return Phase(this, name, category);
+}
+
+void StartupTrace::mark(const QString &name, const QString &category)
+{
+	record(name, category, elapsed(), -1);
+}
+
+qint64 StartupTrace::elapsed() const
+{
+	return m_timer.nsecsElapsed() / 1000;
+}
+
+void StartupTrace::setBudget(const QString &mark, qint64 budget)
+{
+	QMutexLocker locker(&m_mutex);
+	m_budgetMark = mark;
+	m_budget = budget;
+}
+
+qint64 StartupTrace::budget() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_budget;
+}
+
+bool StartupTrace::withinBudget() const
+{
+	const qint64 now = elapsed();
+	QMutexLocker locker(&m_mutex);
+	if (m_budget < 0)
+		return true;
+	for (auto &event : m_events)
+	{
+		if (event.duration < 0 && event.name == m_budgetMark)
+			return event.start <= m_budget;
+	}
+	return now <= m_budget;
+}
+
+void StartupTrace::record(const QString &name, const QString &category, qint64 start,
+						  qint64 duration)
+{
+	Event event;
+	event.name = name;
+	event.category = category;
+	event.start = start;
+	event.duration = duration;
+	event.thread = quint64(quintptr(QThread::currentThreadId()));
+	QMutexLocker locker(&m_mutex);
+	m_events.append(event);
+}
+
+QVector<StartupTrace::Event> StartupTrace::events() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_events;
+}
+
+QByteArray StartupTrace::toChromeTrace() const
+{
+	const double pid = QCoreApplication::applicationPid();
+	QJsonArray traceEvents;
+	for (auto &event : events())
+	{
+		QJsonObject obj;
+		obj.insert("name", event.name);
+		obj.insert("cat", event.category);
+		obj.insert("ts", double(event.start));
+		obj.insert("pid", pid);
+		obj.insert("tid", double(event.thread));
+		if (event.duration < 0)
+		{
+			obj.insert("ph", QString("i"));
+			// instant events span the whole process
+			obj.insert("s", QString("p"));
+		}
+		else
+		{
+			obj.insert("ph", QString("X"));
+			obj.insert("dur", double(event.duration));
+		}
+		traceEvents.append(obj);
+	}
+	QJsonObject root;
+	root.insert("traceEvents", traceEvents);
+	root.insert("displayTimeUnit", QString("ms"));
+	const qint64 budgetTime = budget();
+	if (budgetTime >= 0)
+	{
+		QJsonObject otherData;
+		{
+			QMutexLocker locker(&m_mutex);
+			otherData.insert("budget_mark", m_budgetMark);
+		}
+		otherData.insert("budget_us", double(budgetTime));
+		otherData.insert("within_budget", withinBudget());
+		root.insert("otherData", otherData);
+	}
+	return QJsonDocument(root).toJson();
+}
+
+bool StartupTrace::write(const QString &path) const
+{
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+	const QByteArray data = toChromeTrace();
+	if (file.write(data) != data.size())
+		return false;
+	return file.commit();
+}
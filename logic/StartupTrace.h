@@ -0,0 +1,98 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QByteArray>
+
+/**
+ * Records how long the phases of startup take.
+ *
+ * Phases are timed with a Phase object that ends the phase when it goes out of scope. Everything
+ * is relative to the creation of the trace, so it should be the first thing the application
+ * creates. The result can be written in the Chrome trace event format and opened in
+ * chrome://tracing or any other viewer that understands it.
+ */
+class StartupTrace
+{
+public:
+	struct Event
+	{
+		QString name;
+		QString category;
+		// microseconds since the trace started
+		qint64 start = 0;
+		// -1 for instant events
+		qint64 duration = -1;
+		quint64 thread = 0;
+	};
+
+	class Phase
+	{
+	public:
+		Phase(StartupTrace *trace, const QString &name, const QString &category);
+		Phase(Phase &&other);
+		~Phase();
+		/// end the phase before the end of the scope
+		void end();
+
+	private:
+		Phase(const Phase &) = delete;
+		Phase &operator=(const Phase &) = delete;
+
+		StartupTrace *m_trace;
+		QString m_name;
+		QString m_category;
+		qint64 m_start;
+	};
+
+	StartupTrace();
+
+	/// start a phase. it ends when the returned object is destroyed
+	Phase phase(const QString &name, const QString &category = "startup");
+
+	/// record a point in time, like the main window becoming visible
+	void mark(const QString &name, const QString &category = "startup");
+
+	/// microseconds since the trace started
+	qint64 elapsed() const;
+
+	/// the time the mark should be reached in, in microseconds. it goes into the trace too
+	void setBudget(const QString &mark, qint64 budget);
+	qint64 budget() const;
+	/// false once the mark was reached too late, or the time ran out before it was reached
+	bool withinBudget() const;
+
+	QVector<Event> events() const;
+
+	/// the events as a Chrome trace event JSON document
+	QByteArray toChromeTrace() const;
+
+	bool write(const QString &path) const;
+
+private:
+	void record(const QString &name, const QString &category, qint64 start, qint64 duration);
+
+	QElapsedTimer m_timer;
+	mutable QMutex m_mutex;
+	QVector<Event> m_events;
+	QString m_budgetMark;
+	qint64 m_budget = -1;
+};
@@ -0,0 +1,171 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "WatchHub.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+#include "logger/QsLog.h"
+
+// changes are reported once nothing happened for this long...
+static const int debounceDelay = 250;
+// ...but not later than this after the first one
+static const int maxDelay = 1000;
+
+WatchHandle::WatchHandle(WatchHub *hub, const QString &path) : m_hub(hub), m_path(path)
+{
+}
+
+WatchHandle::~WatchHandle()
+{
+	if (m_hub)
+	{
+		m_hub->release(m_path);
+	}
+}
+
+WatchHub::WatchHub() : QObject()
+{
+	connect(&m_watcher, SIGNAL(directoryChanged(QString)), SLOT(pathChanged(QString)));
+	connect(&m_watcher, SIGNAL(fileChanged(QString)), SLOT(pathChanged(QString)));
+	m_debounceTimer.setSingleShot(true);
+	connect(&m_debounceTimer, SIGNAL(timeout()), SLOT(flush()));
+}
+
+QString WatchHub::normalize(const QString &path)
+{
+	return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+WatchHandlePtr WatchHub::watch(const QString &path)
+{
+	const QString normalized = normalize(path);
+	if (auto existing = m_handles.value(normalized).lock())
+	{
+		return existing;
+	}
+	WatchHandlePtr handle(new WatchHandle(this, normalized));
+	if (!m_watcher.addPath(normalized))
+	{
+		QLOG_WARN() << "Failed to start watching" << normalized;
+		handle->m_active = false;
+	}
+	m_handles.insert(normalized, handle);
+	return handle;
+}
+
+void WatchHub::release(const QString &path)
+{
+	// a new handle for the path may have been made already
+	if (!m_handles.value(path).expired())
+	{
+		return;
+	}
+	m_handles.remove(path);
+	m_pending.remove(path);
+	m_watcher.removePath(path);
+}
+
+WatchSuspension WatchHub::suspend(const QString &path)
+{
+	const QString normalized = normalize(path);
+	m_suspended[normalized]++;
+	QPointer<WatchHub> hub(this);
+	return WatchSuspension(nullptr, [hub, normalized](void *)
+	{
+		if (hub)
+		{
+			hub->resume(normalized);
+		}
+	});
+}
+
+void WatchHub::resume(const QString &path)
+{
+	if (--m_suspended[path] > 0)
+	{
+		return;
+	}
+	m_suspended.remove(path);
+	m_quietUntil.insert(path, QDateTime::currentMSecsSinceEpoch() + debounceDelay);
+}
+
+bool WatchHub::isQuiet(const QString &path) const
+{
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+	auto covers = [&path](const QString &root)
+	{
+		return path == root || path.startsWith(root + '/');
+	};
+	for (auto iter = m_suspended.begin(); iter != m_suspended.end(); iter++)
+	{
+		if (covers(iter.key()))
+			return true;
+	}
+	for (auto iter = m_quietUntil.begin(); iter != m_quietUntil.end(); iter++)
+	{
+		if (iter.value() > now && covers(iter.key()))
+			return true;
+	}
+	return false;
+}
+
+void WatchHub::pathChanged(const QString &path)
+{
+	if (isQuiet(path))
+	{
+		return;
+	}
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+	if (m_pending.isEmpty())
+	{
+		m_firstPending = now;
+	}
+	m_pending.insert(path);
+	// wait for things to settle, but don't let a steady stream of changes starve everyone
+	const qint64 waited = now - m_firstPending;
+	m_debounceTimer.start(qMax<qint64>(0, qMin<qint64>(debounceDelay, maxDelay - waited)));
+}
+
+void WatchHub::flush()
+{
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+	for (auto iter = m_quietUntil.begin(); iter != m_quietUntil.end();)
+	{
+		if (iter.value() <= now)
+			iter = m_quietUntil.erase(iter);
+		else
+			iter++;
+	}
+
+	const QSet<QString> pending = m_pending;
+	m_pending.clear();
+	for (const QString &path : pending)
+	{
+		// QFileSystemWatcher forgets files that were replaced - watch them again
+		if (!m_watcher.files().contains(path) && !m_watcher.directories().contains(path) &&
+			QFileInfo(path).exists())
+		{
+			m_watcher.addPath(path);
+		}
+		if (auto handle = m_handles.value(path).lock())
+		{
+			emit handle->changed(path);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QPointer>
+#include <memory>
+
+class WatchHub;
+
+/**
+ * A subscription to changes of one file or directory.
+ * Everybody watching the same path shares the same handle - the watch goes away with the
+ * last reference to it.
+ */
+class WatchHandle : public QObject
+{
+	Q_OBJECT
+	friend class WatchHub;
+
+public:
+	~WatchHandle();
+	QString path() const
+	{
+		return m_path;
+	}
+	/// false if the system refused to watch the path (out of watches...)
+	bool isActive() const
+	{
+		return m_active;
+	}
+
+signals:
+	/// the path changed. sent once per batch, no matter how many changes there were
+	void changed(const QString &path);
+
+private:
+	WatchHandle(WatchHub *hub, const QString &path);
+	QPointer<WatchHub> m_hub;
+	QString m_path;
+	bool m_active = true;
+};
+typedef std::shared_ptr<WatchHandle> WatchHandlePtr;
+
+/// while one of these exists, changes under its path are not reported
+typedef std::shared_ptr<void> WatchSuspension;
+
+/**
+ * The filesystem watches of the whole launcher, in one place.
+ *
+ * Changes are collected until things calm down for a moment and then reported once per
+ * path. Code that changes a watched folder itself (and updates its model on its own) can
+ * suspend the watch for the duration, so its own writes don't come back as rescans.
+ */
+class WatchHub : public QObject
+{
+	Q_OBJECT
+	friend class WatchHandle;
+
+public:
+	WatchHub();
+
+	/// start watching the path, or share the existing watch of it
+	WatchHandlePtr watch(const QString &path);
+
+	/// ignore changes of path and everything below it until the suspension is released
+	WatchSuspension suspend(const QString &path);
+
+private
+slots:
+	void pathChanged(const QString &path);
+	void flush();
+
+private:
+	static QString normalize(const QString &path);
+	void release(const QString &path);
+	void resume(const QString &path);
+	bool isQuiet(const QString &path) const;
+
+	QFileSystemWatcher m_watcher;
+	QHash<QString, std::weak_ptr<WatchHandle>> m_handles;
+
+	QSet<QString> m_pending;
+	qint64 m_firstPending = 0;
+	QTimer m_debounceTimer;
+
+	QHash<QString, int> m_suspended;
+	/// suspended paths stay quiet a little longer - the watcher reports late
+	QHash<QString, qint64> m_quietUntil;
+};
+
+typedef std::shared_ptr<WatchHub> WatchHubPtr;
@@ -1,23 +1,83 @@
 #include "AssetsMigrateTask.h"
 #include "MultiMC.h"
+#include "AssetsUtils.h"
 #include "logger/QsLog.h"
-#include <QJsonObject>
-#include <QJsonDocument>
+#include <QDir>
 #include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
 #include <QCryptographicHash>
-#include "gui/dialogs/CustomMessageBox.h"
-#include <QDesktopServices>
+#include <QtConcurrentMap>
 
-AssetsMigrateTask::AssetsMigrateTask(int expected, QObject *parent)
-	: Task(parent)
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// how many files are handed to the workers at once, between progress updates
+static const int CHUNK_SIZE = 256;
+
+AssetsMigrateTask::AssetsMigrateTask(const QStringList &entries, QObject *parent)
+	: Task(parent), m_entries(entries)
 {
-	this->m_expected = expected;
+}
+
+void AssetsMigrateTask::migrateItem(Item &item)
+{
+	QFile input(item.path);
+	if (!input.open(QIODevice::ReadOnly))
+	{
+		QLOG_ERROR() << "Can't read legacy asset" << item.path << ":" << input.errorString();
+		item.result = Failed;
+		return;
+	}
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if (!hash.addData(&input))
+	{
+		QLOG_ERROR() << "Can't read legacy asset" << item.path << ":" << input.errorString();
+		item.result = Failed;
+		return;
+	}
+	input.close();
+	const QString sha1sum = hash.result().toHex();
+	const QString target = "assets/objects/" + sha1sum.left(2) + "/" + sha1sum;
+
+	// the object is linked first and the original removed after, so nothing is lost if we
+	// are interrupted in between
+	bool linked = false;
+	bool exists = false;
+#ifdef Q_OS_UNIX
+	if (::link(QFile::encodeName(item.path).constData(), QFile::encodeName(target).constData()) == 0)
+		linked = true;
+	else if (errno == EEXIST)
+		exists = true;
+#else
+	exists = QFile::exists(target);
+#endif
+	if (!linked && !exists)
+	{
+		// no hardlinks here, renaming is just as good
+		linked = QFile::rename(item.path, target) || QFile::copy(item.path, target);
+		// another worker may have put the same content there in the meantime
+		exists = !linked && QFile::exists(target);
+		if (!linked && !exists)
+		{
+			QLOG_ERROR() << "Can't move legacy asset" << item.path << "to" << target;
+			item.result = Failed;
+			return;
+		}
+	}
+	if (QFile::exists(item.path) && !QFile::remove(item.path))
+	{
+		QLOG_WARN() << "Can't remove migrated legacy asset" << item.path;
+	}
+	item.result = exists ? Duplicate : Moved;
 }
 
 void AssetsMigrateTask::executeTask()
 {
-	this->setStatus(tr("Migrating legacy assets..."));
-	this->setProgress(0);
+	setStatus(tr("Looking for legacy assets..."));
+	setProgress(0);
 
 	QDir assets_dir("assets");
 	if (!assets_dir.exists())
@@ -25,119 +85,99 @@ void AssetsMigrateTask::executeTask()
 		emitFailed("Assets directory didn't exist");
 		return;
 	}
-	assets_dir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot);
-	int base_length = assets_dir.path().length();
-
-	QList<QString> blacklist = {"indexes", "objects", "virtual"};
 
-	if (!assets_dir.exists("objects"))
-		assets_dir.mkdir("objects");
-	QDir objects_dir("assets/objects");
-
-	QDirIterator iterator(assets_dir, QDirIterator::Subdirectories);
-	int successes = 0;
-	int failures = 0;
-	while (iterator.hasNext())
+	// all the object folders exist up front, so the workers don't race creating them
+	for (int i = 0; i < 256; i++)
 	{
-		QString currentDir = iterator.next();
-		currentDir = currentDir.remove(0, base_length + 1);
-
-		bool ignore = false;
-		for (QString blacklisted : blacklist)
+		const QString tlk = QString("%1").arg(i, 2, 16, QChar('0'));
+		if (!assets_dir.mkpath("objects/" + tlk))
 		{
-			if (currentDir.startsWith(blacklisted))
-				ignore = true;
+			emitFailed(tr("Couldn't create the assets object folder %1").arg(tlk));
+			return;
 		}
+	}
 
-		if (!iterator.fileInfo().isDir() && !ignore)
+	QList<Item> items;
+	for (auto entry : m_entries)
+	{
+		const QString path = assets_dir.filePath(entry);
+		if (QFileInfo(path).isFile())
 		{
-			QString filename = iterator.filePath();
-
-			QFile input(filename);
-			input.open(QIODevice::ReadOnly | QIODevice::WriteOnly);
-			QString sha1sum =
-				QCryptographicHash::hash(input.readAll(), QCryptographicHash::Sha1)
-					.toHex()
-					.constData();
-
-			QString object_name = filename.remove(0, base_length + 1);
-			QLOG_DEBUG() << "Processing" << object_name << ":" << sha1sum << input.size();
-
-			QString object_tlk = sha1sum.left(2);
-			QString object_tlk_dir = objects_dir.path() + "/" + object_tlk;
-
-			QDir tlk_dir(object_tlk_dir);
-			if (!tlk_dir.exists())
-				objects_dir.mkdir(object_tlk);
-
-			QString new_filename = tlk_dir.path() + "/" + sha1sum;
-			QFile new_object(new_filename);
-			if (!new_object.exists())
-			{
-				bool rename_success = input.rename(new_filename);
-				QLOG_DEBUG() << " Doesn't exist, copying to" << new_filename << ":"
-							 << QString::number(rename_success);
-				if (rename_success)
-					successes++;
-				else
-					failures++;
-			}
-			else
-			{
-				input.remove();
-				QLOG_DEBUG() << " Already exists, deleting original and not copying.";
-			}
-
-			this->setProgress(100 * ((successes + failures) / (float) this->m_expected));
+			Item item;
+			item.path = path;
+			item.entry = entry;
+			items.append(item);
+			continue;
+		}
+		QDirIterator iterator(path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+		while (iterator.hasNext())
+		{
+			Item item;
+			item.path = iterator.next();
+			item.entry = entry;
+			items.append(item);
 		}
 	}
 
-	if (successes + failures == 0)
+	setStatus(tr("Migrating legacy assets..."));
+	QLOG_INFO() << "Migrating" << items.size() << "legacy assets";
+	for (int done = 0; done < items.size(); done += CHUNK_SIZE)
 	{
-		this->setProgress(100);
-		QLOG_DEBUG() << "No legacy assets needed importing.";
+		const int count = qMin(CHUNK_SIZE, items.size() - done);
+		QList<Item> chunk = items.mid(done, count);
+		QtConcurrent::blockingMap(chunk, &AssetsMigrateTask::migrateItem);
+		for (int i = 0; i < count; i++)
+		{
+			items[done + i] = chunk[i];
+		}
+		setProgress(100 * (done + count) / items.size());
 	}
-	else
-	{
-		QLOG_DEBUG() << "Finished copying legacy assets:" << successes << "successes and"
-					 << failures << "failures.";
 
-		this->setStatus("Cleaning up legacy assets...");
-		this->setProgress(100);
-
-		QDirIterator cleanup_iterator(assets_dir);
-
-		while (cleanup_iterator.hasNext())
+	int moved = 0;
+	int duplicates = 0;
+	QStringList failedEntries;
+	for (auto &item : items)
+	{
+		switch (item.result)
 		{
-			QString currentDir = cleanup_iterator.next();
-			currentDir = currentDir.remove(0, base_length + 1);
-
-			bool ignore = false;
-			for (QString blacklisted : blacklist)
-			{
-				if (currentDir.startsWith(blacklisted))
-					ignore = true;
-			}
-
-			if (cleanup_iterator.fileInfo().isDir() && !ignore)
-			{
-				QString path = cleanup_iterator.filePath();
-				QDir folder(path);
-
-				QLOG_DEBUG() << "Cleaning up legacy assets folder:" << path;
+		case Moved:
+			moved++;
+			break;
+		case Duplicate:
+			duplicates++;
+			break;
+		case Failed:
+			if (!failedEntries.contains(item.entry))
+				failedEntries.append(item.entry);
+			break;
+		}
+	}
+	QLOG_INFO() << "Finished migrating legacy assets:" << moved << "moved," << duplicates
+				<< "already present," << (items.size() - moved - duplicates) << "failed";
 
-				folder.removeRecursively();
-			}
+	setStatus(tr("Cleaning up legacy assets..."));
+	setProgress(100);
+	for (auto entry : m_entries)
+	{
+		if (failedEntries.contains(entry))
+			continue;
+		QDir folder(assets_dir.filePath(entry));
+		if (folder.exists())
+		{
+			QLOG_DEBUG() << "Cleaning up legacy assets folder:" << folder.path();
+			folder.removeRecursively();
 		}
 	}
 
-	if(failures > 0)
+	if (!failedEntries.isEmpty())
 	{
-		emitFailed(QString("Failed to migrate %1 legacy assets").arg(failures));
+		// don't offer the same broken files again on every start
+		AssetsUtils::markLegacyAssets(failedEntries);
+		emitFailed(QString("Failed to migrate %1 legacy assets")
+					   .arg(items.size() - moved - duplicates));
 	}
 	else
 	{
 		emitSucceeded();
 	}
 }
-
@@ -1,18 +1,40 @@
 #pragma once
 #include "logic/tasks/Task.h"
-#include <QMessageBox>
-#include <QNetworkReply>
+#include <QStringList>
 #include <memory>
 
+/**
+ * Moves assets from the old layout into the hash named object storage.
+ *
+ * Files are hashed and linked into objects/ on a pool of worker threads. A file is only
+ * removed from its old place after it is in objects/, so an interrupted migration can simply
+ * be run again.
+ */
 class AssetsMigrateTask : public Task
 {
 	Q_OBJECT
 public:
-	explicit AssetsMigrateTask(int expected, QObject* parent=0);
+	/// entries are the top level legacy entries, as returned by AssetsUtils::findLegacyAssets
+	explicit AssetsMigrateTask(const QStringList &entries, QObject* parent=0);
 
 protected:
 	virtual void executeTask();
 
 private:
-	int m_expected;
+	enum Result
+	{
+		Moved,
+		Duplicate,
+		Failed
+	};
+	struct Item
+	{
+		QString path;
+		// the top level entry it belongs to
+		QString entry;
+		Result result = Failed;
+	};
+	static void migrateItem(Item &item);
+
+	QStringList m_entries;
 };
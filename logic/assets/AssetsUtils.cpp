@@ -14,7 +14,7 @@
  */
 
 #include <QDir>
-#include <QDirIterator>
+#include <QSaveFile>
 #include <QCryptographicHash>
 #include <QJsonParseError>
 #include <QJsonDocument>
@@ -25,39 +25,55 @@
 
 namespace AssetsUtils
 {
-int findLegacyAssets()
+// lists the top level entries that failed to migrate, one per line
+static const QString legacyMarker = ".legacy_failed";
+
+static QStringList readLegacyMarker(const QDir &assets_dir)
+{
+	QFile marker(assets_dir.filePath(legacyMarker));
+	if (!marker.open(QIODevice::ReadOnly))
+		return QStringList();
+	return QString::fromUtf8(marker.readAll()).split('\n', QString::SkipEmptyParts);
+}
+
+QStringList findLegacyAssets()
 {
 	QDir assets_dir("assets");
 	if (!assets_dir.exists())
-		return 0;
-	assets_dir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot);
-	int base_length = assets_dir.path().length();
+		return QStringList();
 
-	QList<QString> blacklist = {"indexes", "objects", "virtual"};
+	// the current layout, and the marker itself
+	QStringList known = {"indexes", "objects", "virtual", legacyMarker};
+	known += readLegacyMarker(assets_dir);
 
-	QDirIterator iterator(assets_dir, QDirIterator::Subdirectories);
-	int found = 0;
-	while (iterator.hasNext())
+	QStringList found;
+	for (auto entry : assets_dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot))
 	{
-		QString currentDir = iterator.next();
-		currentDir = currentDir.remove(0, base_length + 1);
-
-		bool ignore = false;
-		for (QString blacklisted : blacklist)
-		{
-			if (currentDir.startsWith(blacklisted))
-				ignore = true;
-		}
-
-		if (!iterator.fileInfo().isDir() && !ignore)
-		{
-			found++;
-		}
+		if (!known.contains(entry))
+			found.append(entry);
 	}
-
 	return found;
 }
 
+void markLegacyAssets(const QStringList &entries)
+{
+	QDir assets_dir("assets");
+	QStringList marked = readLegacyMarker(assets_dir);
+	for (auto entry : entries)
+	{
+		if (!marked.contains(entry))
+			marked.append(entry);
+	}
+	QSaveFile marker(assets_dir.filePath(legacyMarker));
+	if (!marker.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		QLOG_ERROR() << "Could not write" << marker.fileName() << ":" << marker.errorString();
+		return;
+	}
+	marker.write(marked.join('\n').toUtf8());
+	marker.commit();
+}
+
 /*
  * Returns true on success, with index populated
  * index is undefined otherwise
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <QString>
+#include <QStringList>
 #include <QMap>
 
 struct AssetObject
@@ -33,5 +34,16 @@ struct AssetsIndex
 namespace AssetsUtils
 {
 bool loadAssetsIndexJson(QString file, AssetsIndex* index);
-int findLegacyAssets();
+
+/**
+ * The top level entries of the assets folder that are left over from the old layout.
+ *
+ * Only the top level is listed - anything that isn't part of the current layout is legacy.
+ * Entries that failed to migrate before are remembered in a marker file and not returned
+ * again, so the migration isn't offered on every start.
+ */
+QStringList findLegacyAssets();
+
+/// remember legacy entries that could not be migrated
+void markLegacyAssets(const QStringList &entries);
 }
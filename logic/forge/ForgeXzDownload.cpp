@@ -21,6 +21,7 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QDir>
+#include "logic/Metrics.h"
 #include "logger/QsLog.h"
 
 ForgeXzDownload::ForgeXzDownload(QString relative_path, MetaEntryPtr entry) : NetAction()
@@ -193,6 +194,10 @@ const size_t buffer_size = 8196;
 
 void ForgeXzDownload::decompressAndInstall()
 {
+	static auto &installTime = Metrics::Registry::instance().histogram(
+		"forge_xz_install_ms",
+		"Time it takes to unpack and install a pack200.xz library, in milliseconds.");
+	Metrics::ScopedTimer timer(installTime);
 	// rewind the downloaded temp file
 	m_pack200_xz_file.seek(0);
 	// de-xz'd file
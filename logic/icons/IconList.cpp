@@ -14,13 +14,14 @@
  */
 
 #include "IconList.h"
+#include "LazyIconEngine.h"
 #include <pathutils.h>
 #include "logic/settings/SettingsObject.h"
 #include <QMap>
 #include <QEventLoop>
 #include <QMimeData>
 #include <QUrl>
-#include <QFileSystemWatcher>
+#include "logic/WatchHub.h"
 #include <MultiMC.h>
 #include <logic/settings/Setting.h>
 
@@ -28,7 +29,7 @@
 
 IconList::IconList(QObject *parent) : QAbstractListModel(parent)
 {
-	// add builtin icons
+	// add builtin icons. only the paths, they are decoded when they are first shown
 	QDir instance_icons(":/icons/instances/");
 	auto file_info_list = instance_icons.entryInfoList(QDir::Files, QDir::Name);
 	for (auto file_info : file_info_list)
@@ -37,11 +38,7 @@ IconList::IconList(QObject *parent) : QAbstractListModel(parent)
 		addIcon(key, key, file_info.absoluteFilePath(), MMCIcon::Builtin);
 	}
 
-	m_watcher.reset(new QFileSystemWatcher());
 	is_watching = false;
-	connect(m_watcher.get(), SIGNAL(directoryChanged(QString)),
-			SLOT(directoryChanged(QString)));
-	connect(m_watcher.get(), SIGNAL(fileChanged(QString)), SLOT(fileChanged(QString)));
 
 	auto setting = MMC->settings()->getSetting("IconsDir");
 	QString path = setting->get().toString();
@@ -107,7 +104,7 @@ void IconList::directoryChanged(const QString &path)
 		{
 			dataChanged(index(idx), index(idx));
 		}
-		m_watcher->removePath(remove);
+		m_fileWatches.remove(remove);
 		emit iconUpdated(key);
 	}
 
@@ -118,7 +115,9 @@ void IconList::directoryChanged(const QString &path)
 		QString key = addfile.baseName();
 		if (addIcon(key, QString(), addfile.filePath(), MMCIcon::FileBased))
 		{
-			m_watcher->addPath(add);
+			auto watch = MMC->watches()->watch(add);
+			connect(watch.get(), SIGNAL(changed(QString)), SLOT(fileChanged(QString)));
+			m_fileWatches.insert(add, watch);
 			emit iconUpdated(key);
 		}
 	}
@@ -134,11 +133,11 @@ void IconList::fileChanged(const QString &path)
 	int idx = getIconIndex(key);
 	if (idx == -1)
 		return;
-	QIcon icon(path);
-	if (!icon.availableSizes().size())
+	if (!LazyIconEngine::canLoad(path))
 		return;
 
-	icons[idx].m_images[MMCIcon::FileBased].icon = icon;
+	// a new icon with the new mtime, so nothing decoded from the old file is used
+	icons[idx].replace(MMCIcon::FileBased, path);
 	dataChanged(index(idx), index(idx));
 	emit iconUpdated(key);
 }
@@ -155,21 +154,20 @@ void IconList::startWatching()
 {
 	auto abs_path = m_dir.absolutePath();
 	ensureFolderPathExists(abs_path);
-	is_watching = m_watcher->addPath(abs_path);
-	if (is_watching)
-	{
-		QLOG_INFO() << "Started watching " << abs_path;
-	}
-	else
-	{
-		QLOG_INFO() << "Failed to start watching " << abs_path;
-	}
+	m_dirWatch = MMC->watches()->watch(abs_path);
+	connect(m_dirWatch.get(), SIGNAL(changed(QString)), SLOT(directoryChanged(QString)));
+	is_watching = true;
+	QLOG_INFO() << "Started watching " << abs_path;
 }
 
 void IconList::stopWatching()
 {
-	m_watcher->removePaths(m_watcher->files());
-	m_watcher->removePaths(m_watcher->directories());
+	if (m_dirWatch)
+		disconnect(m_dirWatch.get(), 0, this, 0);
+	m_dirWatch.reset();
+	for (auto watch : m_fileWatches)
+		disconnect(watch.get(), 0, this, 0);
+	m_fileWatches.clear();
 	is_watching = false;
 }
 
@@ -281,15 +279,14 @@ bool IconList::deleteIcon(QString key)
 
 bool IconList::addIcon(QString key, QString name, QString path, MMCIcon::Type type)
 {
-	// replace the icon even? is the input valid?
-	QIcon icon(path);
-	if (!icon.availableSizes().size())
+	// replace the icon even? is the input valid? (decoding is left for later)
+	if (!LazyIconEngine::canLoad(path))
 		return false;
 	auto iter = name_index.find(key);
 	if (iter != name_index.end())
 	{
 		auto &oldOne = icons[*iter];
-		oldOne.replace(type, icon, path);
+		oldOne.replace(type, path);
 		dataChanged(index(*iter), index(*iter));
 		return true;
 	}
@@ -301,7 +298,7 @@ bool IconList::addIcon(QString key, QString name, QString path, MMCIcon::Type ty
 			MMCIcon mmc_icon;
 			mmc_icon.m_name = name;
 			mmc_icon.m_key = key;
-			mmc_icon.replace(type, icon, path);
+			mmc_icon.replace(type, path);
 			icons.push_back(mmc_icon);
 			name_index[key] = icons.size() - 1;
 		}
@@ -23,8 +23,7 @@
 #include <memory>
 #include "MMCIcon.h"
 #include "logic/settings/Setting.h"
-
-class QFileSystemWatcher;
+#include "logic/WatchHub.h"
 
 class IconList : public QAbstractListModel
 {
@@ -70,7 +69,8 @@ slots:
 	void fileChanged(const QString &path);
 	void SettingChanged(const Setting & setting, QVariant value);
 private:
-	std::shared_ptr<QFileSystemWatcher> m_watcher;
+	WatchHandlePtr m_dirWatch;
+	QHash<QString, WatchHandlePtr> m_fileWatches;
 	bool is_watching;
 	QMap<QString, int> name_index;
 	QVector<MMCIcon> icons;
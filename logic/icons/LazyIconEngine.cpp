@@ -0,0 +1,189 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "LazyIconEngine.h"
+
+#include <QApplication>
+#include <QCache>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOption>
+
+#include "logger/QsLog.h"
+
+namespace
+{
+// decoded pixmaps of all lazy icons, by path, mtime, size and mode. cost in KiB.
+QCache<QString, QPixmap> g_pixmapCache(16 * 1024);
+}
+
+LazyIconEngine::LazyIconEngine(const QString &path, qint64 changed)
+	: m_path(path), m_changed(changed)
+{
+}
+
+bool LazyIconEngine::canLoad(const QString &path)
+{
+	static const QList<QByteArray> formats = QImageReader::supportedImageFormats();
+	return formats.contains(QFileInfo(path).suffix().toLower().toLatin1());
+}
+
+void LazyIconEngine::probe() const
+{
+	if (m_probed)
+		return;
+	m_probed = true;
+	QImageReader reader(m_path);
+	const int count = qMax(1, reader.imageCount());
+	for (int i = 0; i < count; i++)
+	{
+		if (i && !reader.jumpToImage(i))
+			break;
+		QSize size = reader.size();
+		// not every format knows the size without decoding
+		if (!size.isValid())
+			size = reader.read().size();
+		// keep the invalid ones too, the list index is the image number
+		m_sizes.append(size);
+	}
+	if (availableSizes().isEmpty())
+		QLOG_WARN() << "Icon" << m_path << "can't be read:" << reader.errorString();
+}
+
+QList<QSize> LazyIconEngine::availableSizes(QIcon::Mode, QIcon::State) const
+{
+	probe();
+	QList<QSize> sizes;
+	for (auto size : m_sizes)
+	{
+		if (size.isValid() && !sizes.contains(size))
+			sizes.append(size);
+	}
+	return sizes;
+}
+
+QSize LazyIconEngine::actualSize(const QSize &size, QIcon::Mode, QIcon::State)
+{
+	probe();
+	if (size.isEmpty())
+		return QSize();
+	// like the builtin engine: never scale up, scale down keeping the aspect ratio
+	QSize best(0, 0);
+	for (auto available : m_sizes)
+	{
+		if (!available.isValid())
+			continue;
+		QSize fitted = available.boundedTo(size) == available
+						   ? available
+						   : available.scaled(size, Qt::KeepAspectRatio);
+		if (fitted.width() * fitted.height() > best.width() * best.height())
+			best = fitted;
+	}
+	return best;
+}
+
+QPixmap LazyIconEngine::decode(const QSize &target) const
+{
+	QImageReader reader(m_path);
+	// pick the smallest image that is at least as big as the target, or else the biggest one
+	auto covers = [&target](const QSize &size)
+	{ return size.width() >= target.width() && size.height() >= target.height(); };
+	auto area = [](const QSize &size) { return size.width() * size.height(); };
+	int chosen = -1;
+	for (int i = 0; i < m_sizes.size(); i++)
+	{
+		const QSize &candidate = m_sizes[i];
+		if (!candidate.isValid())
+			continue;
+		if (chosen == -1)
+		{
+			chosen = i;
+			continue;
+		}
+		const QSize &best = m_sizes[chosen];
+		if (covers(candidate) ? (!covers(best) || area(candidate) < area(best))
+							  : (!covers(best) && area(candidate) > area(best)))
+			chosen = i;
+	}
+	if (chosen == -1)
+		return QPixmap();
+	if (chosen)
+		reader.jumpToImage(chosen);
+	if (m_sizes[chosen] != target)
+		reader.setScaledSize(target);
+	QImage image = reader.read();
+	if (image.isNull())
+		return QPixmap();
+	return QPixmap::fromImage(image);
+}
+
+QPixmap LazyIconEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+	const QSize target = actualSize(size, mode, state);
+	if (target.isEmpty())
+		return QPixmap();
+
+	const QString key = m_path + '|' + QString::number(m_changed) + '|' +
+						QString::number(target.width()) + 'x' + QString::number(target.height()) +
+						'|' + QString::number(mode);
+	if (QPixmap *cached = g_pixmapCache.object(key))
+		return *cached;
+
+	QPixmap result;
+	if (mode == QIcon::Normal)
+	{
+		result = decode(target);
+	}
+	else
+	{
+		// disabled and selected variants are derived from the normal one, the way QIcon does it
+		QPixmap normal = pixmap(size, QIcon::Normal, state);
+		QStyleOption opt(0);
+		opt.palette = QApplication::palette();
+		result = QApplication::style()->generatedIconPixmap(mode, normal, &opt);
+	}
+	if (result.isNull())
+		return result;
+	g_pixmapCache.insert(key, new QPixmap(result), qMax(1, result.width() * result.height() * 4 / 1024));
+	return result;
+}
+
+void LazyIconEngine::paint(QPainter *painter, const QRect &rect, QIcon::Mode mode,
+						   QIcon::State state)
+{
+	// decode at the resolution of the device, not the logical size of the rect
+	const int ratio = painter->device()->devicePixelRatio();
+	QPixmap px = pixmap(rect.size() * ratio, mode, state);
+	if (px.isNull())
+		return;
+	px.setDevicePixelRatio(ratio);
+	const QSize logical = px.size() / ratio;
+	const QPoint topLeft(rect.x() + (rect.width() - logical.width()) / 2,
+						 rect.y() + (rect.height() - logical.height()) / 2);
+	painter->drawPixmap(topLeft, px);
+}
+
+QString LazyIconEngine::key() const
+{
+	return "LazyIconEngine";
+}
+
+QIconEngine *LazyIconEngine::clone() const
+{
+	return new LazyIconEngine(*this);
+}
@@ -0,0 +1,59 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <QIconEngine>
+#include <QString>
+#include <QList>
+#include <QSize>
+
+/**
+ * An icon engine that only knows the path of its image file.
+ *
+ * Nothing is read until the icon is painted or a pixmap is requested. The file is then
+ * decoded at the requested size (in device pixels), not at its full size, and the result is
+ * kept in a cache shared by all lazy icons. The cache is bounded, so icons that are no longer
+ * shown drop out of memory again.
+ */
+class LazyIconEngine : public QIconEngine
+{
+public:
+	/// changed is the modification time of the file, so a changed file doesn't hit old pixmaps
+	LazyIconEngine(const QString &path, qint64 changed);
+
+	/// whether the file looks like something we can decode, by the extension alone
+	static bool canLoad(const QString &path);
+
+	virtual void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode,
+					   QIcon::State state) override;
+	virtual QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+	virtual QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+	virtual QList<QSize> availableSizes(QIcon::Mode mode = QIcon::Normal,
+										QIcon::State state = QIcon::Off) const override;
+	virtual QString key() const override;
+	virtual QIconEngine *clone() const override;
+
+private:
+	/// read the image sizes from the file header(s)
+	void probe() const;
+	/// decode the image that fits best into the target size, scaled to it
+	QPixmap decode(const QSize &target) const;
+
+	QString m_path;
+	qint64 m_changed;
+	mutable bool m_probed = false;
+	mutable QList<QSize> m_sizes;
+};
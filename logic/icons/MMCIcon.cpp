@@ -14,6 +14,7 @@
  */
 
 #include "MMCIcon.h"
+#include "LazyIconEngine.h"
 #include <QFileInfo>
 
 MMCIcon::Type operator--(MMCIcon::Type &t, int)
@@ -76,9 +77,10 @@ void MMCIcon::remove(Type rm_type)
 	m_current_type = Type::ToBeDeleted;
 }
 
-void MMCIcon::replace(MMCIcon::Type new_type, QIcon icon, QString path)
+void MMCIcon::replace(MMCIcon::Type new_type, QString path)
 {
 	QFileInfo foo(path);
+	QIcon icon(new LazyIconEngine(path, foo.lastModified().toMSecsSinceEpoch()));
 	if (new_type > m_current_type || m_current_type == MMCIcon::ToBeDeleted)
 	{
 		m_current_type = new_type;
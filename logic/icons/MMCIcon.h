@@ -48,5 +48,6 @@ struct MMCIcon
 	bool has(Type _type) const;
 	QIcon icon() const;
 	void remove(Type rm_type);
-	void replace(Type new_type, QIcon icon, QString path = QString());
+	/// the image is not read here, only when the icon is first painted
+	void replace(Type new_type, QString path);
 };
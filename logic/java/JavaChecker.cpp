@@ -1,5 +1,6 @@
 #include "JavaChecker.h"
 #include "MultiMC.h"
+#include "JavaCheckerCache.h"
 #include <pathutils.h>
 #include <QFile>
 #include <QProcess>
@@ -30,7 +31,7 @@ void JavaChecker::performCheck()
 			SLOT(error(QProcess::ProcessError)));
 	connect(&killTimer, SIGNAL(timeout()), SLOT(timeout()));
 	killTimer.setSingleShot(true);
-	killTimer.start(15000);
+	killTimer.start(killTimeout);
 	process->start();
 }
 
@@ -50,6 +51,7 @@ void JavaChecker::finished(int exitcode, QProcess::ExitStatus status)
 	if (status == QProcess::CrashExit || exitcode == 1)
 	{
 		QLOG_DEBUG() << "Java checker failed!";
+		MMC->javacheckercache()->update(result);
 		emit checkFinished(result);
 		return;
 	}
@@ -78,6 +80,7 @@ void JavaChecker::finished(int exitcode, QProcess::ExitStatus status)
 	if(!results.contains("os.arch") || !results.contains("java.version") || !success)
 	{
 		QLOG_DEBUG() << "Java checker failed - couldn't extract required information.";
+		MMC->javacheckercache()->update(result);
 		emit checkFinished(result);
 		return;
 	}
@@ -93,6 +96,7 @@ void JavaChecker::finished(int exitcode, QProcess::ExitStatus status)
 	result.realPlatform = os_arch;
 	result.javaVersion = java_version;
 	QLOG_DEBUG() << "Java checker succeeded.";
+	MMC->javacheckercache()->update(result);
 	emit checkFinished(result);
 }
 
@@ -108,17 +112,40 @@ void JavaChecker::error(QProcess::ProcessError err)
 			result.id = id;
 		}
 
+		MMC->javacheckercache()->update(result);
 		emit checkFinished(result);
 		return;
 	}
 }
 
+void JavaChecker::abort()
+{
+	killTimer.stop();
+	if(process)
+	{
+		QProcessPtr _process;
+		_process.swap(process);
+		_process->disconnect(this);
+		_process->kill();
+		_process->waitForFinished();
+	}
+}
+
 void JavaChecker::timeout()
 {
 	// NO MERCY. NO ABUSE.
 	if(process)
 	{
 		QLOG_DEBUG() << "Java checker has been killed by timeout.";
-		process->kill();
+		abort();
+		// reported right away, so whoever waits for it can move on. not cached, a busy
+		// system can make any JVM time out
+		JavaCheckResult result;
+		{
+			result.path = path;
+			result.id = id;
+			result.timedOut = true;
+		}
+		emit checkFinished(result);
 	}
 }
@@ -14,6 +14,8 @@ struct JavaCheckResult
 	QString javaVersion;
 	bool valid = false;
 	bool is_64bit = false;
+	/// the JVM was killed because it took too long
+	bool timedOut = false;
 	int id;
 };
 
@@ -25,9 +27,12 @@ class JavaChecker : public QObject
 public:
 	explicit JavaChecker(QObject *parent = 0);
 	void performCheck();
+	/// kill the running JVM without reporting a result
+	void abort();
 
 	QString path;
 	int id;
+	int killTimeout = 15000;
 
 signals:
 	void checkFinished(JavaCheckResult result);
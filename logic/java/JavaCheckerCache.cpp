@@ -0,0 +1,195 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JavaCheckerCache.h"
+
+#include <QFileInfo>
+#include <QFile>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "logger/QsLog.h"
+
+JavaCheckerCache::JavaCheckerCache(QString path) : QObject()
+{
+	m_index_file = path;
+	saveBatchingTimer.setSingleShot(true);
+	saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
+	connect(&saveBatchingTimer, SIGNAL(timeout()), SLOT(SaveNow()));
+}
+
+JavaCheckerCache::~JavaCheckerCache()
+{
+	if (saveBatchingTimer.isActive())
+	{
+		saveBatchingTimer.stop();
+		SaveNow();
+	}
+}
+
+bool JavaCheckerCache::stat(const QString &javaPath, Entry &entry)
+{
+	QString binary = javaPath;
+	// bare names like 'java' are looked up the same way QProcess would
+	if (!binary.contains('/') && !binary.contains('\\'))
+	{
+		binary = QStandardPaths::findExecutable(binary);
+		if (binary.isEmpty())
+			return false;
+	}
+	QFileInfo finfo(binary);
+	// canonicalFilePath follows the symlinks (alternatives and friends) to the real binary
+	QString realPath = finfo.canonicalFilePath();
+	if (realPath.isEmpty())
+		return false;
+	QFileInfo realInfo(realPath);
+	if (!realInfo.isFile())
+		return false;
+	entry.realPath = realPath;
+	entry.size = realInfo.size();
+	entry.lastModified = realInfo.lastModified().toUTC().toMSecsSinceEpoch();
+	return true;
+}
+
+bool JavaCheckerCache::known(const QString &javaPath, bool &valid) const
+{
+	auto iter = m_entries.find(javaPath);
+	if (iter == m_entries.end())
+		return false;
+	valid = iter->result.valid;
+	return true;
+}
+
+bool JavaCheckerCache::resolve(const QString &javaPath, JavaCheckResult &result)
+{
+	auto iter = m_entries.find(javaPath);
+	if (iter == m_entries.end())
+		return false;
+
+	Entry current;
+	if (!stat(javaPath, current) || current.realPath != iter->realPath ||
+		current.size != iter->size || current.lastModified != iter->lastModified)
+	{
+		QLOG_DEBUG() << "Cached java check result for" << javaPath << "is stale.";
+		m_entries.erase(iter);
+		SaveEventually();
+		return false;
+	}
+	result = iter->result;
+	return true;
+}
+
+void JavaCheckerCache::update(const JavaCheckResult &result)
+{
+	// failures are not remembered - they are often transient (timeouts, broken PATH, ...)
+	if (!result.valid)
+	{
+		if (m_entries.remove(result.path))
+			SaveEventually();
+		return;
+	}
+	Entry entry;
+	if (!stat(result.path, entry))
+		return;
+	entry.result = result;
+	m_entries[result.path] = entry;
+	SaveEventually();
+}
+
+void JavaCheckerCache::Load()
+{
+	QFile index(m_index_file);
+	if (!index.open(QIODevice::ReadOnly))
+		return;
+
+	QJsonDocument json = QJsonDocument::fromJson(index.readAll());
+	if (!json.isObject())
+		return;
+	auto root = json.object();
+	// check file version first
+	auto version_val = root.value("version");
+	if (!version_val.isString())
+		return;
+	if (version_val.toString() != "1")
+		return;
+
+	// read the entry array
+	auto entries_val = root.value("entries");
+	if (!entries_val.isArray())
+		return;
+	QJsonArray array = entries_val.toArray();
+	for (auto element : array)
+	{
+		if (!element.isObject())
+			return;
+		auto element_obj = element.toObject();
+		Entry entry;
+		entry.realPath = element_obj.value("realPath").toString();
+		entry.size = element_obj.value("size").toDouble();
+		entry.lastModified = element_obj.value("lastModified").toDouble();
+		entry.result.path = element_obj.value("path").toString();
+		entry.result.mojangPlatform = element_obj.value("mojangPlatform").toString();
+		entry.result.realPlatform = element_obj.value("realPlatform").toString();
+		entry.result.javaVersion = element_obj.value("javaVersion").toString();
+		entry.result.is_64bit = element_obj.value("is64bit").toBool();
+		entry.result.valid = true;
+		if (entry.result.path.isEmpty() || entry.realPath.isEmpty())
+			continue;
+		m_entries[entry.result.path] = entry;
+	}
+}
+
+void JavaCheckerCache::SaveEventually()
+{
+	// reset the save timer
+	saveBatchingTimer.stop();
+	saveBatchingTimer.start(5000);
+}
+
+void JavaCheckerCache::SaveNow()
+{
+	QSaveFile tfile(m_index_file);
+	if (!tfile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return;
+	QJsonObject toplevel;
+	toplevel.insert("version", QJsonValue(QString("1")));
+	QJsonArray entriesArr;
+	for (auto entry : m_entries)
+	{
+		QJsonObject entryObj;
+		entryObj.insert("path", QJsonValue(entry.result.path));
+		entryObj.insert("realPath", QJsonValue(entry.realPath));
+		entryObj.insert("size", QJsonValue(double(entry.size)));
+		entryObj.insert("lastModified", QJsonValue(double(entry.lastModified)));
+		entryObj.insert("mojangPlatform", QJsonValue(entry.result.mojangPlatform));
+		entryObj.insert("realPlatform", QJsonValue(entry.result.realPlatform));
+		entryObj.insert("javaVersion", QJsonValue(entry.result.javaVersion));
+		entryObj.insert("is64bit", QJsonValue(entry.result.is_64bit));
+		entriesArr.append(entryObj);
+	}
+	toplevel.insert("entries", entriesArr);
+	QJsonDocument doc(toplevel);
+	QByteArray jsonData = doc.toJson();
+	qint64 result = tfile.write(jsonData);
+	if (result == -1)
+		return;
+	if (result != jsonData.size())
+		return;
+	tfile.commit();
+}
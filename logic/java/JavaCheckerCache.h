@@ -0,0 +1,72 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <QString>
+#include <QMap>
+#include <QTimer>
+#include <memory>
+
+#include "JavaChecker.h"
+
+/**
+ * Remembers the results of previous java checks, so we don't have to start a JVM
+ * for every java binary every time we want to know what it is.
+ *
+ * Entries are keyed by the path the check was started with and are considered stale
+ * when the binary it resolves to (after following symlinks) changes size or mtime.
+ */
+class JavaCheckerCache : public QObject
+{
+	Q_OBJECT
+public:
+	// supply path to the cache index file
+	JavaCheckerCache(QString path);
+	~JavaCheckerCache();
+
+	// look up a fresh result for the java binary. returns false if there is none.
+	bool resolve(const QString &javaPath, JavaCheckResult &result);
+
+	// was there ever a result for the path, fresh or not? valid is set to what it said
+	bool known(const QString &javaPath, bool &valid) const;
+
+	// store the result of a finished check
+	void update(const JavaCheckResult &result);
+
+	// (re)start a timer that calls SaveNow later.
+	void SaveEventually();
+	void Load();
+public
+slots:
+	void SaveNow();
+
+private:
+	struct Entry
+	{
+		QString realPath;
+		qint64 size = 0;
+		qint64 lastModified = 0;
+		JavaCheckResult result;
+	};
+
+	// fill in the real path, size and mtime of the binary. false if it doesn't exist
+	static bool stat(const QString &javaPath, Entry &entry);
+
+	QMap<QString, Entry> m_entries;
+	QString m_index_file;
+	QTimer saveBatchingTimer;
+};
+
+typedef std::shared_ptr<JavaCheckerCache> JavaCheckerCachePtr;
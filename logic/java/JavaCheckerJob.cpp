@@ -16,9 +16,48 @@
 #include "JavaCheckerJob.h"
 #include "pathutils.h"
 #include "MultiMC.h"
+#include "JavaCheckerCache.h"
+
+#include <QFile>
+#include <QThread>
 
 #include "logger/QsLog.h"
 
+// what a JavaCheck JVM costs us, roughly. Most of it is the JVM itself.
+static const qint64 PROBE_MEMORY_MB = 128;
+
+static qint64 availableMemoryMB()
+{
+#if defined(Q_OS_LINUX)
+	QFile meminfo("/proc/meminfo");
+	if (!meminfo.open(QIODevice::ReadOnly))
+		return -1;
+	for (auto line : meminfo.readAll().split('\n'))
+	{
+		if (!line.startsWith("MemAvailable:"))
+			continue;
+		auto parts = line.simplified().split(' ');
+		if (parts.size() < 2)
+			return -1;
+		bool ok = false;
+		qint64 kb = parts[1].toLongLong(&ok);
+		return ok ? kb / 1024 : -1;
+	}
+#endif
+	return -1;
+}
+
+int JavaCheckerJob::probeLimit()
+{
+	int limit = qMax(1, QThread::idealThreadCount());
+	qint64 memory = availableMemoryMB();
+	if (memory > 0)
+	{
+		limit = qMin<qint64>(limit, memory / PROBE_MEMORY_MB);
+	}
+	return qMax(1, limit);
+}
+
 void JavaCheckerJob::partFinished(JavaCheckResult result)
 {
 	num_finished++;
@@ -27,21 +66,128 @@ void JavaCheckerJob::partFinished(JavaCheckResult result)
 	emit progress(num_finished, javacheckers.size());
 
 	javaresults.replace(result.id, result);
+	emit resultAvailable(result);
 
 	if (num_finished == javacheckers.size())
 	{
+		m_running = false;
 		emit finished(javaresults);
 	}
 }
 
+void JavaCheckerJob::probeFinished(JavaCheckResult result)
+{
+	for (int i = 0; i < m_active.size(); i++)
+	{
+		if (m_active[i].get() == sender())
+		{
+			m_active.removeAt(i);
+			break;
+		}
+	}
+	if (result.timedOut)
+	{
+		QLOG_WARN() << "Java check of" << result.path << "timed out.";
+	}
+	partFinished(result);
+	scheduleProbes();
+}
+
 void JavaCheckerJob::start()
 {
 	QLOG_INFO() << m_job_name.toLocal8Bit() << " started.";
 	m_running = true;
-	for (auto iter : javacheckers)
+	if (javacheckers.isEmpty())
+	{
+		m_running = false;
+		emit finished(javaresults);
+		return;
+	}
+	// results have to be in place first, cached ones finish right away
+	for (int i = 0; i < javacheckers.size(); i++)
 	{
 		javaresults.append(JavaCheckResult());
-		connect(iter.get(), SIGNAL(checkFinished(JavaCheckResult)), SLOT(partFinished(JavaCheckResult)));
-		iter->performCheck();
+	}
+	for (auto iter : javacheckers)
+	{
+		startChecker(iter);
+	}
+}
+
+void JavaCheckerJob::abort()
+{
+	if (!m_running)
+		return;
+	// running JVMs are killed, they and everything still queued count as failed
+	QList<JavaCheckerPtr> pending = m_active;
+	for (auto queued : m_queue)
+	{
+		pending.append(queued.second);
+	}
+	m_active.clear();
+	m_queue.clear();
+	for (auto checker : pending)
+	{
+		disconnect(checker.get(), SIGNAL(checkFinished(JavaCheckResult)), this,
+				   SLOT(probeFinished(JavaCheckResult)));
+		checker->abort();
+		JavaCheckResult result;
+		result.path = checker->path;
+		result.id = checker->id;
+		partFinished(result);
+	}
+	// the last partFinished() emitted finished and cleared m_running
+}
+
+void JavaCheckerJob::startChecker(JavaCheckerPtr checker)
+{
+	JavaCheckResult cached;
+	if (MMC->javacheckercache()->resolve(checker->path, cached))
+	{
+		QLOG_DEBUG() << "Using cached java check result for" << checker->path;
+		cached.path = checker->path;
+		cached.id = checker->id;
+		partFinished(cached);
+		return;
+	}
+	// absolute paths that aren't there fail without starting anything
+	if (checker->path.contains('/') && !QFile::exists(checker->path))
+	{
+		JavaCheckResult missing;
+		missing.path = checker->path;
+		missing.id = checker->id;
+		partFinished(missing);
+		return;
+	}
+	// stable: equal priorities keep the order they were added in
+	const int priority = probePriority(checker->path);
+	int pos = m_queue.size();
+	while (pos > 0 && m_queue[pos - 1].first > priority)
+	{
+		pos--;
+	}
+	m_queue.insert(pos, qMakePair(priority, checker));
+	scheduleProbes();
+}
+
+int JavaCheckerJob::probePriority(const QString &path)
+{
+	bool valid = false;
+	if (!MMC->javacheckercache()->known(path, valid))
+		return 1;
+	// it was replaced or updated since, but likely still a working java
+	return valid ? 0 : 2;
+}
+
+void JavaCheckerJob::scheduleProbes()
+{
+	while (m_active.size() < m_maxConcurrent && !m_queue.isEmpty())
+	{
+		auto checker = m_queue.takeFirst().second;
+		connect(checker.get(), SIGNAL(checkFinished(JavaCheckResult)),
+				SLOT(probeFinished(JavaCheckResult)));
+		checker->killTimeout = m_probeTimeout;
+		m_active.append(checker);
+		checker->performCheck();
 	}
 }
@@ -27,7 +27,9 @@ class JavaCheckerJob : public ProgressProvider
 {
 	Q_OBJECT
 public:
-	explicit JavaCheckerJob(QString job_name) : ProgressProvider(), m_job_name(job_name) {};
+	/// at most maxConcurrent JVMs are probing at the same time
+	explicit JavaCheckerJob(QString job_name, int maxConcurrent = probeLimit())
+		: ProgressProvider(), m_job_name(job_name), m_maxConcurrent(maxConcurrent) {};
 
 	bool addJavaCheckerAction(JavaCheckerPtr base)
 	{
@@ -37,9 +39,8 @@ public:
 		if (isRunning())
 		{
 			emit progress(current_progress, total_progress);
-			connect(base.get(), SIGNAL(checkFinished(JavaCheckResult)), SLOT(partFinished(JavaCheckResult)));
-
-			base->performCheck();
+			javaresults.append(JavaCheckResult());
+			startChecker(base);
 		}
 		return true;
 	}
@@ -64,25 +65,43 @@ public:
 		return m_running;
 	}
 
+	/// Concurrency limit derived from the core count and the available memory.
+	static int probeLimit();
+
 signals:
 	void started();
 	void progress(int current, int total);
+	/// emitted for every single result as soon as it is known
+	void resultAvailable(JavaCheckResult result);
 	void finished(QList<JavaCheckResult>);
 public
 slots:
 	virtual void start();
-	// FIXME: implement
-	virtual void abort() {};
+	virtual void abort();
 private
 slots:
+	void probeFinished(JavaCheckResult result);
+
+private:
+	/// use a cached result if there is a fresh one, queue up a JVM probe otherwise
+	void startChecker(JavaCheckerPtr checker);
+	/// lower goes first: what worked before, then what's new, then what failed before
+	static int probePriority(const QString &path);
+	/// start queued probes until the concurrency limit is reached
+	void scheduleProbes();
 	void partFinished(JavaCheckResult result);
 
 private:
 	QString m_job_name;
 	QList<JavaCheckerPtr> javacheckers;
 	QList<JavaCheckResult> javaresults;
+	/// sorted by probePriority()
+	QList<QPair<int, JavaCheckerPtr>> m_queue;
+	QList<JavaCheckerPtr> m_active;
 	qint64 current_progress = 0;
 	qint64 total_progress = 0;
 	int num_finished = 0;
+	const int m_maxConcurrent;
+	const int m_probeTimeout = 10000;
 	bool m_running = false;
 };
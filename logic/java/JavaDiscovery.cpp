@@ -0,0 +1,229 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JavaDiscovery.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QSet>
+#include <QCryptographicHash>
+#include <QtConcurrentMap>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include <pathutils.h>
+#include "logger/QsLog.h"
+
+JavaDiscovery::JavaDiscovery(QString path)
+{
+	m_index_file = path;
+}
+
+void JavaDiscovery::addRoot(QString root)
+{
+	if (!m_roots.contains(root))
+		m_roots.append(root);
+}
+
+void JavaDiscovery::addDefaultRoots()
+{
+	// distribution packages
+	addRoot("/usr/lib/jvm");
+	addRoot("/usr/lib64/jvm");
+	addRoot("/usr/lib32/jvm");
+	addRoot("/usr/java");
+	// manual installs
+	addRoot("/opt");
+	addRoot("/opt/java");
+	addRoot("/opt/jdk");
+	// version managers and IDEs
+	QString home = QDir::homePath();
+	addRoot(PathCombine(home, ".sdkman/candidates/java"));
+	addRoot(PathCombine(home, ".asdf/installs/java"));
+	addRoot(PathCombine(home, ".jabba/jdk"));
+	addRoot(PathCombine(home, ".jdks"));
+}
+
+qint64 JavaDiscovery::modificationTime(const QString &path)
+{
+	QFileInfo finfo(path);
+	if (!finfo.exists())
+		return 0;
+	return finfo.lastModified().toUTC().toMSecsSinceEpoch();
+}
+
+QString JavaDiscovery::installBinary(const QString &install)
+{
+	// the layouts of JDKs and JREs. old JDKs also bundle a JRE, which is the same java again
+	static const QStringList binaries = {"bin/java", "jre/bin/java"};
+	for (auto binary : binaries)
+	{
+		QFileInfo java(PathCombine(install, binary));
+		if (java.isFile() && java.isExecutable())
+			return java.absoluteFilePath();
+	}
+	return QString();
+}
+
+QString JavaDiscovery::rootStamp(const QString &root)
+{
+	if (!QFileInfo(root).isDir())
+		return QString();
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(QByteArray::number(modificationTime(root)));
+	QDir rootDir(root);
+	for (auto install : rootDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+	{
+		const QString installPath = PathCombine(root, install);
+		hash.addData(install.toUtf8());
+		hash.addData(QByteArray::number(modificationTime(installPath)));
+		hash.addData(QByteArray::number(modificationTime(PathCombine(installPath, "bin/java"))));
+		hash.addData(
+			QByteArray::number(modificationTime(PathCombine(installPath, "jre/bin/java"))));
+	}
+	return hash.result().toHex();
+}
+
+JavaDiscovery::RootEntry JavaDiscovery::scanRoot(const QString &root)
+{
+	RootEntry entry;
+	entry.root = root;
+	entry.stamp = rootStamp(root);
+	if (entry.stamp.isEmpty())
+		return entry;
+
+	QDir rootDir(root);
+	for (auto install : rootDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+	{
+		QString java = installBinary(PathCombine(root, install));
+		if (!java.isEmpty())
+		{
+			entry.javas.append(java);
+		}
+	}
+	return entry;
+}
+
+QStringList JavaDiscovery::discover()
+{
+	load();
+
+	QStringList stale;
+	for (auto root : m_roots)
+	{
+		auto iter = m_inventory.find(root);
+		if (iter == m_inventory.end() || iter->stamp != rootStamp(root))
+		{
+			stale.append(root);
+		}
+	}
+
+	if (!stale.isEmpty())
+	{
+		QLOG_INFO() << "Scanning for java installations in" << stale.join(", ");
+		QList<RootEntry> scanned = QtConcurrent::blockingMapped<QList<RootEntry>>(stale, &JavaDiscovery::scanRoot);
+		for (auto entry : scanned)
+		{
+			m_inventory[entry.root] = entry;
+		}
+		save();
+	}
+
+	// alternatives, SDKMAN's 'current' and friends are symlinks. only keep the first path
+	// that leads to each actual binary.
+	QStringList javas;
+	QSet<QString> seen;
+	for (auto root : m_roots)
+	{
+		for (auto java : m_inventory[root].javas)
+		{
+			QString realPath = QFileInfo(java).canonicalFilePath();
+			if (realPath.isEmpty() || seen.contains(realPath))
+				continue;
+			seen.insert(realPath);
+			javas.append(java);
+		}
+	}
+	return javas;
+}
+
+void JavaDiscovery::load()
+{
+	if (!m_inventory.isEmpty())
+		return;
+
+	QFile index(m_index_file);
+	if (!index.open(QIODevice::ReadOnly))
+		return;
+
+	QJsonDocument json = QJsonDocument::fromJson(index.readAll());
+	if (!json.isObject())
+		return;
+	auto root = json.object();
+	// check file version first
+	auto version_val = root.value("version");
+	if (!version_val.isString())
+		return;
+	if (version_val.toString() != "2")
+		return;
+
+	auto roots_val = root.value("roots");
+	if (!roots_val.isArray())
+		return;
+	for (auto element : roots_val.toArray())
+	{
+		if (!element.isObject())
+			return;
+		auto element_obj = element.toObject();
+		RootEntry entry;
+		entry.root = element_obj.value("root").toString();
+		entry.stamp = element_obj.value("stamp").toString();
+		for (auto java : element_obj.value("javas").toArray())
+		{
+			entry.javas.append(java.toString());
+		}
+		m_inventory[entry.root] = entry;
+	}
+}
+
+void JavaDiscovery::save()
+{
+	QSaveFile tfile(m_index_file);
+	if (!tfile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return;
+	QJsonObject toplevel;
+	toplevel.insert("version", QJsonValue(QString("2")));
+	QJsonArray rootsArr;
+	for (auto entry : m_inventory)
+	{
+		QJsonObject entryObj;
+		entryObj.insert("root", QJsonValue(entry.root));
+		entryObj.insert("stamp", QJsonValue(entry.stamp));
+		entryObj.insert("javas", QJsonArray::fromStringList(entry.javas));
+		rootsArr.append(entryObj);
+	}
+	toplevel.insert("roots", rootsArr);
+	QByteArray jsonData = QJsonDocument(toplevel).toJson();
+	qint64 result = tfile.write(jsonData);
+	if (result == -1)
+		return;
+	if (result != jsonData.size())
+		return;
+	tfile.commit();
+}
@@ -0,0 +1,65 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QMap>
+
+/**
+ * Finds java installations by looking through the folders they are usually installed into.
+ *
+ * Every root is scanned on its own thread. The result of each scan is kept in an index file
+ * together with a stamp of the root: the mtimes of the root, of every install folder in it
+ * and of their java binaries. Roots with the same stamp aren't scanned again, but updating a
+ * java inside an existing install folder is noticed.
+ */
+class JavaDiscovery
+{
+public:
+	// supply path to the inventory index file
+	JavaDiscovery(QString path);
+
+	/// add a folder that contains java installations (one per subfolder)
+	void addRoot(QString root);
+
+	/// add the usual java install roots for this system
+	void addDefaultRoots();
+
+	/// scan the roots (or use the inventory) and return java binaries, unique by real path
+	QStringList discover();
+
+private:
+	struct RootEntry
+	{
+		QString root;
+		QString stamp;
+		QStringList javas;
+	};
+
+	static RootEntry scanRoot(const QString &root);
+	/// the java binary of an install folder, empty if there is none
+	static QString installBinary(const QString &install);
+	/// changes whenever an install is added, removed or updated. empty if the root is missing
+	static QString rootStamp(const QString &root);
+	static qint64 modificationTime(const QString &path);
+
+	void load();
+	void save();
+
+	QStringList m_roots;
+	QMap<QString, RootEntry> m_inventory;
+	QString m_index_file;
+};
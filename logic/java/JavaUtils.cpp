@@ -17,6 +17,9 @@
 #include <QString>
 #include <QDir>
 #include <QStringList>
+#include <QFileInfo>
+#include <QSet>
+#include <QStandardPaths>
 
 #include <logic/settings/Setting.h>
 #include <pathutils.h>
@@ -27,6 +30,7 @@
 #include "logic/java/JavaUtils.h"
 #include "logic/java/JavaCheckerJob.h"
 #include "logic/java/JavaVersionList.h"
+#include "logic/java/JavaDiscovery.h"
 
 JavaUtils::JavaUtils()
 {
@@ -199,12 +203,29 @@ QList<QString> JavaUtils::FindJavaPaths()
 #elif LINUX
 QList<QString> JavaUtils::FindJavaPaths()
 {
-	QLOG_INFO() << "Linux Java detection incomplete - defaulting to \"java\"";
-
 	QList<QString> javas;
 	javas.append(this->GetDefaultJava()->path);
-    javas.append("/opt/java/bin/java");
-    javas.append("/usr/bin/java");
+	javas.append("/opt/java/bin/java");
+	javas.append("/usr/bin/java");
+
+	// /usr/bin/java usually leads into /usr/lib/jvm through the alternatives system
+	QSet<QString> realPaths;
+	for (auto java : javas)
+	{
+		QString binary = java.contains('/') ? java : QStandardPaths::findExecutable(java);
+		realPaths.insert(QFileInfo(binary).canonicalFilePath());
+	}
+
+	JavaDiscovery discovery("javadiscovery.json");
+	discovery.addDefaultRoots();
+	for (auto java : discovery.discover())
+	{
+		QString realPath = QFileInfo(java).canonicalFilePath();
+		if (realPaths.contains(realPath))
+			continue;
+		realPaths.insert(realPath);
+		javas.append(java);
+	}
 
 	return javas;
 }
@@ -155,6 +155,20 @@ void JavaVersionList::updateListData(QList<BaseVersionPtr> versions)
 	// sort();
 }
 
+void JavaVersionList::appendVersion(BaseVersionPtr version)
+{
+	beginInsertRows(QModelIndex(), m_vlist.size(), m_vlist.size());
+	m_vlist.append(version);
+	endInsertRows();
+}
+
+void JavaVersionList::clearVersions()
+{
+	beginResetModel();
+	m_vlist.clear();
+	endResetModel();
+}
+
 void JavaVersionList::sort()
 {
 	// NO-OP for now
@@ -179,8 +193,12 @@ void JavaListLoadTask::executeTask()
 
 	m_job = std::shared_ptr<JavaCheckerJob>(new JavaCheckerJob("Java detection"));
 	connect(m_job.get(), SIGNAL(finished(QList<JavaCheckResult>)), this, SLOT(javaCheckerFinished(QList<JavaCheckResult>)));
+	connect(m_job.get(), SIGNAL(resultAvailable(JavaCheckResult)), this, SLOT(javaCheckerResult(JavaCheckResult)));
 	connect(m_job.get(), SIGNAL(progress(int, int)), this, SLOT(checkerProgress(int, int)));
 
+	// valid results are shown as they come in, the final list replaces them in order
+	m_list->clearVersions();
+
 	QLOG_DEBUG() << "Probing the following Java paths: ";
 	int id = 0;
 	for(QString candidate : candidate_paths)
@@ -204,6 +222,15 @@ void JavaListLoadTask::checkerProgress(int current, int total)
 	this->setProgress((int) progress);
 }
 
+void JavaListLoadTask::javaCheckerResult(JavaCheckResult result)
+{
+	if(!result.valid)
+		return;
+
+	setStatus(tr("Found Java %1 (%2)").arg(result.javaVersion, result.path));
+	m_list->appendVersion(JavaUtils().MakeJavaPtr(result.path, result.javaVersion, result.mojangPlatform));
+}
+
 void JavaListLoadTask::javaCheckerFinished(QList<JavaCheckResult> results)
 {
 	QList<JavaVersionPtr> candidates;
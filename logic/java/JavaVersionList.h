@@ -70,6 +70,12 @@ public
 slots:
 	virtual void updateListData(QList<BaseVersionPtr> versions);
 
+	/// add a single version while the list is still loading
+	void appendVersion(BaseVersionPtr version);
+
+	/// drop the current contents, without marking the list as loaded
+	void clearVersions();
+
 protected:
 	QList<BaseVersionPtr> m_vlist;
 
@@ -87,6 +93,7 @@ public:
 	virtual void executeTask();
 public slots:
 	void javaCheckerFinished(QList<JavaCheckResult> results);
+	void javaCheckerResult(JavaCheckResult result);
 	void checkerProgress(int current, int total);
 
 protected:
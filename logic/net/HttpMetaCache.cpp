@@ -25,6 +25,7 @@
 #include <QCryptographicHash>
 
 #include "logger/QsLog.h"
+#include "logic/Metrics.h"
 
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -45,8 +46,12 @@ HttpMetaCache::HttpMetaCache(QString path) : QObject()
 
 HttpMetaCache::~HttpMetaCache()
 {
-	saveBatchingTimer.stop();
-	SaveNow();
+	// only write the index if something changed since it was last saved
+	if (saveBatchingTimer.isActive())
+	{
+		saveBatchingTimer.stop();
+		SaveNow();
+	}
 }
 
 MetaEntryPtr HttpMetaCache::getEntry(QString base, QString resource_path)
@@ -68,10 +73,19 @@ MetaEntryPtr HttpMetaCache::getEntry(QString base, QString resource_path)
 MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path,
 										 QString expected_etag)
 {
+	auto &registry = Metrics::Registry::instance();
+	static auto &hits = registry.counter("metacache_hits_total",
+										 "Cache entries that were present and up to date.");
+	static auto &misses =
+		registry.counter("metacache_misses_total", "Cache entries that were not present.");
+	static auto &stale = registry.counter(
+		"metacache_stale_total", "Cache entries that were present but missing, changed or outdated.");
+
 	auto entry = getEntry(base, resource_path);
 	// it's not present? generate a default stale entry
 	if (!entry)
 	{
+		misses.add();
 		return staleEntry(base, resource_path);
 	}
 
@@ -84,6 +98,8 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path,
 	{
 		// if the file doesn't exist, we disown the entry
 		selected_base.entry_list.remove(resource_path);
+		SaveEventually();
+		stale.add();
 		return staleEntry(base, resource_path);
 	}
 
@@ -91,6 +107,8 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path,
 	{
 		// if the etag doesn't match expected, we disown the entry
 		selected_base.entry_list.remove(resource_path);
+		SaveEventually();
+		stale.add();
 		return staleEntry(base, resource_path);
 	}
 
@@ -106,6 +124,8 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path,
 		if (entry->md5sum != md5sum)
 		{
 			selected_base.entry_list.remove(resource_path);
+			SaveEventually();
+			stale.add();
 			return staleEntry(base, resource_path);
 		}
 		// md5sums matched... keep entry and save the new state to file
@@ -114,6 +134,7 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path,
 	}
 
 	// entry passed all the checks we cared about.
+	hits.add();
 	return entry;
 }
 
@@ -121,13 +142,13 @@ bool HttpMetaCache::updateEntry(MetaEntryPtr stale_entry)
 {
 	if (!m_entries.contains(stale_entry->base))
 	{
-		QLOG_ERROR() << "Cannot add entry with unknown base: "
+		QCLOG_ERROR(Net) << "Cannot add entry with unknown base: "
 					 << stale_entry->base.toLocal8Bit();
 		return false;
 	}
 	if (stale_entry->stale)
 	{
-		QLOG_ERROR() << "Cannot add stale entry: " << stale_entry->getFullPath().toLocal8Bit();
+		QCLOG_ERROR(Net) << "Cannot add stale entry: " << stale_entry->getFullPath().toLocal8Bit();
 		return false;
 	}
 	m_entries[stale_entry->base].entry_list[stale_entry->path] = stale_entry;
@@ -45,7 +45,7 @@ void MD5EtagDownload::start()
 			// skip if they match
 			if(m_local_md5 == m_expected_md5)
 			{
-				QLOG_INFO() << "Skipping " << m_url.toString() << ": md5 match.";
+				QCLOG_INFO(Net) << "Skipping " << m_url.toString() << ": md5 match.";
 				emit succeeded(m_index_within_job);
 				return;
 			}
@@ -63,15 +63,15 @@ void MD5EtagDownload::start()
 
 	QNetworkRequest request(m_url);
 
-	QLOG_INFO() << "Downloading " << m_url.toString() << " got " << m_local_md5;
+	QCLOG_INFO(Net) << "Downloading " << m_url.toString() << " got " << m_local_md5;
 
 	if(!m_local_md5.isEmpty())
 	{
-		QLOG_INFO() << "Got " << m_local_md5;
+		QCLOG_INFO(Net) << "Got " << m_local_md5;
 		request.setRawHeader(QString("If-None-Match").toLatin1(), m_local_md5.toLatin1());
 	}
 	if(!m_expected_md5.isEmpty())
-		QLOG_INFO() << "Expecting " << m_expected_md5;
+		QCLOG_INFO(Net) << "Expecting " << m_expected_md5;
 
 	request.setHeader(QNetworkRequest::UserAgentHeader, "MultiMC/5.0 (Uncached)");
 
@@ -121,7 +121,7 @@ void MD5EtagDownload::downloadFinished()
 
 		// FIXME: compare with the real written data md5sum
 		// this is just an ETag
-		QLOG_INFO() << "Finished " << m_url.toString() << " got " << m_reply->rawHeader("ETag").constData();
+		QCLOG_INFO(Net) << "Finished " << m_url.toString() << " got " << m_reply->rawHeader("ETag").constData();
 
 		m_reply.reset();
 		emit succeeded(m_index_within_job);
@@ -19,6 +19,7 @@
 #include "MD5EtagDownload.h"
 #include "ByteArrayDownload.h"
 #include "CacheDownload.h"
+#include "logic/Metrics.h"
 
 #include "logger/QsLog.h"
 
@@ -29,19 +30,20 @@ void NetJob::partSucceeded(int index)
 	partProgress(index, slot.total_progress, slot.total_progress);
 
 	num_succeeded++;
-	QLOG_INFO() << m_job_name.toLocal8Bit() << "progress:" << num_succeeded << "/"
+	QCLOG_INFO(Net) << m_job_name.toLocal8Bit() << "progress:" << num_succeeded << "/"
 				<< downloads.size();
 
 	if (num_failed + num_succeeded == downloads.size())
 	{
+		reportMetrics(!num_failed);
 		if (num_failed)
 		{
-			QLOG_ERROR() << m_job_name.toLocal8Bit() << "failed.";
+			QCLOG_ERROR(Net) << m_job_name.toLocal8Bit() << "failed.";
 			emit failed();
 		}
 		else
 		{
-			QLOG_INFO() << m_job_name.toLocal8Bit() << "succeeded.";
+			QCLOG_INFO(Net) << m_job_name.toLocal8Bit() << "succeeded.";
 			emit succeeded();
 		}
 	}
@@ -52,17 +54,18 @@ void NetJob::partFailed(int index)
 	auto &slot = parts_progress[index];
 	if (slot.failures == 3)
 	{
-		QLOG_ERROR() << "Part" << index << "failed 3 times (" << downloads[index]->m_url << ")";
+		QCLOG_ERROR(Net) << "Part" << index << "failed 3 times (" << downloads[index]->m_url << ")";
 		num_failed++;
 		if (num_failed + num_succeeded == downloads.size())
 		{
-			QLOG_ERROR() << m_job_name.toLocal8Bit() << "failed.";
+			reportMetrics(false);
+			QCLOG_ERROR(Net) << m_job_name.toLocal8Bit() << "failed.";
 			emit failed();
 		}
 	}
 	else
 	{
-		QLOG_ERROR() << "Part" << index << "failed, restarting (" << downloads[index]->m_url
+		QCLOG_ERROR(Net) << "Part" << index << "failed, restarting (" << downloads[index]->m_url
 					 << ")";
 		// restart the job
 		slot.failures++;
@@ -86,8 +89,9 @@ void NetJob::partProgress(int index, qint64 bytesReceived, qint64 bytesTotal)
 
 void NetJob::start()
 {
-	QLOG_INFO() << m_job_name.toLocal8Bit() << " started.";
+	QCLOG_INFO(Net) << m_job_name.toLocal8Bit() << " started.";
 	m_running = true;
+	m_timer.start();
 	for (auto iter : downloads)
 	{
 		connect(iter.get(), SIGNAL(succeeded(int)), SLOT(partSucceeded(int)));
@@ -98,6 +102,26 @@ void NetJob::start()
 	}
 }
 
+void NetJob::reportMetrics(bool succeeded)
+{
+	auto &registry = Metrics::Registry::instance();
+	static auto &bytes = registry.histogram("netjob_bytes", "Bytes received per network job.",
+											Metrics::Registry::sizeBuckets());
+	static auto &duration =
+		registry.histogram("netjob_duration_ms", "How long network jobs take, in milliseconds.");
+	static auto &received =
+		registry.counter("net_received_bytes_total", "Bytes received by all network jobs.");
+	static auto &jobs = registry.counter("netjobs_total", "Finished network jobs.");
+	static auto &failedJobs = registry.counter("netjobs_failed_total", "Failed network jobs.");
+	bytes.observe(current_progress);
+	received.add(current_progress);
+	if (m_timer.isValid())
+		duration.observe(m_timer.elapsed());
+	jobs.add();
+	if (!succeeded)
+		failedJobs.add();
+}
+
 QStringList NetJob::getFailedFiles()
 {
 	QStringList failed;
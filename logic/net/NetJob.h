@@ -16,6 +16,7 @@
 #pragma once
 #include <QtNetwork>
 #include <QLabel>
+#include <QElapsedTimer>
 #include "NetAction.h"
 #include "ByteArrayDownload.h"
 #include "MD5EtagDownload.h"
@@ -98,6 +99,9 @@ slots:
 	void partFailed(int index);
 
 private:
+	/// report the size and duration of the finished job to the metrics registry
+	void reportMetrics(bool succeeded);
+
 	struct part_info
 	{
 		qint64 current_progress = 0;
@@ -112,4 +116,5 @@ private:
 	int num_succeeded = 0;
 	int num_failed = 0;
 	bool m_running = false;
+	QElapsedTimer m_timer;
 };
@@ -35,7 +35,7 @@ void PasteUpload::executeTask()
 void PasteUpload::downloadError(QNetworkReply::NetworkError error)
 {
 	// error happened during download.
-	QLOG_ERROR() << "Network error: " << error;
+	QCLOG_ERROR(Net) << "Network error: " << error;
 	emitFailed(m_reply->errorString());
 }
 
@@ -75,7 +75,7 @@ bool PasteUpload::parseResult(QJsonDocument doc)
 	auto status = object.value("status").toString("error");
 	if (status == "error")
 	{
-		QLOG_ERROR() << "paste.ee reported error:" << QString(object.value("error").toString());
+		QCLOG_ERROR(Net) << "paste.ee reported error:" << QString(object.value("error").toString());
 		return false;
 	}
 	m_pasteLink = object.value("paste").toObject().value("link").toString();
@@ -0,0 +1,141 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ThumbnailCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QPainter>
+#include <QSaveFile>
+#include <QUrl>
+
+#include <pathutils.h>
+#include "logic/Metrics.h"
+
+ThumbnailCache::ThumbnailCache(const QString &root, int size) : m_size(size)
+{
+	m_root = PathCombine(root, QString::number(size));
+}
+
+QString ThumbnailCache::thumbnailPath(const QString &path) const
+{
+	QByteArray uri = QUrl::fromLocalFile(QFileInfo(path).absoluteFilePath()).toEncoded();
+	QString hash = QCryptographicHash::hash(uri, QCryptographicHash::Md5).toHex();
+	return PathCombine(m_root, hash + ".png");
+}
+
+QImage ThumbnailCache::load(const QString &path) const
+{
+	QFileInfo source(path);
+	if (!source.isFile())
+		return QImage();
+
+	QImageReader reader(thumbnailPath(path), "png");
+	// the text chunks come before the pixels, no need to decode anything to check them
+	if (reader.text("Thumb::MTime") != QString::number(source.lastModified().toTime_t()) ||
+		reader.text("Thumb::Size") != QString::number(source.size()))
+	{
+		return QImage();
+	}
+	return reader.read();
+}
+
+bool ThumbnailCache::store(const QString &path, const QImage &thumbnail) const
+{
+	QFileInfo source(path);
+	if (!source.isFile() || thumbnail.isNull())
+		return false;
+	if (!ensureFolderPathExists(m_root))
+		return false;
+
+	QImage out = thumbnail;
+	out.setText("Thumb::URI", QUrl::fromLocalFile(source.absoluteFilePath()).toString());
+	out.setText("Thumb::MTime", QString::number(source.lastModified().toTime_t()));
+	out.setText("Thumb::Size", QString::number(source.size()));
+
+	// other threads (and other instances of MultiMC) may be reading it
+	QSaveFile file(thumbnailPath(path));
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	if (!out.save(&file, "png"))
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+void ThumbnailCache::remove(const QString &path) const
+{
+	QFile::remove(thumbnailPath(path));
+}
+
+QImage ThumbnailCache::get(const QString &path) const
+{
+	auto &registry = Metrics::Registry::instance();
+	static auto &hits =
+		registry.counter("thumbnail_disk_hits_total", "Thumbnails loaded from the disk cache.");
+	static auto &generated =
+		registry.counter("thumbnail_generated_total", "Thumbnails generated from the image.");
+	static auto &generateTime = registry.histogram(
+		"thumbnail_generate_ms", "Time it takes to generate a thumbnail, in milliseconds.");
+
+	QImage thumbnail = load(path);
+	if (!thumbnail.isNull())
+	{
+		hits.add();
+		return thumbnail;
+	}
+	{
+		Metrics::ScopedTimer timer(generateTime);
+		thumbnail = generate(path, m_size);
+	}
+	generated.add();
+	if (!thumbnail.isNull())
+		store(path, thumbnail);
+	return thumbnail;
+}
+
+QImage ThumbnailCache::generate(const QString &path, int size)
+{
+	QImageReader reader(path);
+	QSize original = reader.size();
+	QImage image;
+	if (original.isValid())
+	{
+		reader.setScaledSize(original.scaled(size, size, Qt::KeepAspectRatio));
+		image = reader.read();
+	}
+	else
+	{
+		// the format can't tell the size up front
+		image = reader.read();
+		if (!image.isNull())
+			image = image.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	}
+	if (image.isNull())
+		return QImage();
+
+	QImage square(QSize(size, size), QImage::Format_ARGB32);
+	square.fill(Qt::transparent);
+	QPainter painter(&square);
+	painter.drawImage(QPoint((size - image.width()) / 2, (size - image.height()) / 2), image);
+	painter.end();
+	return square;
+}
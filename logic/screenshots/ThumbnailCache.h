@@ -0,0 +1,69 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QString>
+#include <QImage>
+#include <memory>
+
+/**
+ * Thumbnails of images, kept on disk between runs.
+ *
+ * Laid out like the freedesktop.org thumbnail cache: one PNG per image, named after the MD5
+ * of the image's file URI, in a folder per thumbnail size. The source's mtime and size are
+ * stored as text chunks in the PNG (Thumb::MTime, Thumb::Size) and checked when loading, so
+ * an edited or replaced image never gets an old thumbnail. Reading them doesn't decode the
+ * thumbnail's pixels.
+ *
+ * There's no state besides the folder, all the methods can be used from any thread.
+ */
+class ThumbnailCache
+{
+public:
+	ThumbnailCache(const QString &root, int size = 256);
+
+	int size() const
+	{
+		return m_size;
+	}
+
+	/// the cached thumbnail of the image, null if there is none or it is out of date
+	QImage load(const QString &path) const;
+
+	/// store a thumbnail of the image. false if it couldn't be written.
+	bool store(const QString &path, const QImage &thumbnail) const;
+
+	/// drop the thumbnail of the image
+	void remove(const QString &path) const;
+
+	/// load the thumbnail, making and storing it first if needed. null if the image can't be read.
+	QImage get(const QString &path) const;
+
+	/**
+	 * Decode the image at a reduced size, centered on a transparent square of the given size.
+	 * The downscaling happens while decoding where the image format supports it.
+	 */
+	static QImage generate(const QString &path, int size);
+
+private:
+	QString thumbnailPath(const QString &path) const;
+
+	QString m_root;
+	int m_size;
+};
+
+typedef std::shared_ptr<ThumbnailCache> ThumbnailCachePtr;
@@ -16,8 +16,9 @@
 #include "logic/settings/INIFile.h"
 
 #include <QFile>
-#include <QTextStream>
-#include <QStringList>
+#include <QSaveFile>
+#include <climits>
+#include <cstring>
 
 INIFile::INIFile()
 {
@@ -72,20 +73,27 @@ QString INIFile::escape(QString orig)
 
 bool INIFile::saveFile(QString fileName)
 {
-	// TODO Handle errors.
-	QFile file(fileName);
-	file.open(QIODevice::WriteOnly);
-	QTextStream out(&file);
-	out.setCodec("UTF-8");
-
+	QByteArray outArray;
 	for (Iterator iter = begin(); iter != end(); iter++)
 	{
 		QString value = iter.value().toString();
 		value = escape(value);
-		out << iter.key() << "=" << value << "\n";
+		outArray.append(iter.key().toUtf8());
+		outArray.append('=');
+		outArray.append(value.toUtf8());
+		outArray.append('\n');
 	}
 
-	return true;
+	// written to a temporary file and renamed over the old one, so a crash can't truncate it
+	QSaveFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	if (file.write(outArray) != outArray.size())
+	{
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
 }
 
 bool INIFile::loadFile(QString fileName)
@@ -93,35 +101,129 @@ bool INIFile::loadFile(QString fileName)
 	QFile file(fileName);
 	if (!file.open(QIODevice::ReadOnly))
 		return false;
-	bool success = loadFile(file.readAll());
-	file.close();
-	return success;
+	qint64 size = file.size();
+	if (size == 0)
+		return true;
+	// parse straight out of the page cache when we can, there is no need for a copy
+	if (size < INT_MAX)
+	{
+		if (uchar *data = file.map(0, size))
+		{
+			parse((const char *)data, (const char *)data + size);
+			file.unmap(data);
+			return true;
+		}
+	}
+	return loadFile(file.readAll());
 }
+
 bool INIFile::loadFile(QByteArray file)
 {
-	QTextStream in(file);
-	in.setCodec("UTF-8");
+	parse(file.constData(), file.constData() + file.size());
+	return true;
+}
 
-	QStringList lines = in.readAll().split('\n');
-	for (int i = 0; i < lines.count(); i++)
-	{
-		QString &lineRaw = lines[i];
-		// Ignore comments.
-		QString line = lineRaw.left(lineRaw.indexOf('#')).trimmed();
+namespace
+{
+inline bool isAsciiSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
 
-		int eqPos = line.indexOf('=');
-		if (eqPos == -1)
-			continue;
-		QString key = line.left(eqPos).trimmed();
-		QString valueStr = line.right(line.length() - eqPos - 1).trimmed();
+// Decode one trimmed key or value. The byte loop only trims ASCII whitespace, non-ASCII
+// at either end may be unicode whitespace, which QString::trimmed knows about.
+inline QString decode(const char *begin, const char *end)
+{
+	QString out = QString::fromUtf8(begin, end - begin);
+	if (begin != end && ((uchar)*begin >= 0x80 || (uchar)end[-1] >= 0x80))
+		return out.trimmed();
+	return out;
+}
+}
 
-		valueStr = unescape(valueStr);
+/*
+ * One pass over the UTF-8 bytes, same rules as always:
+ * - lines end at '\n', everything from the first '#' on is a comment
+ * - the first '=' splits key and value, both are trimmed
+ * - values are unescaped after trimming ('\n', '\t', '\x' -> 'x', a lone trailing '\' is dropped)
+ * Escapes only involve ASCII, so unescaping the bytes gives the same result as unescaping the
+ * decoded string. Values without a backslash (nearly all of them) are decoded in place.
+ */
+void INIFile::parse(const char *data, const char *dataEnd)
+{
+	// skip a UTF-8 byte order mark
+	if (dataEnd - data >= 3 && (uchar)data[0] == 0xEF && (uchar)data[1] == 0xBB &&
+		(uchar)data[2] == 0xBF)
+		data += 3;
+
+	QByteArray unescaped;
+	const char *lineStart = data;
+	while (lineStart < dataEnd)
+	{
+		const char *lineEnd = (const char *)memchr(lineStart, '\n', dataEnd - lineStart);
+		if (!lineEnd)
+			lineEnd = dataEnd;
+		const char *next = lineEnd + 1;
+
+		const char *comment = (const char *)memchr(lineStart, '#', lineEnd - lineStart);
+		if (comment)
+			lineEnd = comment;
+		const char *eq = (const char *)memchr(lineStart, '=', lineEnd - lineStart);
+		if (!eq)
+		{
+			lineStart = next;
+			continue;
+		}
 
-		QVariant value(valueStr);
-		this->operator[](key) = value;
+		const char *keyBegin = lineStart;
+		const char *keyEnd = eq;
+		while (keyBegin < keyEnd && isAsciiSpace(*keyBegin))
+			keyBegin++;
+		while (keyEnd > keyBegin && isAsciiSpace(keyEnd[-1]))
+			keyEnd--;
+
+		const char *valueBegin = eq + 1;
+		const char *valueEnd = lineEnd;
+		while (valueBegin < valueEnd && isAsciiSpace(*valueBegin))
+			valueBegin++;
+		while (valueEnd > valueBegin && isAsciiSpace(valueEnd[-1]))
+			valueEnd--;
+
+		QString value;
+		if (!memchr(valueBegin, '\\', valueEnd - valueBegin))
+		{
+			value = decode(valueBegin, valueEnd);
+		}
+		else if ((uchar)*valueBegin >= 0x80 || (uchar)valueEnd[-1] >= 0x80)
+		{
+			// possibly unicode whitespace to trim first - rare enough for the slow path
+			value = unescape(decode(valueBegin, valueEnd));
+		}
+		else
+		{
+			unescaped.resize(0);
+			unescaped.reserve(valueEnd - valueBegin);
+			for (const char *c = valueBegin; c < valueEnd; c++)
+			{
+				if (*c != '\\')
+				{
+					unescaped.append(*c);
+					continue;
+				}
+				if (++c == valueEnd)
+					break;
+				if (*c == 'n')
+					unescaped.append('\n');
+				else if (*c == 't')
+					unescaped.append('\t');
+				else
+					unescaped.append(*c);
+			}
+			value = QString::fromUtf8(unescaped);
+		}
+		insert(decode(keyBegin, keyEnd), QVariant(value));
+		lineStart = next;
 	}
-
-	return true;
 }
 
 QVariant INIFile::get(QString key, QVariant def) const
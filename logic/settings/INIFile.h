@@ -33,4 +33,7 @@ public:
 	void set(QString key, QVariant val);
 	static QString unescape(QString orig);
 	static QString escape(QString orig);
+
+private:
+	void parse(const char *data, const char *dataEnd);
 };
@@ -15,12 +15,54 @@
 
 #include "INISettingsObject.h"
 #include "Setting.h"
+#include "logger/QsLog.h"
+
+QSet<INISettingsObject *> INISettingsObject::s_objects;
 
 INISettingsObject::INISettingsObject(const QString &path, QObject *parent)
 	: SettingsObject(parent)
 {
 	m_filePath = path;
 	m_ini.loadFile(path);
+	m_saveTimer.setSingleShot(true);
+	m_saveTimer.setTimerType(Qt::CoarseTimer);
+	connect(&m_saveTimer, SIGNAL(timeout()), SLOT(saveNow()));
+	s_objects.insert(this);
+}
+
+INISettingsObject::~INISettingsObject()
+{
+	s_objects.remove(this);
+	saveNow();
+}
+
+void INISettingsObject::flushAll()
+{
+	for (auto object : s_objects)
+	{
+		object->saveNow();
+	}
+}
+
+void INISettingsObject::saveEventually()
+{
+	m_dirty = true;
+	// a settings dialog applying all its values makes one write, not one per value
+	m_saveTimer.start(500);
+}
+
+bool INISettingsObject::saveNow()
+{
+	m_saveTimer.stop();
+	if (!m_dirty)
+		return true;
+	if (!m_ini.saveFile(m_filePath))
+	{
+		QLOG_ERROR() << "Failed to save settings to" << m_filePath;
+		return false;
+	}
+	m_dirty = false;
+	return true;
 }
 
 void INISettingsObject::setFilePath(const QString &filePath)
@@ -30,12 +72,18 @@ void INISettingsObject::setFilePath(const QString &filePath)
 
 bool INISettingsObject::reload()
 {
-	return m_ini.loadFile(m_filePath) && SettingsObject::reload();
+	// don't lose changes that are still waiting to be written
+	saveNow();
+	const bool loaded = m_ini.loadFile(m_filePath) && SettingsObject::reload();
+	// reloading sets every value again, to tell everyone about it. nothing new to write
+	m_saveTimer.stop();
+	m_dirty = false;
+	return loaded;
 }
 
 void INISettingsObject::changeSetting(const Setting &setting, QVariant value)
 {
-	if (contains(setting.id()))
+	if (owns(setting))
 	{
 		// valid value -> set the main config, remove all the sysnonyms
 		if (value.isValid())
@@ -51,25 +99,25 @@ void INISettingsObject::changeSetting(const Setting &setting, QVariant value)
 			for(auto iter: setting.configKeys())
 				m_ini.remove(iter);
 		}
-		m_ini.saveFile(m_filePath);
+		saveEventually();
 	}
 }
 
 void INISettingsObject::resetSetting(const Setting &setting)
 {
 	// if we have the setting, remove all the synonyms. ALL OF THEM
-	if (contains(setting.id()))
+	if (owns(setting))
 	{
 		for(auto iter: setting.configKeys())
 			m_ini.remove(iter);
-		m_ini.saveFile(m_filePath);
+		saveEventually();
 	}
 }
 
 QVariant INISettingsObject::retrieveValue(const Setting &setting)
 {
 	// if we have the setting, return value of the first matching synonym
-	if (contains(setting.id()))
+	if (owns(setting))
 	{
 		for(auto iter: setting.configKeys())
 		{
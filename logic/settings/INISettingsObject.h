@@ -16,6 +16,8 @@
 #pragma once
 
 #include <QObject>
+#include <QSet>
+#include <QTimer>
 
 #include "logic/settings/INIFile.h"
 
@@ -23,12 +25,22 @@
 
 /*!
  * \brief A settings object that stores its settings in an INIFile.
+ *
+ * Changes are not written right away - they are collected for a moment and then written
+ * together, replacing the file atomically.
  */
 class INISettingsObject : public SettingsObject
 {
 	Q_OBJECT
 public:
 	explicit INISettingsObject(const QString &path, QObject *parent = 0);
+	virtual ~INISettingsObject();
+
+	/*!
+	 * \brief Writes the pending changes of every INISettingsObject.
+	 * Call this before anything reads the files directly, and on exit.
+	 */
+	static void flushAll();
 
 	/*!
 	 * \brief Gets the path to the INI file.
@@ -47,6 +59,14 @@ public:
 
 	bool reload() override;
 
+	//! (re)start the timer that calls saveNow
+	void saveEventually();
+
+public
+slots:
+	//! write the pending changes, if there are any. returns false if writing failed
+	bool saveNow();
+
 protected
 slots:
 	virtual void changeSetting(const Setting &setting, QVariant value);
@@ -58,4 +78,10 @@ protected:
 	INIFile m_ini;
 
 	QString m_filePath;
+
+private:
+	bool m_dirty = false;
+	QTimer m_saveTimer;
+	//! every live object, for flushAll
+	static QSet<INISettingsObject *> s_objects;
 };
@@ -19,6 +19,8 @@ OverrideSetting::OverrideSetting(std::shared_ptr<Setting> other)
 	: Setting(other->configKeys(), QVariant())
 {
 	m_other = other;
+	// our default is the other setting's value, it has to go when that one does
+	connect(m_other.get(), SIGNAL(invalidated()), SLOT(invalidate()));
 }
 
 QVariant OverrideSetting::defValue() const
@@ -16,12 +16,35 @@
 #include "Setting.h"
 #include "logic/settings/SettingsObject.h"
 
+#include <QThread>
+
 Setting::Setting(QStringList synonyms, QVariant defVal)
 	: QObject(), m_synonyms(synonyms), m_defVal(defVal)
 {
 }
 
 QVariant Setting::get() const
+{
+	if (m_cacheValid)
+		return m_cache;
+	QVariant value = retrieve();
+	// only the owning thread fills the cache, everybody else just reads through
+	if (QThread::currentThread() == thread())
+	{
+		m_cache = value;
+		m_cacheValid = true;
+	}
+	return value;
+}
+
+void Setting::invalidate()
+{
+	m_cacheValid = false;
+	m_cache = QVariant();
+	emit invalidated();
+}
+
+QVariant Setting::retrieve() const
 {
 	SettingsObject *sbase = m_storage;
 	if (!sbase)
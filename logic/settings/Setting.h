@@ -67,6 +67,7 @@ public:
 	 * \brief Gets this setting's value as a QVariant.
 	 * This is done by calling the SettingsObject's retrieveValue() function.
 	 * If this Setting doesn't have a SettingsObject, this returns an invalid QVariant.
+	 * The result is cached until the setting changes, resets or its storage reloads.
 	 * \return QVariant containing this setting's value.
 	 * \sa value()
 	 */
@@ -92,6 +93,12 @@ signals:
 	 */
 	void settingReset(const Setting &setting);
 
+	/*!
+	 * \brief Signal emitted when the cached value of this setting is thrown away.
+	 * Settings that derive their value from this one (overrides) listen to it.
+	 */
+	void invalidated();
+
 public
 slots:
 	/*!
@@ -109,9 +116,21 @@ slots:
 	 */
 	virtual void reset();
 
+	/*!
+	 * \brief Forget the cached value, the next get() asks the SettingsObject again.
+	 */
+	void invalidate();
+
 protected:
+	//! Looks the value up, bypassing the cache.
+	virtual QVariant retrieve() const;
+
 	friend class SettingsObject;
-	SettingsObject * m_storage;
+	SettingsObject * m_storage = nullptr;
 	QStringList m_synonyms;
 	QVariant m_defVal;
+
+private:
+	mutable QVariant m_cache;
+	mutable bool m_cacheValid = false;
 };
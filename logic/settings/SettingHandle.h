@@ -0,0 +1,69 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include "Setting.h"
+
+/*!
+ * \brief Typed access to one registered setting.
+ * Holds on to the Setting itself, so reading it is a pointer dereference and a read of the
+ * value the setting has cached. Get one from SettingsObject::handle() once and keep it,
+ * instead of looking the setting up by ID on every read.
+ */
+template <typename T> class SettingHandle
+{
+public:
+	SettingHandle()
+	{
+	}
+	explicit SettingHandle(std::shared_ptr<Setting> setting) : m_setting(setting)
+	{
+	}
+
+	bool isValid() const
+	{
+		return m_setting != nullptr;
+	}
+
+	T get() const
+	{
+		return m_setting->get().template value<T>();
+	}
+	T operator*() const
+	{
+		return get();
+	}
+
+	void set(const T &value)
+	{
+		m_setting->set(QVariant::fromValue(value));
+	}
+	void reset()
+	{
+		m_setting->reset();
+	}
+
+	std::shared_ptr<Setting> setting() const
+	{
+		return m_setting;
+	}
+
+private:
+	std::shared_ptr<Setting> m_setting;
+};
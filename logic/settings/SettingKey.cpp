@@ -0,0 +1,72 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "SettingKey.h"
+
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+namespace
+{
+struct KeyRegistry
+{
+	QReadWriteLock lock;
+	QHash<QString, int> indices;
+	QVector<QString> ids;
+};
+
+KeyRegistry &registry()
+{
+	static KeyRegistry instance;
+	return instance;
+}
+}
+
+SettingKey::SettingKey(const QString &id) : m_index(intern(id))
+{
+}
+
+SettingKey::SettingKey(const char *id) : m_index(intern(QString::fromLatin1(id)))
+{
+}
+
+QString SettingKey::id() const
+{
+	auto &reg = registry();
+	QReadLocker locker(&reg.lock);
+	return reg.ids.at(m_index);
+}
+
+int SettingKey::intern(const QString &id)
+{
+	auto &reg = registry();
+	{
+		QReadLocker locker(&reg.lock);
+		auto iter = reg.indices.constFind(id);
+		if (iter != reg.indices.constEnd())
+			return *iter;
+	}
+	QWriteLocker locker(&reg.lock);
+	// somebody else may have added it in the meantime
+	auto iter = reg.indices.constFind(id);
+	if (iter != reg.indices.constEnd())
+		return *iter;
+	int index = reg.ids.size();
+	reg.ids.append(id);
+	reg.indices.insert(id, index);
+	return index;
+}
@@ -0,0 +1,59 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <QString>
+
+/*!
+ * \brief An interned setting ID.
+ * Every distinct ID gets a small integer the first time it is seen, either when a setting
+ * with it is registered or when a key is constructed. SettingsObject keeps its settings in
+ * a vector indexed by it, so looking a setting up by key doesn't hash or compare strings.
+ *
+ * Keys are meant to be made once and kept around, usually as a function local static:
+ * \code
+ * static const SettingKey trackFTB("TrackFTBInstances");
+ * MMC->settings()->get(trackFTB);
+ * \endcode
+ */
+class SettingKey
+{
+public:
+	explicit SettingKey(const QString &id);
+	explicit SettingKey(const char *id);
+
+	int index() const
+	{
+		return m_index;
+	}
+	QString id() const;
+
+	bool operator==(const SettingKey &other) const
+	{
+		return m_index == other.m_index;
+	}
+	bool operator!=(const SettingKey &other) const
+	{
+		return m_index != other.m_index;
+	}
+
+	//! Returns the index of the ID, interning it if it's new.
+	static int intern(const QString &id);
+
+private:
+	int m_index;
+};
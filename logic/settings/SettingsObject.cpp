@@ -40,7 +40,7 @@ std::shared_ptr<Setting> SettingsObject::registerOverride(std::shared_ptr<Settin
 	auto override = std::make_shared<OverrideSetting>(original);
 	override->m_storage = this;
 	connectSignals(*override);
-	m_settings.insert(override->id(), override);
+	insertSetting(override);
 	return override;
 }
 
@@ -57,7 +57,7 @@ std::shared_ptr<Setting> SettingsObject::registerSetting(QStringList synonyms, Q
 	auto setting = std::make_shared<Setting>(synonyms, defVal);
 	setting->m_storage = this;
 	connectSignals(*setting);
-	m_settings.insert(setting->id(), setting);
+	insertSetting(setting);
 	return setting;
 }
 
@@ -70,12 +70,27 @@ std::shared_ptr<Setting> SettingsObject::getSetting(const QString &id) const
 	return m_settings[id];
 }
 
+void SettingsObject::insertSetting(std::shared_ptr<Setting> setting)
+{
+	m_settings.insert(setting->id(), setting);
+	int index = SettingKey::intern(setting->id());
+	if (index >= m_byKey.size())
+		m_byKey.resize(index + 1);
+	m_byKey[index] = setting;
+}
+
 QVariant SettingsObject::get(const QString &id) const
 {
 	auto setting = getSetting(id);
 	return (setting ? setting->get() : QVariant());
 }
 
+QVariant SettingsObject::get(const SettingKey &key) const
+{
+	auto setting = getSetting(key);
+	return (setting ? setting->get() : QVariant());
+}
+
 bool SettingsObject::set(const QString &id, QVariant value)
 {
 	auto setting = getSetting(id);
@@ -103,8 +118,18 @@ bool SettingsObject::contains(const QString &id)
 	return m_settings.contains(id);
 }
 
+bool SettingsObject::owns(const Setting &setting) const
+{
+	return setting.m_storage == this;
+}
+
 bool SettingsObject::reload()
 {
+	// the storage changed underneath the cached values
+	for (auto setting : m_settings.values())
+	{
+		setting->invalidate();
+	}
 	for (auto setting : m_settings.values())
 	{
 		setting->set(setting->get());
@@ -114,11 +139,15 @@ bool SettingsObject::reload()
 
 void SettingsObject::connectSignals(const Setting &setting)
 {
+	// slots run in connection order: store the value, drop the cached one, then tell everybody
 	connect(&setting, SIGNAL(SettingChanged(const Setting &, QVariant)),
 			SLOT(changeSetting(const Setting &, QVariant)));
+	connect(&setting, SIGNAL(SettingChanged(const Setting &, QVariant)), &setting,
+			SLOT(invalidate()));
 	connect(&setting, SIGNAL(SettingChanged(const Setting &, QVariant)),
 			SIGNAL(SettingChanged(const Setting &, QVariant)));
 
 	connect(&setting, SIGNAL(settingReset(Setting)), SLOT(resetSetting(const Setting &)));
+	connect(&setting, SIGNAL(settingReset(Setting)), &setting, SLOT(invalidate()));
 	connect(&setting, SIGNAL(settingReset(Setting)), SIGNAL(settingReset(const Setting &)));
 }
@@ -19,8 +19,12 @@
 #include <QMap>
 #include <QStringList>
 #include <QVariant>
+#include <QVector>
 #include <memory>
 
+#include "SettingKey.h"
+#include "SettingHandle.h"
+
 class Setting;
 
 /*!
@@ -81,6 +85,24 @@ public:
 	 */
 	std::shared_ptr<Setting> getSetting(const QString &id) const;
 
+	/*!
+	 * \brief Gets the setting with the given interned key.
+	 * Same as getSetting(const QString &), but it's a vector lookup.
+	 */
+	std::shared_ptr<Setting> getSetting(const SettingKey &key) const
+	{
+		return m_byKey.value(key.index());
+	}
+
+	/*!
+	 * \brief Gets a typed handle for the setting with the given ID.
+	 * The handle is invalid if there is no such setting.
+	 */
+	template <typename T> SettingHandle<T> handle(const QString &id) const
+	{
+		return SettingHandle<T>(getSetting(id));
+	}
+
 	/*!
 	 * \brief Gets the value of the setting with the given ID.
 	 * \param id The ID of the setting to get.
@@ -89,6 +111,11 @@ public:
 	 */
 	QVariant get(const QString &id) const;
 
+	/*!
+	 * \brief Gets the value of the setting with the given interned key.
+	 */
+	QVariant get(const SettingKey &key) const;
+
 	/*!
 	 * \brief Sets the value of the setting with the given ID.
 	 * If no setting with the given ID exists, returns false
@@ -157,6 +184,12 @@ slots:
 	virtual void resetSetting(const Setting &setting) = 0;
 
 protected:
+	/*!
+	 * \brief Checks if the given setting was registered with this SettingsObject.
+	 * Cheaper than contains(setting.id()).
+	 */
+	bool owns(const Setting &setting) const;
+
 	/*!
 	 * \brief Connects the necessary signals to the given Setting.
 	 * \param setting The setting to connect.
@@ -173,5 +206,9 @@ protected:
 	friend class Setting;
 
 private:
+	void insertSetting(std::shared_ptr<Setting> setting);
+
 	QMap<QString, std::shared_ptr<Setting>> m_settings;
+	//! the same settings, indexed by SettingKey
+	QVector<std::shared_ptr<Setting>> m_byKey;
 };
@@ -0,0 +1,283 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CopyDirectoryTask.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrentMap>
+#include <functional>
+
+#include <pathutils.h>
+#include "logger/QsLog.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+/// The link text as stored, not resolved like QFileInfo::symLinkTarget()
+static QString readLinkText(const QFileInfo &info)
+{
+#ifdef Q_OS_UNIX
+	QByteArray path = QFile::encodeName(info.filePath());
+	QByteArray buffer(256, Qt::Uninitialized);
+	while (true)
+	{
+		ssize_t length = ::readlink(path.constData(), buffer.data(), buffer.size());
+		if (length < 0)
+			return QString();
+		if (length < buffer.size())
+			return QFile::decodeName(buffer.left(length));
+		buffer.resize(buffer.size() * 2);
+	}
+#else
+	return info.symLinkTarget();
+#endif
+}
+
+CopyDirectoryTask::CopyDirectoryTask(const QString &src, const QString &dst, QObject *parent)
+	: Task(parent), m_src(src), m_dst(dst), m_copiedBytes(0), m_reflinkSupported(1)
+{
+	connect(&m_watcher, SIGNAL(progressValueChanged(int)), SLOT(copyProgress(int)));
+	connect(&m_watcher, SIGNAL(finished()), SLOT(copyFinished()));
+}
+
+void CopyDirectoryTask::setHardlinkFilter(const QRegularExpression &filter)
+{
+	m_hardlinkFilter = filter;
+}
+
+void CopyDirectoryTask::executeTask()
+{
+	setStatus(tr("Looking for files to copy..."));
+	QDir srcDir(m_src);
+	if (!srcDir.exists())
+	{
+		emitFailed(tr("Source folder %1 doesn't exist.").arg(m_src));
+		return;
+	}
+	if (!ensureFolderPathExists(m_dst))
+	{
+		emitFailed(tr("Couldn't create folder %1.").arg(m_dst));
+		return;
+	}
+
+	// folders are created here, files are left to the workers
+	QDirIterator iter(m_src, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+					  QDirIterator::Subdirectories);
+	while (iter.hasNext())
+	{
+		iter.next();
+		QFileInfo info = iter.fileInfo();
+		QString relative = srcDir.relativeFilePath(info.filePath());
+		QString target = PathCombine(m_dst, relative);
+		if (info.isSymLink())
+		{
+			Item item;
+			item.src = info.filePath();
+			item.dst = target;
+			item.symlinkTarget = rebaseLinkTarget(readLinkText(info));
+			m_items.append(item);
+		}
+		else if (info.isDir())
+		{
+			if (!ensureFolderPathExists(target))
+			{
+				emitFailed(tr("Couldn't create folder %1.").arg(target));
+				return;
+			}
+		}
+		else
+		{
+			Item item;
+			item.src = info.filePath();
+			item.dst = target;
+			item.size = info.size();
+			item.hardlink = m_hardlinkFilter.isValid() && !m_hardlinkFilter.pattern().isEmpty() &&
+							m_hardlinkFilter.match(relative).hasMatch();
+			m_items.append(item);
+		}
+	}
+
+	m_totalBytes = 0;
+	m_copiedBytes = 0;
+	for (auto &item : m_items)
+	{
+		m_totalBytes += weight(item);
+	}
+
+	QLOG_INFO() << "Copying" << m_items.size() << "files (" << m_totalBytes << "bytes) from"
+				<< m_src << "to" << m_dst;
+	setStatus(tr("Copying files..."));
+	setProgress(0);
+	std::function<bool(const Item &)> copier = [this](const Item &item)
+	{
+		const bool ok = copyItem(item);
+		m_copiedBytes += weight(item);
+		return ok;
+	};
+	m_watcher.setFuture(QtConcurrent::mapped(m_items, copier));
+}
+
+QString CopyDirectoryTask::rebaseLinkTarget(const QString &target) const
+{
+	// relative links stay valid in the copy as they are, and so do absolute ones leading
+	// outside of the tree. Absolute ones into the tree have to point into the copy instead.
+	if (target.isEmpty() || QDir::isRelativePath(target))
+		return target;
+	QString cleanTarget = QDir::cleanPath(target);
+	for (auto root : {QDir::cleanPath(QDir(m_src).absolutePath()),
+					  QDir::cleanPath(QDir(m_src).canonicalPath())})
+	{
+		if (root.isEmpty())
+			continue;
+		if (cleanTarget == root)
+			return QDir(m_dst).absolutePath();
+		if (cleanTarget.startsWith(root + '/'))
+			return PathCombine(QDir(m_dst).absolutePath(), cleanTarget.mid(root.size() + 1));
+	}
+	return target;
+}
+
+bool CopyDirectoryTask::reflink(const Item &item)
+{
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+	if (!m_reflinkSupported.load())
+		return false;
+	int srcFd = ::open(QFile::encodeName(item.src).constData(), O_RDONLY);
+	if (srcFd < 0)
+		return false;
+	int dstFd = ::open(QFile::encodeName(item.dst).constData(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+	if (dstFd < 0)
+	{
+		::close(srcFd);
+		return false;
+	}
+	bool success = ::ioctl(dstFd, FICLONE, srcFd) == 0;
+	if (!success && (errno == EOPNOTSUPP || errno == ENOTTY || errno == EXDEV || errno == EINVAL))
+	{
+		m_reflinkSupported.store(0);
+	}
+	::close(srcFd);
+	::close(dstFd);
+	if (!success)
+	{
+		::unlink(QFile::encodeName(item.dst).constData());
+		return false;
+	}
+	QFile::setPermissions(item.dst, QFile::permissions(item.src));
+	return true;
+#else
+	Q_UNUSED(item);
+	return false;
+#endif
+}
+
+qint64 CopyDirectoryTask::weight(const Item &item)
+{
+	// links and empty files still take a few syscalls, count them like a small file
+	return qMax<qint64>(item.size, 4096);
+}
+
+bool CopyDirectoryTask::copyItem(const Item &item)
+{
+	if (!item.symlinkTarget.isEmpty())
+	{
+#ifdef Q_OS_UNIX
+		// write the link text exactly as it was read
+		return ::symlink(QFile::encodeName(item.symlinkTarget).constData(),
+						 QFile::encodeName(item.dst).constData()) == 0;
+#else
+		return QFile::link(item.symlinkTarget, item.dst);
+#endif
+	}
+	if (reflink(item))
+	{
+		return true;
+	}
+	if (item.hardlink)
+	{
+#ifdef Q_OS_UNIX
+		if (::link(QFile::encodeName(item.src).constData(),
+				   QFile::encodeName(item.dst).constData()) == 0)
+		{
+			return true;
+		}
+#endif
+	}
+	return QFile::copy(item.src, item.dst);
+}
+
+void CopyDirectoryTask::copyProgress(int)
+{
+	if (!m_totalBytes)
+		return;
+	setProgress(m_copiedBytes.load() * 100 / m_totalBytes);
+}
+
+void CopyDirectoryTask::copyFinished()
+{
+	if (m_watcher.isCanceled())
+	{
+		emitFailed(tr("Copying was aborted."));
+		return;
+	}
+
+	// only a size check, reading everything a second time would double the time it takes
+	setStatus(tr("Checking copied files..."));
+	QStringList failed;
+	auto future = m_watcher.future();
+	for (int i = 0; i < m_items.size(); i++)
+	{
+		const Item &item = m_items[i];
+		QFileInfo copied(item.dst);
+		bool ok = future.resultAt(i);
+		if (item.symlinkTarget.isEmpty())
+		{
+			ok = ok && copied.isFile() && copied.size() == item.size;
+		}
+		else
+		{
+			ok = ok && copied.isSymLink();
+		}
+		if (!ok)
+		{
+			QLOG_ERROR() << "Failed to copy" << item.src << "to" << item.dst;
+			failed.append(item.src);
+		}
+	}
+	m_items.clear();
+
+	if (!failed.isEmpty())
+	{
+		emitFailed(tr("Failed to copy %n file(s), for example %1", "", failed.size())
+					   .arg(failed.first()));
+		return;
+	}
+	emitSucceeded();
+}
+
+void CopyDirectoryTask::abort()
+{
+	m_watcher.cancel();
+}
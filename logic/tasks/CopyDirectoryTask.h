@@ -0,0 +1,82 @@
+/* Copyright 2013-2014 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QFutureWatcher>
+#include <QRegularExpression>
+#include <QAtomicInt>
+#include <QStringList>
+#include <atomic>
+
+#include "Task.h"
+
+/**
+ * Copies a directory tree.
+ *
+ * Files are reflinked (FICLONE) where the filesystem supports it, hardlinked if they match
+ * the hardlink filter, and copied on a pool of worker threads otherwise. When done, the
+ * sizes of the copies are checked against the source listing - contents aren't compared.
+ * Symlinks are recreated with their original link text, absolute links into the source
+ * tree are pointed at the copy.
+ */
+class CopyDirectoryTask : public Task
+{
+	Q_OBJECT
+public:
+	explicit CopyDirectoryTask(const QString &src, const QString &dst, QObject *parent = 0);
+
+	/// files with a path (relative to the source) matching this are hardlinked, if possible
+	void setHardlinkFilter(const QRegularExpression &filter);
+
+public
+slots:
+	virtual void abort();
+
+protected:
+	virtual void executeTask();
+
+private
+slots:
+	void copyProgress(int value);
+	void copyFinished();
+
+private:
+	struct Item
+	{
+		QString src;
+		QString dst;
+		QString symlinkTarget;
+		qint64 size = 0;
+		bool hardlink = false;
+	};
+	/// how much an item counts towards the progress
+	static qint64 weight(const Item &item);
+	bool copyItem(const Item &item);
+	bool reflink(const Item &item);
+	/// moves absolute link targets inside the source tree into the destination tree
+	QString rebaseLinkTarget(const QString &target) const;
+
+	QString m_src;
+	QString m_dst;
+	QRegularExpression m_hardlinkFilter;
+	QList<Item> m_items;
+	QFutureWatcher<bool> m_watcher;
+	qint64 m_totalBytes = 0;
+	// added to by the workers as they finish items
+	std::atomic<qint64> m_copiedBytes;
+	// cleared the first time the filesystem refuses to reflink
+	QAtomicInt m_reflinkSupported;
+};
@@ -1,17 +1,25 @@
 #include "MultiMC.h"
 #include "gui/MainWindow.h"
+#include "logic/StartupTrace.h"
 
 int main_gui(MultiMC &app)
 {
 	// show main window
+	auto windowPhase = MMC->startupTrace()->phase("main window");
 	QIcon::setThemeName(MMC->settings()->get("IconTheme").toString());
 	MainWindow mainWin;
 	mainWin.restoreState(QByteArray::fromBase64(MMC->settings()->get("MainWindowState").toByteArray()));
 	mainWin.restoreGeometry(QByteArray::fromBase64(MMC->settings()->get("MainWindowGeometry").toByteArray()));
 	mainWin.show();
-	mainWin.checkMigrateLegacyAssets();
-	mainWin.checkSetDefaultJava();
-	mainWin.checkInstancePathForProblems();
+	windowPhase.end();
+
+	// these may open dialogs, let the main window paint first
+	MMC->defer(MultiMC::DeferNormal, "legacy assets check", [&mainWin]()
+	{ mainWin.checkMigrateLegacyAssets(); });
+	MMC->defer(MultiMC::DeferNormal, "default java check", [&mainWin]()
+	{ mainWin.checkSetDefaultJava(); });
+	MMC->defer(MultiMC::DeferNormal, "instance path check", [&mainWin]()
+	{ mainWin.checkInstancePathForProblems(); });
 	return app.exec();
 }
 
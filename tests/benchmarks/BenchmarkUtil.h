@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include <QByteArray>
+#include <quazip.h>
+#include <quazipfile.h>
+
+namespace BenchmarkUtil
+{
+/// write a zip file with the given file names and contents
+inline bool writeZip(const QString &path, const QMap<QString, QByteArray> &files)
+{
+	QuaZip zip(path);
+	if (!zip.open(QuaZip::mdCreate))
+		return false;
+	QuaZipFile file(&zip);
+	for (auto iter = files.begin(); iter != files.end(); ++iter)
+	{
+		if (!file.open(QIODevice::WriteOnly, QuaZipNewInfo(iter.key())))
+			return false;
+		file.write(iter.value());
+		file.close();
+		if (file.getZipError() != UNZ_OK)
+			return false;
+	}
+	zip.close();
+	return zip.getZipError() == UNZ_OK;
+}
+
+/// contents of a jar with the given number of made up class files in a package
+inline QMap<QString, QByteArray> fakeClasses(const QString &package, int count, int size)
+{
+	QMap<QString, QByteArray> files;
+	for (int i = 0; i < count; i++)
+	{
+		// class files are only somewhat compressible, mix the constant pool up a bit
+		QByteArray data("\xca\xfe\xba\xbe\x00\x00\x00\x32", 8);
+		while (data.size() < size)
+			data += QByteArray::number((data.size() * 2654435761u) ^ i, 36);
+		data.truncate(size);
+		files.insert(QString("%1/C%2.class").arg(package).arg(i), data);
+	}
+	files.insert("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n\r\n");
+	return files;
+}
+}
@@ -0,0 +1,74 @@
+#include <QTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "TestUtil.h"
+
+#include "logic/minecraft/GradleSpecifier.h"
+
+class GradleSpecifierBenchmark : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+		// the library names of a forge instance are a realistic mix
+		for (auto file : {"data/instance/version.json",
+						  "data/instance/patches/net.minecraftforge.json"})
+		{
+			auto root = QJsonDocument::fromJson(MULTIMC_GET_TEST_FILE(file)).object();
+			auto libraries = root.value("libraries").toArray();
+			for (auto library : root.value("+libraries").toArray())
+				libraries.append(library);
+			for (auto library : libraries)
+				m_names.append(library.toObject().value("name").toString());
+		}
+		m_names.append("org.gradle.test.classifiers:service:1.0:jdk15@jar.pack.xz");
+		QVERIFY(m_names.size() > 40);
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_Parse()
+	{
+		QBENCHMARK
+		{
+			for (auto &name : m_names)
+				GradleSpecifier spec(name);
+		}
+	}
+	void bench_ToPath()
+	{
+		QList<GradleSpecifier> specs;
+		for (auto &name : m_names)
+			specs.append(GradleSpecifier(name));
+		QBENCHMARK
+		{
+			for (auto &spec : specs)
+				spec.toPath();
+		}
+	}
+	void bench_MatchName()
+	{
+		QList<GradleSpecifier> specs;
+		for (auto &name : m_names)
+			specs.append(GradleSpecifier(name));
+		// what replacing libraries while applying patches does
+		QBENCHMARK
+		{
+			for (auto &a : specs)
+				for (auto &b : specs)
+					a.matchName(b);
+		}
+	}
+
+private:
+	QStringList m_names;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(GradleSpecifierBenchmark)
+
+#include "bench_GradleSpecifier.moc"
@@ -0,0 +1,116 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include "TestUtil.h"
+
+#include "logic/net/HttpMetaCache.h"
+
+// entries in the index, and how many of them have a file on disk
+static const int ENTRY_COUNT = 5000;
+static const int FILE_COUNT = 500;
+
+class HttpMetaCacheBenchmark : public QObject
+{
+	Q_OBJECT
+
+	QString resourcePath(int i)
+	{
+		return QString("org/example/artifact%1/1.%2/artifact%1-1.%2.jar").arg(i / 10).arg(i % 10);
+	}
+	void addBases(HttpMetaCache &cache)
+	{
+		cache.addBase("libraries", m_dir.path() + "/libraries");
+		cache.addBase("assets", m_dir.path() + "/assets");
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+		m_index = m_dir.path() + "/metacache";
+
+		// an index about the size of one with a few modpacks installed
+		HttpMetaCache cache(m_index);
+		addBases(cache);
+		for (int i = 0; i < ENTRY_COUNT; i++)
+		{
+			const bool isAsset = i % 3 == 0;
+			auto entry = cache.resolveEntry(isAsset ? "assets" : "libraries", resourcePath(i));
+			QVERIFY(entry->stale);
+			QByteArray data = QByteArray::number(i).repeated(100);
+			if (i < FILE_COUNT)
+			{
+				QString path = m_dir.path() + "/" + entry->base + "/" + entry->path;
+				QVERIFY(QDir().mkpath(QFileInfo(path).path()));
+				QFile file(path);
+				QVERIFY(file.open(QIODevice::WriteOnly));
+				file.write(data);
+				file.close();
+				entry->local_changed_timestamp =
+					QFileInfo(path).lastModified().toUTC().toMSecsSinceEpoch();
+			}
+			entry->md5sum = QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex();
+			entry->etag = "\"" + entry->md5sum + "\"";
+			entry->remote_changed_timestamp = "Tue, 12 Aug 2014 10:30:00 GMT";
+			entry->stale = false;
+			QVERIFY(cache.updateEntry(entry));
+		}
+		cache.SaveNow();
+		QVERIFY(QFile::exists(m_index));
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_Load()
+	{
+		QBENCHMARK
+		{
+			HttpMetaCache cache(m_index);
+			addBases(cache);
+			cache.Load();
+		}
+	}
+	void bench_Save()
+	{
+		HttpMetaCache cache(m_index);
+		addBases(cache);
+		cache.Load();
+		QBENCHMARK
+		{
+			cache.SaveNow();
+		}
+	}
+	void bench_Resolve()
+	{
+		HttpMetaCache cache(m_index);
+		addBases(cache);
+		cache.Load();
+		// the first entries have files and are fresh, the rest are missing
+		for (int i = 0; i < FILE_COUNT; i++)
+		{
+			const bool isAsset = i % 3 == 0;
+			QVERIFY(!cache.resolveEntry(isAsset ? "assets" : "libraries", resourcePath(i))->stale);
+		}
+		QBENCHMARK
+		{
+			for (int i = 0; i < 2 * FILE_COUNT; i++)
+			{
+				const bool isAsset = i % 3 == 0;
+				cache.resolveEntry(isAsset ? "assets" : "libraries",
+								   resourcePath(i < FILE_COUNT ? i : ENTRY_COUNT + i));
+			}
+		}
+	}
+
+private:
+	QTemporaryDir m_dir;
+	QString m_index;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(HttpMetaCacheBenchmark)
+
+#include "bench_HttpMetaCache.moc"
@@ -0,0 +1,62 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "logic/settings/INIFile.h"
+
+class INIFileBenchmark : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+		m_config = MULTIMC_GET_TEST_FILE("data/instance.cfg");
+		QVERIFY(!m_config.isEmpty());
+		m_path = m_dir.path() + "/instance.cfg";
+		QFile file(m_path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write(m_config);
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_Parse()
+	{
+		QBENCHMARK
+		{
+			INIFile ini;
+			ini.loadFile(m_config);
+		}
+	}
+	void bench_Load()
+	{
+		QBENCHMARK
+		{
+			INIFile ini;
+			ini.loadFile(m_path);
+		}
+	}
+	void bench_Save()
+	{
+		INIFile ini;
+		QVERIFY(ini.loadFile(m_config));
+		const QString target = m_dir.path() + "/saved.cfg";
+		QBENCHMARK
+		{
+			ini.saveFile(target);
+		}
+	}
+
+private:
+	QTemporaryDir m_dir;
+	QByteArray m_config;
+	QString m_path;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(INIFileBenchmark)
+
+#include "bench_INIFile.moc"
@@ -0,0 +1,66 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchmarkUtil.h"
+
+#include "logic/JarUtils.h"
+
+class JarUtilsBenchmark : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+		// about the shape of a 1.7 minecraft.jar, signature included
+		auto vanilla = BenchmarkUtil::fakeClasses("net/minecraft", 2000, 4096);
+		vanilla.insert("META-INF/MOJANGCS.SF", QByteArray(4096, 'x'));
+		vanilla.insert("META-INF/MOJANGCS.RSA", QByteArray(2048, 'y'));
+		m_source = m_dir.path() + "/minecraft.jar";
+		QVERIFY(BenchmarkUtil::writeZip(m_source, vanilla));
+
+		for (int i = 0; i < 10; i++)
+		{
+			// jar mods mostly add classes, and replace a few of the vanilla ones
+			auto files = BenchmarkUtil::fakeClasses(QString("com/example/jarmod%1").arg(i), 200, 2048);
+			auto replaced = BenchmarkUtil::fakeClasses("net/minecraft", 20 * (i + 1), 4096);
+			for (auto iter = replaced.begin(); iter != replaced.end(); ++iter)
+				files.insert(iter.key(), iter.value());
+			const QString path = m_dir.path() + QString("/jarmod%1.zip").arg(i);
+			QVERIFY(BenchmarkUtil::writeZip(path, files));
+			m_mods.append(Mod(QFileInfo(path)));
+		}
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_CreateModdedJar_data()
+	{
+		QTest::addColumn<int>("mods");
+		QTest::newRow("1 jar mod") << 1;
+		QTest::newRow("10 jar mods") << 10;
+	}
+	void bench_CreateModdedJar()
+	{
+		QFETCH(int, mods);
+		const auto selected = m_mods.mid(0, mods);
+		const QString target = m_dir.path() + "/modded.jar";
+		QVERIFY(JarUtils::createModdedJar(m_source, target, selected));
+		QBENCHMARK
+		{
+			JarUtils::createModdedJar(m_source, target, selected);
+		}
+	}
+
+private:
+	QTemporaryDir m_dir;
+	QString m_source;
+	QList<Mod> m_mods;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(JarUtilsBenchmark)
+
+#include "bench_JarUtils.moc"
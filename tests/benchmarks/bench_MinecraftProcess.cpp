@@ -0,0 +1,62 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "logic/MinecraftProcess.h"
+#include "logic/auth/AuthSession.h"
+
+class MinecraftProcessBenchmark : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+		auto log = MULTIMC_GET_TEST_FILE_UTF8("data/minecraft.log").split('\n');
+		QVERIFY(log.size() > 40);
+		// a modded game easily logs a few thousand lines while starting up
+		for (int i = 0; i < 50; i++)
+			m_lines.append(log);
+
+		m_session = std::make_shared<AuthSession>();
+		m_session->session = "token:0123456789abcdef0123456789abcdef:a1b2c3d4e5f60718293a4b5c6d7e8f90";
+		m_session->access_token = "0123456789abcdef0123456789abcdef";
+		m_session->client_token = "fedcba9876543210fedcba9876543210";
+		m_session->uuid = "a1b2c3d4e5f60718293a4b5c6d7e8f90";
+		m_session->player_name = "BenchPlayer";
+		m_session->u.properties.insert("twitch_access_token", "abcdefghijklmnopqrstuvwxyz012345");
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_GuessLevel()
+	{
+		QCOMPARE(MinecraftProcess::guessLevel(m_lines.first(), MessageLevel::Message),
+				 MessageLevel::Message);
+		QBENCHMARK
+		{
+			for (auto &line : m_lines)
+				MinecraftProcess::guessLevel(line, MessageLevel::Message);
+		}
+	}
+	void bench_CensorPrivateInfo()
+	{
+		QString censored = MinecraftProcess::censorPrivateInfo(m_lines.join('\n'), m_session);
+		QVERIFY(!censored.contains("BenchPlayer"));
+		QVERIFY(!censored.contains(m_session->access_token));
+		QBENCHMARK
+		{
+			for (auto &line : m_lines)
+				MinecraftProcess::censorPrivateInfo(line, m_session);
+		}
+	}
+
+private:
+	QStringList m_lines;
+	AuthSessionPtr m_session;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(MinecraftProcessBenchmark)
+
+#include "bench_MinecraftProcess.moc"
@@ -0,0 +1,65 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchmarkUtil.h"
+
+#include "logic/Mod.h"
+
+// mod jars in the folder
+static const int MOD_COUNT = 50;
+
+class ModBenchmark : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+		const QByteArray info = MULTIMC_GET_TEST_FILE("data/mcmod.info");
+		QVERIFY(!info.isEmpty());
+		for (auto classes : {20, 2000})
+		{
+			const QString folder = m_dir.path() + QString("/%1").arg(classes);
+			QVERIFY(QDir().mkpath(folder));
+			for (int i = 0; i < MOD_COUNT; i++)
+			{
+				const QString id = QString("examplemod%1").arg(i);
+				auto files = BenchmarkUtil::fakeClasses("com/example/" + id, classes, 2048);
+				files.insert("mcmod.info", QByteArray(info).replace("examplemod", id.toUtf8()));
+				QVERIFY(BenchmarkUtil::writeZip(folder + "/" + id + ".jar", files));
+			}
+		}
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_ReadJars_data()
+	{
+		QTest::addColumn<int>("classes");
+		QTest::newRow("small jars") << 20;
+		QTest::newRow("big jars") << 2000;
+	}
+	void bench_ReadJars()
+	{
+		QFETCH(int, classes);
+		QDir folder(m_dir.path() + QString("/%1").arg(classes));
+		auto jars = folder.entryInfoList({"*.jar"}, QDir::Files);
+		QCOMPARE(jars.size(), MOD_COUNT);
+		QCOMPARE(Mod(jars.first()).version(), QString("1.7.10-2.3.1"));
+		QBENCHMARK
+		{
+			for (auto &jar : jars)
+				Mod mod(jar);
+		}
+	}
+
+private:
+	QTemporaryDir m_dir;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(ModBenchmark)
+
+#include "bench_Mod.moc"
@@ -0,0 +1,82 @@
+#include <QTest>
+#include <algorithm>
+#include "TestUtil.h"
+
+#include "modutils.h"
+
+class VersionBenchmark : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+		// what the version lists sort: minecraft releases and snapshots, forge and liteloader
+		for (int minor = 0; minor <= 8; minor++)
+		{
+			m_strings.append(QString("1.%1").arg(minor));
+			for (int patch = 1; patch <= 10; patch++)
+				m_strings.append(QString("1.%1.%2").arg(minor).arg(patch));
+		}
+		for (int build = 900; build < 1300; build += 3)
+			m_strings.append(QString("10.13.%1.%2").arg(build % 5).arg(build));
+		for (int week = 1; week < 50; week += 2)
+			m_strings.append(QString("14w%1a").arg(week, 2, 10, QChar('0')));
+		m_strings.append("1.7.10_01");
+		m_strings.append("1.8-pre1");
+		// deterministic shuffle, so sorting has work to do
+		for (int i = 0; i < m_strings.size(); i++)
+			m_strings.swap(i, (i * 7919) % m_strings.size());
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_Parse()
+	{
+		QBENCHMARK
+		{
+			for (auto &string : m_strings)
+				Util::Version version(string);
+		}
+	}
+	void bench_Sort()
+	{
+		QList<Util::Version> versions;
+		for (auto &string : m_strings)
+			versions.append(Util::Version(string));
+		QBENCHMARK
+		{
+			auto sorted = versions;
+			std::sort(sorted.begin(), sorted.end());
+		}
+	}
+	void bench_Equal()
+	{
+		QList<Util::Version> versions;
+		for (auto &string : m_strings)
+			versions.append(Util::Version(string));
+		QBENCHMARK
+		{
+			for (auto &version : versions)
+				for (auto &other : versions)
+					version == other;
+		}
+	}
+	void bench_IsInInterval()
+	{
+		QBENCHMARK
+		{
+			for (auto &string : m_strings)
+				Util::versionIsInInterval(string, "[1.7.2,1.7.10)");
+		}
+	}
+
+private:
+	QStringList m_strings;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(VersionBenchmark)
+
+#include "bench_Version.moc"
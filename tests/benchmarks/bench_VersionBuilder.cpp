@@ -0,0 +1,109 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "TestUtil.h"
+
+#include "logic/OneSixInstance.h"
+#include "logic/minecraft/InstanceVersion.h"
+#include "logic/settings/INISettingsObject.h"
+
+class VersionBuilderBenchmark : public QObject
+{
+	Q_OBJECT
+
+	/// an instance with the fixture version.json and patches, plus extra generated patches
+	QString makeInstance(const QString &name, int extraPatches)
+	{
+		const QString root = m_dir.path() + "/" + name;
+		const QString fixture = QFINDTESTDATA("data/instance");
+		if (!QDir().mkpath(root + "/patches"))
+			return QString();
+		QStringList files = {"version.json"};
+		for (auto patch : QDir(fixture + "/patches").entryList({"*.json"}, QDir::Files))
+			files.append("patches/" + patch);
+		for (auto file : files)
+		{
+			if (!QFile::copy(fixture + "/" + file, root + "/" + file))
+				return QString();
+		}
+
+		// jar mods and library patches, like a modpack would have
+		for (int i = 0; i < extraPatches; i++)
+		{
+			const QString id = QString("org.example.patch%1").arg(i);
+			QJsonArray libraries;
+			for (int j = 0; j < 5; j++)
+			{
+				QJsonObject library;
+				library.insert("name", QString("org.example.patch%1:library%2:1.%3").arg(i).arg(j).arg(i));
+				libraries.append(library);
+			}
+			// every few patches replace a library that is already there
+			if (i % 4 == 0)
+			{
+				QJsonObject library;
+				library.insert("name", QString("com.google.guava:guava:%1.0").arg(17 + i));
+				libraries.append(library);
+			}
+			QJsonObject patch;
+			patch.insert("fileId", id);
+			patch.insert("name", QString("Patch %1").arg(i));
+			patch.insert("version", QString("1.0.%1").arg(i));
+			patch.insert("mcVersion", QString("1.7.10"));
+			patch.insert("order", 20 + i);
+			patch.insert("+libraries", libraries);
+			QFile file(root + "/patches/" + id + ".json");
+			if (!file.open(QIODevice::WriteOnly))
+				return QString();
+			file.write(QJsonDocument(patch).toJson());
+		}
+
+		QFile::copy(QFINDTESTDATA("data/instance.cfg"), root + "/instance.cfg");
+		return root;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_Reload_data()
+	{
+		QTest::addColumn<int>("extraPatches");
+		QTest::newRow("forge and liteloader") << 0;
+		QTest::newRow("40 more patches") << 40;
+	}
+	void bench_Reload()
+	{
+		QFETCH(int, extraPatches);
+		const QString root = makeInstance(QTest::currentDataTag(), extraPatches);
+		QVERIFY(!root.isEmpty());
+
+		OneSixInstance instance(root, new INISettingsObject(root + "/instance.cfg"));
+		QCOMPARE(instance.intendedVersionId(), QString("1.7.10"));
+		InstanceVersion version(&instance);
+		version.reload(QStringList());
+		QCOMPARE(version.VersionPatches.size(), 3 + extraPatches);
+		QVERIFY(version.getActiveNormalLibs().size() > 30);
+
+		QBENCHMARK
+		{
+			version.reload(QStringList());
+		}
+	}
+
+private:
+	QTemporaryDir m_dir;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(VersionBuilderBenchmark)
+
+#include "bench_VersionBuilder.moc"
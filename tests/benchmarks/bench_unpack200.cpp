@@ -0,0 +1,181 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <stdexcept>
+#include "TestUtil.h"
+
+#include <unpack200.h>
+#include <quazip.h>
+
+// pack200 value codings, see the pack200 spec. B bytes at most, H high values per byte
+static void writeCoded(QByteArray &out, quint32 value, int B, int H)
+{
+	const quint32 L = 256 - H;
+	for (int i = 0; i < B; i++)
+	{
+		if (value < L || i == B - 1)
+		{
+			out.append(char(value));
+			return;
+		}
+		value -= L;
+		out.append(char(L + value % H));
+		value /= H;
+	}
+}
+static void writeUnsigned5(QByteArray &out, quint32 value)
+{
+	writeCoded(out, value, 5, 64);
+}
+static void writeSigned5(QByteArray &out, qint32 value)
+{
+	writeUnsigned5(out, value >= 0 ? quint32(value) * 2 : quint32(-value) * 2 - 1);
+}
+static void writeChar3(QByteArray &out, quint32 value)
+{
+	writeCoded(out, value, 3, 128);
+}
+
+/**
+ * A pack200 archive with only resource files in it, no classes.
+ *
+ * There is no packer to make proper fixtures with, but this still runs the band decoding and
+ * jar writing of the unpacker. Every band uses its default coding - the first value of a band
+ * must not look like an escape to another coding, so file names must stay shorter than 192
+ * characters and files must be at least 448 bytes long.
+ */
+static QByteArray makePack(const QMap<QString, QByteArray> &files)
+{
+	QByteArray out("\xca\xfe\xd0\x0d", 4);
+	// java 5 format version, the options say there are file headers and files are deflated
+	writeUnsigned5(out, 7);
+	writeUnsigned5(out, 150);
+	writeUnsigned5(out, (1 << 4) | (1 << 5));
+	// archive size (unknown), next archive count, modification time, file count
+	for (auto value : {0, 0, 0, 0})
+		writeUnsigned5(out, value);
+	writeUnsigned5(out, files.size());
+	// constant pool: the file names are the only strings, plus the implicit empty one
+	writeUnsigned5(out, files.size() + 1);
+	for (int i = 0; i < 7; i++)
+		writeUnsigned5(out, 0);
+	// inner classes, default class version, classes
+	for (int i = 0; i < 4; i++)
+		writeUnsigned5(out, 0);
+
+	// the strings are sent as the length of the prefix shared with the previous one
+	// (delta coded, the first two are implicit), then the suffix lengths and characters
+	QByteArray prefixes, suffixes, chars;
+	QString previous;
+	int previousPrefix = 0;
+	bool first = true;
+	for (auto &name : files.keys())
+	{
+		int prefix = 0;
+		while (prefix < qMin(name.size(), previous.size()) && name[prefix] == previous[prefix])
+			prefix++;
+		if (first)
+			prefix = 0;
+		else
+			writeSigned5(prefixes, prefix - previousPrefix);
+		previousPrefix = first ? 0 : prefix;
+		writeUnsigned5(suffixes, name.size() - prefix);
+		for (int i = prefix; i < name.size(); i++)
+			writeChar3(chars, name[i].unicode());
+		previous = name;
+		first = false;
+	}
+	out += prefixes + suffixes + chars;
+
+	// file names (constant pool indexes), sizes and then the contents
+	for (int i = 0; i < files.size(); i++)
+		writeUnsigned5(out, i + 1);
+	for (auto &data : files)
+		writeUnsigned5(out, data.size());
+	for (auto &data : files)
+		out += data;
+	return out;
+}
+
+class Unpack200Benchmark : public QObject
+{
+	Q_OBJECT
+
+	void unpack(const QString &from, const QString &to)
+	{
+		FILE *input = fopen(QFile::encodeName(from).constData(), "rb");
+		FILE *output = fopen(QFile::encodeName(to).constData(), "wb");
+		QVERIFY(input && output);
+		try
+		{
+			// closes both files when it's done
+			unpack_200(input, output);
+		}
+		catch (std::runtime_error &err)
+		{
+			fclose(input);
+			QFAIL(err.what());
+		}
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+		// the resources of a big mod: language files, models, configs
+		const QList<QByteArray> words = {"block", "item", "entity", "render", "texture", "model",
+										 "sound", "lang", "tooltip", "name", "desc"};
+		QMap<QString, QByteArray> files;
+		for (int i = 0; i < 1000; i++)
+		{
+			QByteArray data;
+			for (int line = 0; line < 30; line++)
+			{
+				data += words[(i + line) % words.size()] + "." + words[(i * line) % words.size()] +
+						"." + QByteArray::number(line) + "=";
+				for (int word = 0; word < 6; word++)
+					data += words[(i * 31 + line * 7 + word * 3) % words.size()] + " ";
+				data += "\n";
+			}
+			files.insert(QString("assets/examplemod/%1/%2_%3.properties")
+							 .arg(QString::fromLatin1(words[i % words.size()]),
+								  QString::fromLatin1(words[(i * 7) % words.size()]))
+							 .arg(i, 4, 10, QChar('0')),
+						 data);
+		}
+		m_pack = m_dir.path() + "/resources.pack";
+		QFile pack(m_pack);
+		QVERIFY(pack.open(QIODevice::WriteOnly));
+		pack.write(makePack(files));
+		pack.close();
+
+		// make sure the unpacker agrees with what we think we packed
+		const QString jar = m_dir.path() + "/check.jar";
+		unpack(m_pack, jar);
+		QuaZip zip(jar);
+		QVERIFY(zip.open(QuaZip::mdUnzip));
+		QCOMPARE(zip.getEntriesCount(), files.size());
+		QVERIFY(zip.setCurrentFile(files.lastKey()));
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void bench_Unpack()
+	{
+		const QString jar = m_dir.path() + "/resources.jar";
+		QBENCHMARK
+		{
+			unpack(m_pack, jar);
+		}
+	}
+
+private:
+	QTemporaryDir m_dir;
+	QString m_pack;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(Unpack200Benchmark)
+
+#include "bench_unpack200.moc"
@@ -0,0 +1,99 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <memory>
+#include "TestUtil.h"
+
+#include "logic/assets/AssetsUtils.h"
+#include "logic/assets/AssetsMigrateTask.h"
+
+class AssetsMigrateTest : public QObject
+{
+	Q_OBJECT
+private:
+	void writeFile(const QString &path, const QByteArray &data)
+	{
+		QDir().mkpath(QFileInfo(path).path());
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write(data);
+	}
+	QString objectPath(const QByteArray &data)
+	{
+		const QString sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+		return "assets/objects/" + sha1.left(2) + "/" + sha1;
+	}
+
+private
+slots:
+	void init()
+	{
+		m_oldCwd = QDir::currentPath();
+		m_dir.reset(new QTemporaryDir);
+		QVERIFY(m_dir->isValid());
+		QDir::setCurrent(m_dir->path());
+	}
+	void cleanup()
+	{
+		QDir::setCurrent(m_oldCwd);
+		m_dir.reset();
+	}
+
+	void test_FindNothing()
+	{
+		QVERIFY(AssetsUtils::findLegacyAssets().isEmpty());
+		QDir().mkpath("assets/indexes");
+		QDir().mkpath("assets/objects/ab");
+		QDir().mkpath("assets/virtual/legacy/sounds");
+		QVERIFY(AssetsUtils::findLegacyAssets().isEmpty());
+	}
+
+	void test_Migrate()
+	{
+		QDir().mkpath("assets/indexes");
+		writeFile("assets/sounds/step/grass1.ogg", "grass");
+		writeFile("assets/sounds/step/grass2.ogg", "grass");
+		writeFile("assets/music/calm1.ogg", "calm");
+		writeFile("assets/pack.png", "pack");
+		// an object that is already there
+		writeFile(objectPath("calm"), "calm");
+
+		auto legacy = AssetsUtils::findLegacyAssets();
+		legacy.sort();
+		QCOMPARE(legacy, QStringList() << "music" << "pack.png" << "sounds");
+
+		AssetsMigrateTask task(legacy);
+		QSignalSpy succeeded(&task, SIGNAL(succeeded()));
+		task.start();
+		QCOMPARE(succeeded.count(), 1);
+
+		QVERIFY(QFile::exists(objectPath("grass")));
+		QVERIFY(QFile::exists(objectPath("calm")));
+		QVERIFY(QFile::exists(objectPath("pack")));
+		QVERIFY(!QFile::exists("assets/sounds"));
+		QVERIFY(!QFile::exists("assets/pack.png"));
+		QVERIFY(AssetsUtils::findLegacyAssets().isEmpty());
+	}
+
+	void test_Marked()
+	{
+		writeFile("assets/sounds/broken.ogg", "broken");
+		QCOMPARE(AssetsUtils::findLegacyAssets(), QStringList() << "sounds");
+		AssetsUtils::markLegacyAssets(QStringList() << "sounds");
+		QVERIFY(AssetsUtils::findLegacyAssets().isEmpty());
+		writeFile("assets/lang/en_US.lang", "lang");
+		QCOMPARE(AssetsUtils::findLegacyAssets(), QStringList() << "lang");
+	}
+
+private:
+	QString m_oldCwd;
+	std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(AssetsMigrateTest)
+
+#include "tst_AssetsMigrate.moc"
@@ -0,0 +1,193 @@
+#include <QTest>
+#include <QThread>
+#include <functional>
+#include "TestUtil.h"
+
+#include "logic/ConcurrentCache.h"
+
+typedef ConcurrentCache<QString, int> Cache;
+
+class Worker : public QThread
+{
+public:
+	explicit Worker(std::function<void()> work) : m_work(work)
+	{
+	}
+
+protected:
+	void run() override
+	{
+		m_work();
+	}
+
+private:
+	std::function<void()> m_work;
+};
+
+// run the work on this many threads at once and wait for all of them
+static void runParallel(int threads, std::function<void(int)> work)
+{
+	QList<Worker *> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.append(new Worker([work, i]() { work(i); }));
+	}
+	for (auto worker : workers)
+	{
+		worker->start();
+	}
+	for (auto worker : workers)
+	{
+		worker->wait();
+	}
+	qDeleteAll(workers);
+}
+
+class ConcurrentCacheTest : public QObject
+{
+	Q_OBJECT
+private:
+	// what a thumbnail pool and a view do: insert, look up, mark stale, all at once
+	static void hammer(Cache *cache, int seed, int iterations)
+	{
+		qsrand(seed);
+		for (int i = 0; i < iterations; i++)
+		{
+			QString key = QString::number(qrand() % 500);
+			switch (qrand() % 4)
+			{
+			case 0:
+				cache->insert(key, key.toInt(), 1 + qrand() % 3);
+				break;
+			case 1:
+				cache->setStale(key);
+				break;
+			default:
+			{
+				int value;
+				if (cache->get(key, value) && value != key.toInt())
+					qFatal("Wrong value for key %s", qPrintable(key));
+			}
+			}
+		}
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_Basic()
+	{
+		Cache cache(100, 4);
+		int value = 0;
+		QVERIFY(!cache.get("a", value));
+		QVERIFY(cache.stale("a"));
+
+		cache.insert("a", 1);
+		QVERIFY(cache.contains("a"));
+		QVERIFY(!cache.stale("a"));
+		QVERIFY(cache.get("a", value));
+		QCOMPARE(value, 1);
+
+		cache.setStale("a");
+		QVERIFY(cache.stale("a"));
+		QCOMPARE(cache.get("a"), 1);
+		cache.insert("a", 2);
+		QVERIFY(!cache.stale("a"));
+		QCOMPARE(cache.get("a"), 2);
+
+		// marking something that isn't there does nothing
+		cache.setStale("b");
+		QVERIFY(!cache.contains("b"));
+
+		QVERIFY(cache.remove("a"));
+		QVERIFY(!cache.remove("a"));
+		QVERIFY(!cache.contains("a"));
+
+		auto stats = cache.stats();
+		QCOMPARE(stats.hits, qint64(3));
+		QCOMPARE(stats.misses, qint64(1));
+		QCOMPARE(stats.count, 0);
+		QCOMPARE(stats.cost, 0);
+	}
+
+	void test_LeastRecentlyUsedGoesFirst()
+	{
+		Cache cache(3, 1);
+		cache.insert("a", 1);
+		cache.insert("b", 2);
+		cache.insert("c", 3);
+		cache.get("a");
+		cache.insert("d", 4);
+		QVERIFY(cache.contains("a"));
+		QVERIFY(!cache.contains("b"));
+		QVERIFY(cache.contains("c"));
+		QVERIFY(cache.contains("d"));
+
+		// expensive entries push out more than one
+		cache.insert("e", 5, 2);
+		QCOMPARE(cache.stats().cost, 3);
+		QVERIFY(cache.contains("e"));
+		QCOMPARE(cache.stats().evictions, qint64(3));
+
+		// an entry over the budget stays until the next one comes in
+		cache.insert("huge", 6, 10);
+		QVERIFY(cache.contains("huge"));
+		QCOMPARE(cache.stats().count, 1);
+
+		cache.clear();
+		QCOMPARE(cache.stats().count, 0);
+	}
+
+	void test_Stress()
+	{
+		const int threads = qMax(4, QThread::idealThreadCount());
+		static const int iterations = 50000;
+		Cache cache(300, 16);
+		runParallel(threads, [&cache](int seed) { hammer(&cache, seed, iterations); });
+		auto stats = cache.stats();
+		QVERIFY(stats.hits > 0);
+		// every shard may hold one entry over its share of the budget
+		QVERIFY(stats.cost <= 300 + 16 * 3);
+		QVERIFY(stats.count <= stats.cost);
+	}
+
+	void bench_ParallelGet_data()
+	{
+		QTest::addColumn<int>("shards");
+		QTest::newRow("1 shard") << 1;
+		QTest::newRow("16 shards") << 16;
+	}
+	void bench_ParallelGet()
+	{
+		QFETCH(int, shards);
+		Cache cache(1000, shards);
+		for (int i = 0; i < 500; i++)
+		{
+			cache.insert(QString::number(i), i);
+		}
+		const int threads = qMax(4, QThread::idealThreadCount());
+		QBENCHMARK
+		{
+			runParallel(threads, [&cache](int t)
+			{
+				int value;
+				for (int i = 0; i < 20000; i++)
+				{
+					cache.get(QString::number((i * 7 + t) % 500), value);
+				}
+			});
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(ConcurrentCacheTest)
+
+#include "tst_ConcurrentCache.moc"
@@ -0,0 +1,158 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "logic/tasks/CopyDirectoryTask.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+class CopyDirectoryTaskTest : public QObject
+{
+	Q_OBJECT
+private:
+	void writeFile(const QString &path, const QByteArray &data)
+	{
+		QDir().mkpath(QFileInfo(path).path());
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		QCOMPARE(file.write(data), (qint64)data.size());
+	}
+	QByteArray readFile(const QString &path)
+	{
+		QFile file(path);
+		if (!file.open(QIODevice::ReadOnly))
+			return QByteArray();
+		return file.readAll();
+	}
+	bool sameFile(const QString &a, const QString &b)
+	{
+#ifdef Q_OS_UNIX
+		struct stat statA, statB;
+		if (::stat(QFile::encodeName(a).constData(), &statA) != 0 ||
+			::stat(QFile::encodeName(b).constData(), &statB) != 0)
+			return false;
+		return statA.st_dev == statB.st_dev && statA.st_ino == statB.st_ino;
+#else
+		return false;
+#endif
+	}
+	QString src()
+	{
+		return m_dir.path() + "/" + QTest::currentTestFunction() + "/src";
+	}
+	QString dst()
+	{
+		return m_dir.path() + "/" + QTest::currentTestFunction() + "/dst";
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+#ifndef Q_OS_UNIX
+		QSKIP("The links are made with unix calls");
+#endif
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_CopyWithSymlinks()
+	{
+		const QByteArray big(3 * 1024 * 1024, 'b');
+		writeFile(src() + "/options.txt", "fov:70\n");
+		writeFile(src() + "/saves/world/level.dat", big);
+		writeFile(src() + "/empty.txt", QByteArray());
+		writeFile(m_dir.path() + "/outside.txt", "outside");
+		QVERIFY(QFile::link("options.txt", src() + "/relative"));
+		QVERIFY(QFile::link(src() + "/saves/world/level.dat", src() + "/absolute"));
+		QVERIFY(QFile::link(m_dir.path() + "/outside.txt", src() + "/outside"));
+
+		CopyDirectoryTask task(src(), dst());
+		QList<qint64> progress;
+		connect(&task, &Task::progress, [&](qint64 current, qint64)
+		{ progress.append(current); });
+		task.start();
+		QTRY_VERIFY(!task.isRunning());
+		QVERIFY2(task.successful(), qPrintable(task.failReason()));
+
+		QCOMPARE(readFile(dst() + "/options.txt"), QByteArray("fov:70\n"));
+		QCOMPARE(readFile(dst() + "/saves/world/level.dat"), big);
+		QVERIFY(QFileInfo(dst() + "/empty.txt").isFile());
+
+		// relative links are kept, absolute ones into the tree point into the copy
+		QVERIFY(QFileInfo(dst() + "/relative").isSymLink());
+		QCOMPARE(QFileInfo(dst() + "/relative").symLinkTarget(),
+				 QFileInfo(dst() + "/options.txt").absoluteFilePath());
+		QCOMPARE(QFileInfo(dst() + "/absolute").symLinkTarget(),
+				 QFileInfo(dst() + "/saves/world/level.dat").absoluteFilePath());
+		QCOMPARE(QFileInfo(dst() + "/outside").symLinkTarget(),
+				 QFileInfo(m_dir.path() + "/outside.txt").absoluteFilePath());
+
+		// progress goes by bytes, so it never moves backwards or past the end
+		for (int i = 1; i < progress.size(); i++)
+		{
+			QVERIFY(progress[i - 1] <= progress[i]);
+		}
+		QVERIFY(progress.isEmpty() || progress.last() <= 100);
+	}
+
+	void test_HardlinkedMods()
+	{
+		writeFile(src() + "/mods/SomeMod.jar", "a mod");
+		writeFile(src() + "/config/SomeMod.cfg", "enabled=true\n");
+
+		CopyDirectoryTask task(src(), dst());
+		task.setHardlinkFilter(QRegularExpression("^mods/"));
+		task.start();
+		QTRY_VERIFY(!task.isRunning());
+		QVERIFY2(task.successful(), qPrintable(task.failReason()));
+
+		QCOMPARE(readFile(dst() + "/mods/SomeMod.jar"), QByteArray("a mod"));
+		QCOMPARE(readFile(dst() + "/config/SomeMod.cfg"), QByteArray("enabled=true\n"));
+		// files outside of the filter are never shared
+		QVERIFY(!sameFile(src() + "/config/SomeMod.cfg", dst() + "/config/SomeMod.cfg"));
+		if (!sameFile(src() + "/mods/SomeMod.jar", dst() + "/mods/SomeMod.jar"))
+			QSKIP("The filesystem reflinks, so nothing is hardlinked");
+	}
+
+	void test_MissingSource()
+	{
+		CopyDirectoryTask task(src(), dst());
+		task.start();
+		QTRY_VERIFY(!task.isRunning());
+		QVERIFY(!task.successful());
+		QVERIFY(task.failReason().contains(src()));
+		QVERIFY(!QFile::exists(dst()));
+	}
+
+	void test_FailedFile()
+	{
+		writeFile(src() + "/good.txt", "good");
+		writeFile(src() + "/taken.txt", "new");
+		// a file in the way can't be replaced
+		writeFile(dst() + "/taken.txt", "old");
+
+		CopyDirectoryTask task(src(), dst());
+		QSignalSpy failed(&task, SIGNAL(failed(QString)));
+		task.start();
+		QTRY_VERIFY(!task.isRunning());
+		QCOMPARE(failed.count(), 1);
+		QVERIFY(failed.first().first().toString().contains("taken.txt"));
+		QCOMPARE(readFile(dst() + "/taken.txt"), QByteArray("old"));
+		QCOMPARE(readFile(dst() + "/good.txt"), QByteArray("good"));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(CopyDirectoryTaskTest)
+
+#include "tst_CopyDirectoryTask.moc"
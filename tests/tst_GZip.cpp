@@ -0,0 +1,115 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include "TestUtil.h"
+
+#include "logic/GZip.h"
+
+class GZipTest : public QObject
+{
+	Q_OBJECT
+private:
+	QByteArray logLines(int count)
+	{
+		QByteArray data;
+		for (int i = 0; i < count; i++)
+		{
+			data += "[INFO] line " + QByteArray::number(i) + " of a launcher log\n";
+		}
+		return data;
+	}
+	void writeFile(const QString &path, const QByteArray &data)
+	{
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		QCOMPARE(file.write(data), (qint64)data.size());
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_RoundTrip_data()
+	{
+		QTest::addColumn<QByteArray>("data");
+		QTest::newRow("empty") << QByteArray();
+		QTest::newRow("short") << QByteArray("hello");
+		// grows the output buffer of unzip several times
+		QTest::newRow("log") << logLines(20000);
+	}
+	void test_RoundTrip()
+	{
+		QFETCH(QByteArray, data);
+		QByteArray compressed, uncompressed;
+		QVERIFY(GZip::zip(data, compressed));
+		QVERIFY(GZip::unzip(compressed, uncompressed));
+		QCOMPARE(uncompressed, data);
+	}
+
+	void test_ConcatenatedMembers()
+	{
+		QByteArray first, second, uncompressed;
+		QVERIFY(GZip::zip("first\n", first));
+		QVERIFY(GZip::zip("second\n", second));
+		QVERIFY(GZip::unzip(first + second, uncompressed));
+		QCOMPARE(uncompressed, QByteArray("first\nsecond\n"));
+	}
+
+	void test_Corrupt()
+	{
+		QByteArray compressed, uncompressed;
+		QVERIFY(GZip::zip(logLines(100), compressed));
+		QVERIFY(!GZip::unzip(compressed.left(compressed.size() / 2), uncompressed));
+	}
+
+	void test_ZipFile()
+	{
+		// more than one chunk
+		const QByteArray data = logLines(5000);
+		const QString source = m_dir.path() + "/segment.log";
+		writeFile(source, data);
+		QVERIFY(GZip::zipFile(source, source + ".gz"));
+
+		QFile target(source + ".gz");
+		QVERIFY(target.open(QIODevice::ReadOnly));
+		QVERIFY(target.size() < data.size());
+		QByteArray uncompressed;
+		QVERIFY(GZip::unzip(target.readAll(), uncompressed));
+		QCOMPARE(uncompressed, data);
+	}
+
+	void test_ReadFile()
+	{
+		const QByteArray data = logLines(100);
+		writeFile(m_dir.path() + "/plain.log", data);
+		QByteArray compressed;
+		QVERIFY(GZip::zip(data, compressed));
+		writeFile(m_dir.path() + "/packed.log.gz", compressed);
+
+		QByteArray read;
+		QVERIFY(GZip::readFile(m_dir.path() + "/plain.log", read));
+		QCOMPARE(read, data);
+		QVERIFY(GZip::readFile(m_dir.path() + "/packed.log.gz", read));
+		QCOMPARE(read, data);
+		QVERIFY(!GZip::readFile(m_dir.path() + "/missing.log.gz", read));
+	}
+
+	void test_ZipFileMissingSource()
+	{
+		const QString target = m_dir.path() + "/missing.log.gz";
+		QVERIFY(!GZip::zipFile(m_dir.path() + "/missing.log", target));
+		QVERIFY(!QFile::exists(target));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(GZipTest)
+
+#include "tst_GZip.moc"
@@ -0,0 +1,149 @@
+#include <QTest>
+#include <QStandardItemModel>
+#include <QPixmap>
+#include "TestUtil.h"
+
+#include "gui/groupview/GroupView.h"
+#include "gui/groupview/InstanceDelegate.h"
+
+class GroupViewTest : public QObject
+{
+	Q_OBJECT
+private:
+	void fill(QStandardItemModel &model, int count, int groups)
+	{
+		model.clear();
+		for (int i = 0; i < count; i++)
+		{
+			auto item = new QStandardItem(QString("Instance %1").arg(i));
+			item->setData(QString("Group %1").arg(i % groups), GroupViewRoles::GroupRole);
+			model.appendRow(item);
+		}
+	}
+	void setup(GroupView &view, QStandardItemModel &model)
+	{
+		view.setItemDelegate(new ListViewDelegate(&view));
+		view.setModel(&model);
+		view.resize(800, 600);
+		// the layout depends on the width, which the view learns from the resize event
+		view.show();
+		view.doItemsLayout();
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_IndexAtMatchesVisualRect()
+	{
+		QStandardItemModel model;
+		fill(model, 200, 7);
+		GroupView view;
+		setup(view, model);
+
+		int visible = 0;
+		for (int row = 0; row < model.rowCount(); row++)
+		{
+			auto index = model.index(row, 0);
+			QRect rect = view.visualRect(index);
+			QVERIFY(rect.isValid());
+			if (!view.viewport()->rect().contains(rect.center()))
+				continue;
+			visible++;
+			QCOMPARE(view.indexAt(rect.center()), index);
+		}
+		QVERIFY(visible > 0);
+		QVERIFY(!view.indexAt(QPoint(-10, -10)).isValid());
+	}
+
+	void test_RegroupOnDataChanged()
+	{
+		QStandardItemModel model;
+		fill(model, 20, 2);
+		GroupView view;
+		setup(view, model);
+
+		QRect before = view.visualRect(model.index(0, 0));
+		model.setData(model.index(0, 0), "Group 1", GroupViewRoles::GroupRole);
+		view.doItemsLayout();
+		QRect after = view.visualRect(model.index(0, 0));
+		// 'Group 1' comes after 'Group 0', which lost its first item
+		QVERIFY(after.top() > before.top());
+		QCOMPARE(view.indexAt(after.center()), model.index(0, 0));
+	}
+
+	void test_RowsInsertedAndRemoved()
+	{
+		QStandardItemModel model;
+		fill(model, 10, 1);
+		GroupView view;
+		setup(view, model);
+
+		auto item = new QStandardItem("Inserted");
+		item->setData("Group 0", GroupViewRoles::GroupRole);
+		model.insertRow(0, item);
+		view.doItemsLayout();
+		QCOMPARE(view.indexAt(view.visualRect(model.index(0, 0)).center()), model.index(0, 0));
+		QCOMPARE(view.indexAt(view.visualRect(model.index(10, 0)).center()), model.index(10, 0));
+
+		model.removeRows(0, 5);
+		view.doItemsLayout();
+		for (int row = 0; row < model.rowCount(); row++)
+		{
+			auto index = model.index(row, 0);
+			QCOMPARE(view.indexAt(view.visualRect(index).center()), index);
+		}
+	}
+
+	void bench_Paint_data()
+	{
+		QTest::addColumn<int>("count");
+		QTest::newRow("50 instances") << 50;
+		QTest::newRow("500 instances") << 500;
+		QTest::newRow("2000 instances") << 2000;
+	}
+	void bench_Paint()
+	{
+		QFETCH(int, count);
+		QStandardItemModel model;
+		fill(model, count, 10);
+		GroupView view;
+		setup(view, model);
+		QPixmap target(view.viewport()->size());
+		QBENCHMARK
+		{
+			view.viewport()->render(&target);
+		}
+	}
+
+	void bench_Relayout_data()
+	{
+		bench_Paint_data();
+	}
+	void bench_Relayout()
+	{
+		QFETCH(int, count);
+		QStandardItemModel model;
+		fill(model, count, 10);
+		GroupView view;
+		setup(view, model);
+		int i = 0;
+		QBENCHMARK
+		{
+			// what a running instance does - one item changes
+			model.setData(model.index(i++ % count, 0), QString("Renamed %1").arg(i));
+			view.doItemsLayout();
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(GroupViewTest)
+
+#include "tst_GroupView.moc"
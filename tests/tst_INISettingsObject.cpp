@@ -0,0 +1,117 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include "TestUtil.h"
+
+#include "logic/settings/INISettingsObject.h"
+#include "logic/settings/INIFile.h"
+
+class INISettingsObjectTest : public QObject
+{
+	Q_OBJECT
+private:
+	QString path()
+	{
+		return m_dir.path() + "/" + QTest::currentTestFunction() + ".cfg";
+	}
+	void writeFile(const QByteArray &data)
+	{
+		QFile file(path());
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write(data);
+	}
+	/// what a fresh reader would see in the file
+	QVariant onDisk(const QString &key)
+	{
+		INIFile ini;
+		ini.loadFile(path());
+		return ini.get(key, QVariant());
+	}
+	void registerSettings(INISettingsObject &settings)
+	{
+		settings.registerSetting("Name", "default");
+		settings.registerSetting("MinMemAlloc", 512);
+		settings.registerSetting("MaxMemAlloc", 1024);
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_Batching()
+	{
+		writeFile("Name=old\n");
+		const QByteArray original = TestsInternal::readFile(path());
+		INISettingsObject settings(path());
+		registerSettings(settings);
+
+		settings.set("Name", "new");
+		settings.set("MinMemAlloc", 1024);
+		settings.set("MaxMemAlloc", 4096);
+		QCOMPARE(settings.get("Name").toString(), QString("new"));
+		// nothing is written right away
+		QCOMPARE(TestsInternal::readFile(path()), original);
+
+		QVERIFY(settings.saveNow());
+		QCOMPARE(onDisk("Name").toString(), QString("new"));
+		QCOMPARE(onDisk("MinMemAlloc").toInt(), 1024);
+		QCOMPARE(onDisk("MaxMemAlloc").toInt(), 4096);
+
+		// without saveNow, the timer writes them
+		settings.set("Name", "later");
+		settings.reset("MaxMemAlloc");
+		QCOMPARE(onDisk("Name").toString(), QString("new"));
+		QTRY_COMPARE(onDisk("Name").toString(), QString("later"));
+		QVERIFY(!onDisk("MaxMemAlloc").isValid());
+	}
+
+	void test_FlushAll()
+	{
+		INISettingsObject settings(path());
+		registerSettings(settings);
+		settings.set("Name", "flushed");
+		QVERIFY(!QFile::exists(path()));
+		INISettingsObject::flushAll();
+		QCOMPARE(onDisk("Name").toString(), QString("flushed"));
+	}
+
+	void test_SavedOnDestruction()
+	{
+		{
+			INISettingsObject settings(path());
+			registerSettings(settings);
+			settings.set("Name", "destroyed");
+		}
+		QCOMPARE(onDisk("Name").toString(), QString("destroyed"));
+	}
+
+	void test_ReloadKeepsPending()
+	{
+		writeFile("Name=old\nMinMemAlloc=256\n");
+		INISettingsObject settings(path());
+		registerSettings(settings);
+		settings.set("Name", "pending");
+
+		QVERIFY(settings.reload());
+		QCOMPARE(settings.get("Name").toString(), QString("pending"));
+		QCOMPARE(settings.get("MinMemAlloc").toInt(), 256);
+		QCOMPARE(onDisk("Name").toString(), QString("pending"));
+
+		// with nothing pending, a reload picks up what changed on disk
+		writeFile("Name=edited\nMinMemAlloc=256\n");
+		QVERIFY(settings.reload());
+		QCOMPARE(settings.get("Name").toString(), QString("edited"));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(INISettingsObjectTest)
+
+#include "tst_INISettingsObject.moc"
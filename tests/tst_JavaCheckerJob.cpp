@@ -0,0 +1,128 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include "TestUtil.h"
+
+#include "logic/java/JavaCheckerJob.h"
+
+class JavaCheckerJobTest : public QObject
+{
+	Q_OBJECT
+private:
+	// a fake java that reports being a JVM after sleeping for a while
+	QString makeJava(const QString &name, const QString &sleep)
+	{
+		const QString path = m_dir.path() + "/" + name;
+		QFile script(path);
+		if (!script.open(QIODevice::WriteOnly))
+			return QString();
+		script.write(QString("#!/bin/sh\n"
+							 "touch \"%1/running-$$\"\n"
+							 "ls \"%1\" | grep -c running- >> \"%1/concurrency\"\n"
+							 "sleep %2\n"
+							 "rm \"%1/running-$$\"\n"
+							 "echo os.arch=amd64\n"
+							 "echo java.version=1.8.0\n").arg(m_dir.path(), sleep).toUtf8());
+		script.close();
+		script.setPermissions(script.permissions() | QFile::ExeOwner);
+		return path;
+	}
+	void addJavas(JavaCheckerJob &job, const QString &prefix, int count, const QString &sleep)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			auto checker = new JavaChecker();
+			checker->path = makeJava(prefix + QString::number(i), sleep);
+			checker->id = i;
+			job.addJavaCheckerAction(JavaCheckerPtr(checker));
+		}
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+#ifndef Q_OS_UNIX
+		QSKIP("The fake java binaries are shell scripts");
+#endif
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_ConcurrencyAndStreaming()
+	{
+		JavaCheckerJob job("test", 2);
+		addJavas(job, "limited", 6, "0.3");
+		QSignalSpy finished(&job, SIGNAL(finished(QList<JavaCheckResult>)));
+		QList<JavaCheckResult> results;
+		connect(&job, &JavaCheckerJob::finished, [&](QList<JavaCheckResult> all)
+		{
+			results = all;
+		});
+		QList<int> finishedBeforeResult;
+		connect(&job, &JavaCheckerJob::resultAvailable, [&](JavaCheckResult)
+		{
+			finishedBeforeResult.append(finished.count());
+		});
+
+		job.start();
+		QVERIFY(finished.count() || finished.wait(20000));
+
+		// every result came in on its own, before the job was done
+		QCOMPARE(finishedBeforeResult, QList<int>() << 0 << 0 << 0 << 0 << 0 << 0);
+		QCOMPARE(results.size(), 6);
+		for (auto result : results)
+		{
+			QVERIFY(result.valid);
+		}
+		int maxRunning = 0;
+		for (auto line : TestsInternal::readFile(m_dir.path() + "/concurrency").split('\n'))
+		{
+			maxRunning = qMax(maxRunning, line.toInt());
+		}
+		QVERIFY(maxRunning >= 1);
+		QVERIFY(maxRunning <= 2);
+	}
+
+	void test_Abort()
+	{
+		JavaCheckerJob job("test", 2);
+		addJavas(job, "stuck", 4, "30");
+		QSignalSpy finished(&job, SIGNAL(finished(QList<JavaCheckResult>)));
+		QSignalSpy available(&job, SIGNAL(resultAvailable(JavaCheckResult)));
+		QList<JavaCheckResult> results;
+		connect(&job, &JavaCheckerJob::finished, [&](QList<JavaCheckResult> all)
+		{
+			results = all;
+		});
+		job.start();
+		QTest::qWait(500);
+		QVERIFY(job.isRunning());
+
+		QElapsedTimer timer;
+		timer.start();
+		job.abort();
+		QVERIFY(timer.elapsed() < 5000);
+		QCOMPARE(finished.count(), 1);
+		QCOMPARE(available.count(), 4);
+		QCOMPARE(results.size(), 4);
+		QVERIFY(!job.isRunning());
+		for (auto result : results)
+		{
+			QVERIFY(!result.valid);
+		}
+		// nothing comes in late
+		QTest::qWait(500);
+		QCOMPARE(finished.count(), 1);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(JavaCheckerJobTest)
+
+#include "tst_JavaCheckerJob.moc"
@@ -0,0 +1,85 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include "TestUtil.h"
+
+#include "logic/java/JavaDiscovery.h"
+
+class JavaDiscoveryTest : public QObject
+{
+	Q_OBJECT
+private:
+	void makeJava(const QString &path)
+	{
+		QDir().mkpath(QFileInfo(path).path());
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write("#!/bin/sh\n");
+		file.close();
+		QVERIFY(file.setPermissions(file.permissions() | QFile::ExeOwner));
+	}
+	QStringList discover()
+	{
+		JavaDiscovery discovery(m_dir.path() + "/index.json");
+		discovery.addRoot(m_dir.path() + "/jvm");
+		discovery.addRoot(m_dir.path() + "/missing");
+		QStringList javas = discovery.discover();
+		for (auto &java : javas)
+		{
+			java = QDir(m_dir.path()).relativeFilePath(java);
+		}
+		javas.sort();
+		return javas;
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+#ifndef Q_OS_UNIX
+		QSKIP("The fake java binaries rely on unix permissions");
+#endif
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_Discover()
+	{
+		// an old JDK with a bundled JRE, a new JDK, a plain JRE and something else
+		makeJava(m_dir.path() + "/jvm/jdk8/bin/java");
+		makeJava(m_dir.path() + "/jvm/jdk8/jre/bin/java");
+		makeJava(m_dir.path() + "/jvm/jdk11/bin/java");
+		makeJava(m_dir.path() + "/jvm/jre7/jre/bin/java");
+		QDir().mkpath(m_dir.path() + "/jvm/docs/api");
+
+		QCOMPARE(discover(), QStringList() << "jvm/jdk11/bin/java"
+										   << "jvm/jdk8/bin/java"
+										   << "jvm/jre7/jre/bin/java");
+		QVERIFY(QFile::exists(m_dir.path() + "/index.json"));
+	}
+
+	void test_UpdateInsideInstall()
+	{
+		// only changes inside an install folder, the root itself stays the same
+		QTest::qWait(20);
+		makeJava(m_dir.path() + "/jvm/jre7/bin/java");
+		QCOMPARE(discover(), QStringList() << "jvm/jdk11/bin/java"
+										   << "jvm/jdk8/bin/java"
+										   << "jvm/jre7/bin/java");
+
+		QTest::qWait(20);
+		QVERIFY(QFile::remove(m_dir.path() + "/jvm/jdk11/bin/java"));
+		QCOMPARE(discover(), QStringList() << "jvm/jdk8/bin/java"
+										   << "jvm/jre7/bin/java");
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(JavaDiscoveryTest)
+
+#include "tst_JavaDiscovery.moc"
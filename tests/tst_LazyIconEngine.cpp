@@ -0,0 +1,110 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QImage>
+#include <QPainter>
+#include <QIcon>
+#include <QFile>
+#include "TestUtil.h"
+
+#include "logic/icons/LazyIconEngine.h"
+
+class LazyIconEngineTest : public QObject
+{
+	Q_OBJECT
+private:
+	QString makeImage(const QString &name, QSize size, QColor color)
+	{
+		QString path = m_dir.path() + "/" + name;
+		QImage image(size, QImage::Format_ARGB32);
+		image.fill(color);
+		image.save(path, "png");
+		return path;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_CanLoad()
+	{
+		QVERIFY(LazyIconEngine::canLoad("/some/where/icon.png"));
+		QVERIFY(LazyIconEngine::canLoad("/some/where/icon.PNG"));
+		QVERIFY(!LazyIconEngine::canLoad("/some/where/notes.txt"));
+		QVERIFY(!LazyIconEngine::canLoad("/some/where/noextension"));
+	}
+
+	void test_ActualSize()
+	{
+		QString path = makeImage("wide.png", QSize(128, 64), Qt::red);
+		QIcon icon(new LazyIconEngine(path, 0));
+		QCOMPARE(icon.availableSizes(), QList<QSize>() << QSize(128, 64));
+		// scaled down keeping the aspect ratio
+		QCOMPARE(icon.actualSize(QSize(32, 32)), QSize(32, 16));
+		// never scaled up
+		QCOMPARE(icon.actualSize(QSize(256, 256)), QSize(128, 64));
+	}
+
+	void test_Pixmap()
+	{
+		QString path = makeImage("square.png", QSize(256, 256), Qt::blue);
+		QIcon icon(new LazyIconEngine(path, 0));
+		QPixmap small = icon.pixmap(48, 48);
+		QCOMPARE(small.size(), QSize(48, 48));
+		QCOMPARE(QColor(small.toImage().pixel(24, 24)), QColor(Qt::blue));
+		// the same size comes out of the cache
+		QCOMPARE(icon.pixmap(48, 48).cacheKey(), small.cacheKey());
+		QVERIFY(!icon.pixmap(48, 48, QIcon::Disabled).isNull());
+	}
+
+	void test_Changed()
+	{
+		QString path = makeImage("changed.png", QSize(64, 64), Qt::green);
+		QIcon before(new LazyIconEngine(path, 1));
+		QCOMPARE(QColor(before.pixmap(32, 32).toImage().pixel(16, 16)), QColor(Qt::green));
+
+		// a new modification time must not pick up the old pixmap
+		makeImage("changed.png", QSize(64, 64), Qt::yellow);
+		QIcon after(new LazyIconEngine(path, 2));
+		QCOMPARE(QColor(after.pixmap(32, 32).toImage().pixel(16, 16)), QColor(Qt::yellow));
+	}
+
+	void test_Broken()
+	{
+		QString path = m_dir.path() + "/broken.png";
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write("this is not a png");
+		file.close();
+		QIcon icon(new LazyIconEngine(path, 0));
+		QVERIFY(icon.availableSizes().isEmpty());
+		QVERIFY(icon.pixmap(32, 32).isNull());
+	}
+
+	void test_Paint()
+	{
+		QString path = makeImage("paint.png", QSize(64, 64), Qt::red);
+		QIcon icon(new LazyIconEngine(path, 0));
+		QImage target(QSize(48, 48), QImage::Format_ARGB32);
+		target.fill(Qt::transparent);
+		{
+			QPainter painter(&target);
+			icon.paint(&painter, QRect(8, 8, 32, 32));
+		}
+		QCOMPARE(qAlpha(target.pixel(2, 2)), 0);
+		QCOMPARE(QColor(target.pixel(24, 24)), QColor(Qt::red));
+	}
+
+private:
+	QTemporaryDir m_dir;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(LazyIconEngineTest)
+
+#include "tst_LazyIconEngine.moc"
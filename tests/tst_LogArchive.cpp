@@ -0,0 +1,163 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include "TestUtil.h"
+
+#include "logic/LogArchive.h"
+#include "logic/GZip.h"
+
+class LogArchiveTest : public QObject
+{
+	Q_OBJECT
+private:
+	QString segmentName(const QDateTime &started, const QString &suffix = ".log.gz")
+	{
+		return "MultiMC-" + started.toString("yyyyMMdd-hhmmss") + suffix;
+	}
+	void writeFile(const QString &path, const QByteArray &data)
+	{
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		QCOMPARE(file.write(data), (qint64)data.size());
+	}
+	QStringList names(const QStringList &paths)
+	{
+		QStringList result;
+		for (auto path : paths)
+		{
+			result.append(QFileInfo(path).fileName());
+		}
+		return result;
+	}
+	QString dir()
+	{
+		return m_dir.path() + "/" + QTest::currentTestFunction();
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_ShouldRotate()
+	{
+		LogArchive archive(dir(), "MultiMC");
+		const QDateTime now = QDateTime::currentDateTime();
+		archive.setLimits(1000, 0, 0);
+		QVERIFY(!archive.shouldRotate(999, now));
+		QVERIFY(archive.shouldRotate(1000, now));
+		// a day worth of log gets rotated, whatever its size
+		QVERIFY(!archive.shouldRotate(0, now.addSecs(-23 * 3600)));
+		QVERIFY(archive.shouldRotate(0, now.addSecs(-24 * 3600)));
+
+		archive.setLimits(0, 0, 0);
+		QVERIFY(!archive.shouldRotate(1024 * 1024 * 1024, now));
+	}
+
+	void test_ArchivePath()
+	{
+		LogArchive archive(dir(), "MultiMC");
+		const QDateTime started(QDate(2014, 5, 6), QTime(7, 8, 9));
+		const QString path = archive.archivePath(started);
+		QCOMPARE(path, QDir(dir()).absoluteFilePath("MultiMC-20140506-070809.log"));
+
+		// segments started in the same second don't replace each other
+		writeFile(path + ".gz", "");
+		QCOMPARE(QFileInfo(archive.archivePath(started)).fileName(),
+				 QString("MultiMC-20140506-070809_01.log"));
+	}
+
+	void test_ArchiveCompresses()
+	{
+		const QByteArray data = "[INFO] the previous session\n";
+		writeFile(m_dir.path() + "/MultiMC-0.log", data);
+		{
+			LogArchive archive(dir(), "MultiMC");
+			archive.archive(m_dir.path() + "/MultiMC-0.log");
+			archive.archive(m_dir.path() + "/MultiMC-1.log");
+			// the destructor waits for the compression
+		}
+		QVERIFY(!QFile::exists(m_dir.path() + "/MultiMC-0.log"));
+		LogArchive archive(dir(), "MultiMC");
+		const QStringList segments = archive.segments();
+		QCOMPARE(segments.size(), 1);
+		QByteArray read;
+		QVERIFY(GZip::readFile(segments.first(), read));
+		QCOMPARE(read, data);
+		// nothing uncompressed is left behind
+		QCOMPARE(QDir(dir()).entryList({"*.log"}, QDir::Files), QStringList());
+	}
+
+	void test_LeftoversCompressed()
+	{
+		QDir().mkpath(dir());
+		const QString name = segmentName(QDateTime::currentDateTime().addSecs(-3600), ".log");
+		writeFile(dir() + "/" + name, "[INFO] quit before compressing\n");
+		{
+			LogArchive archive(dir(), "MultiMC");
+		}
+		QVERIFY(!QFile::exists(dir() + "/" + name));
+		QVERIFY(QFile::exists(dir() + "/" + name + ".gz"));
+	}
+
+	void test_PruneAge()
+	{
+		QDir().mkpath(dir());
+		const QDateTime now = QDateTime::currentDateTime();
+		const QString recent = segmentName(now.addDays(-2));
+		const QString old = segmentName(now.addDays(-10));
+		writeFile(dir() + "/" + recent, "recent");
+		writeFile(dir() + "/" + old, "old");
+		// not a segment, never touched
+		writeFile(dir() + "/notes.txt", "notes");
+		{
+			LogArchive archive(dir(), "MultiMC");
+			archive.setLimits(0, 0, 7);
+		}
+		QVERIFY(QFile::exists(dir() + "/" + recent));
+		QVERIFY(!QFile::exists(dir() + "/" + old));
+		QVERIFY(QFile::exists(dir() + "/notes.txt"));
+	}
+
+	void test_PruneTotalSize()
+	{
+		QDir().mkpath(dir());
+		const QDateTime now = QDateTime::currentDateTime();
+		QStringList expected;
+		for (int i = 1; i <= 5; i++)
+		{
+			const QString name = segmentName(now.addSecs(-i * 60));
+			writeFile(dir() + "/" + name, QByteArray(1000, 'x'));
+			if (i <= 2)
+				expected.append(name);
+		}
+		LogArchive archive(dir(), "MultiMC");
+		{
+			LogArchive limited(dir(), "MultiMC");
+			// the newest segments are kept
+			limited.setLimits(0, 2500, 0);
+		}
+		QCOMPARE(names(archive.segments()), expected);
+
+		// no limits, nothing goes away
+		{
+			LogArchive unlimited(dir(), "MultiMC");
+			unlimited.setLimits(0, 0, 0);
+		}
+		QCOMPARE(names(archive.segments()), expected);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(LogArchiveTest)
+
+#include "tst_LogArchive.moc"
@@ -0,0 +1,112 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QFile>
+#include "TestUtil.h"
+
+#include "logic/LogFileModel.h"
+
+class LogFileModelTest : public QObject
+{
+	Q_OBJECT
+private:
+	void writeFile(const QString &path, const QByteArray &data)
+	{
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		file.write(data);
+	}
+	void openAndWait(LogFileModel &model, const QString &path)
+	{
+		QSignalSpy loaded(&model, SIGNAL(loaded()));
+		QVERIFY(model.open(path));
+		QVERIFY(loaded.count() || loaded.wait());
+	}
+	QByteArray manyLines(int count)
+	{
+		QByteArray data;
+		for (int i = 0; i < count; i++)
+		{
+			data += "line " + QByteArray::number(i) + " of a log that needs more than one chunk\n";
+		}
+		return data;
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_Lines()
+	{
+		const QString path = m_dir.path() + "/lines.log";
+		writeFile(path, "first\r\nsecond\nthird");
+		LogFileModel model;
+		openAndWait(model, path);
+		QCOMPARE(model.rowCount(), 3);
+		QCOMPARE(model.data(model.index(0)).toString(), QString("first"));
+		QCOMPARE(model.data(model.index(2)).toString(), QString("third"));
+	}
+
+	void test_FollowGrowing()
+	{
+		const QString path = m_dir.path() + "/growing.log";
+		writeFile(path, "first\nsec");
+		LogFileModel model;
+		model.setFollowing(true);
+		openAndWait(model, path);
+		QCOMPARE(model.rowCount(), 2);
+		QCOMPARE(model.data(model.index(1)).toString(), QString("sec"));
+
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::Append));
+		file.write("ond\nthird\n");
+		file.close();
+		QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+		model.refresh();
+		QVERIFY(inserted.wait());
+		QCOMPARE(model.rowCount(), 3);
+		QCOMPARE(model.data(model.index(1)).toString(), QString("second"));
+		QCOMPARE(model.data(model.index(2)).toString(), QString("third"));
+	}
+
+	void test_FollowTruncated_data()
+	{
+		QTest::addColumn<bool>("following");
+		QTest::newRow("followed") << true;
+		QTest::newRow("mapped") << false;
+	}
+	void test_FollowTruncated()
+	{
+		QFETCH(bool, following);
+		const QString path = m_dir.path() + "/truncated.log";
+		writeFile(path, manyLines(10000));
+		LogFileModel model;
+		model.setFollowing(following);
+		openAndWait(model, path);
+		QCOMPARE(model.rowCount(), 10000);
+
+		// a new session rewrites the log in place
+		writeFile(path, "new\n");
+		// the old lines are gone, but looking at them must not crash
+		QVERIFY(model.data(model.index(9999)).toString().isEmpty());
+		QVERIFY(model.text().size() < 10);
+
+		QSignalSpy loaded(&model, SIGNAL(loaded()));
+		model.refresh();
+		QVERIFY(loaded.wait());
+		QCOMPARE(model.rowCount(), 1);
+		QCOMPARE(model.data(model.index(0)).toString(), QString("new"));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(LogFileModelTest)
+
+#include "tst_LogFileModel.moc"
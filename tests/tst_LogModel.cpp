@@ -0,0 +1,123 @@
+#include <QTest>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "logic/LogModel.h"
+
+class LogModelTest : public QObject
+{
+	Q_OBJECT
+private:
+	QStringList rows(const LogModel &model)
+	{
+		QStringList result;
+		for (int i = 0; i < model.rowCount(); i++)
+			result.append(model.data(model.index(i)).toString());
+		return result;
+	}
+	void search(LogModel &model, const QString &term)
+	{
+		QSignalSpy finished(&model, SIGNAL(searchFinished()));
+		model.setSearchTerm(term);
+		QVERIFY(!model.searchPending() || finished.wait());
+		QCOMPARE(model.searchTerm(), term);
+		QVERIFY(!model.searchPending());
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_LevelFilter()
+	{
+		LogModel model;
+		model.append("launching\n", MessageLevel::MultiMC);
+		model.append("hello\nworld\n", MessageLevel::Info);
+		model.append("uh oh", MessageLevel::Error);
+		QCOMPARE(model.rowCount(), 4);
+
+		model.setLevelVisible(MessageLevel::Info, false);
+		QCOMPARE(rows(model), QStringList() << "launching" << "uh oh");
+		// lines of hidden levels don't become rows
+		model.append("more info", MessageLevel::Info);
+		QCOMPARE(model.rowCount(), 2);
+
+		model.setLevelVisible(MessageLevel::Info, true);
+		QCOMPARE(rows(model), QStringList() << "launching" << "hello" << "world" << "uh oh"
+											<< "more info");
+		QCOMPARE(model.toPlainText(), QString("launching\nhello\nworld\nuh oh\nmore info\n"));
+	}
+
+	void test_SearchNarrowsAndFollowsAppends()
+	{
+		LogModel model;
+		model.append("Loading foo\nLoading foobar\nLoading baz", MessageLevel::Info);
+		search(model, "foo");
+		QCOMPARE(model.matchCount(), 2);
+
+		// new lines are matched as they come in
+		model.append("FOO again", MessageLevel::Info);
+		model.append("nothing", MessageLevel::Info);
+		QCOMPARE(model.matchCount(), 3);
+
+		search(model, "foob");
+		QCOMPARE(model.matchCount(), 1);
+		model.append("foobar later", MessageLevel::Warning);
+		QCOMPARE(model.matchCount(), 2);
+
+		// not a narrowing, everything is looked at again
+		search(model, "baz");
+		QCOMPARE(model.matchCount(), 1);
+
+		search(model, "");
+		QCOMPARE(model.matchCount(), 0);
+	}
+
+	void test_LinesAppendedWhileSearching()
+	{
+		LogModel model;
+		for (int i = 0; i < 1000; i++)
+			model.append(QString("line %1").arg(i), MessageLevel::Info);
+		QSignalSpy finished(&model, SIGNAL(searchFinished()));
+		model.setSearchTerm("line 99");
+		model.append("line 99 late", MessageLevel::Info);
+		QVERIFY(!model.searchPending() || finished.wait());
+		// line 99, line 990-999 and the late one
+		QCOMPARE(model.matchCount(), 12);
+	}
+
+	void test_FindNextWraps()
+	{
+		LogModel model;
+		model.append("match one\nother\nmatch two\nother\nmatch hidden", MessageLevel::Info);
+		model.setLevelVisible(MessageLevel::Debug, false);
+		model.append("match debug", MessageLevel::Debug);
+		search(model, "match");
+		QCOMPARE(model.matchCount(), 4);
+
+		QModelIndex found = model.findNext(QModelIndex());
+		QCOMPARE(found.row(), 0);
+		found = model.findNext(found);
+		QCOMPARE(found.row(), 2);
+		found = model.findNext(found);
+		QCOMPARE(found.row(), 4);
+		// the hidden debug line is skipped, back to the start
+		found = model.findNext(found);
+		QCOMPARE(found.row(), 0);
+
+		found = model.findNext(found, true);
+		QCOMPARE(found.row(), 4);
+
+		search(model, "missing");
+		QVERIFY(!model.findNext(QModelIndex()).isValid());
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(LogModelTest)
+
+#include "tst_LogModel.moc"
@@ -0,0 +1,114 @@
+#include <QTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "TestUtil.h"
+
+#include "logic/Metrics.h"
+
+class MetricsTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_Counter()
+	{
+		auto &registry = Metrics::Registry::instance();
+		auto &counter = registry.counter("test_counter_total", "A counter.");
+		counter.add();
+		counter.add(41);
+		QCOMPARE(counter.value(), qint64(42));
+		// the same name gives the same counter
+		QCOMPARE(&registry.counter("test_counter_total", "Ignored."), &counter);
+	}
+
+	void test_Histogram()
+	{
+		Metrics::Histogram histogram({1, 10, 100});
+		histogram.observe(0.5);
+		histogram.observe(1);
+		histogram.observe(5);
+		histogram.observe(1000);
+		auto data = histogram.snapshot();
+		QCOMPARE(data.buckets, QVector<qint64>() << 2 << 1 << 0 << 1);
+		QCOMPARE(data.count, qint64(4));
+		QCOMPARE(data.sum, 1006.5);
+		QCOMPARE(data.max, 1000.0);
+	}
+
+	void test_Json()
+	{
+		auto &registry = Metrics::Registry::instance();
+		registry.setInfo("version", "test");
+		registry.counter("test_json_total", "Exported as JSON.").add(3);
+		registry.histogram("test_json_ms", "A histogram.", {10}).observe(20);
+
+		auto root = QJsonDocument::fromJson(registry.toJson()).object();
+		QCOMPARE(root.value("info").toObject().value("version").toString(), QString("test"));
+		auto metrics = root.value("metrics").toObject();
+		auto counter = metrics.value("test_json_total").toObject();
+		QCOMPARE(counter.value("type").toString(), QString("counter"));
+		QCOMPARE(counter.value("value").toDouble(), 3.0);
+		auto histogram = metrics.value("test_json_ms").toObject();
+		QCOMPARE(histogram.value("type").toString(), QString("histogram"));
+		QCOMPARE(histogram.value("count").toDouble(), 1.0);
+		auto buckets = histogram.value("buckets").toArray();
+		QCOMPARE(buckets.size(), 2);
+		QCOMPARE(buckets[1].toObject().value("le").toString(), QString("+Inf"));
+		QCOMPARE(buckets[1].toObject().value("count").toDouble(), 1.0);
+	}
+
+	void test_Prometheus()
+	{
+		auto &registry = Metrics::Registry::instance();
+		registry.setInfo("platform", "with \"quotes\"");
+		registry.counter("test_prom_total", "Exported for Prometheus.").add(7);
+		auto &histogram = registry.histogram("test_prom_ms", "A histogram.", {1, 10});
+		histogram.observe(0.5);
+		histogram.observe(5);
+		histogram.observe(50);
+
+		const QStringList lines = QString::fromUtf8(registry.toPrometheus()).split('\n');
+		QVERIFY(lines.contains("# TYPE multimc_test_prom_total counter"));
+		QVERIFY(lines.contains("multimc_test_prom_total 7"));
+		QVERIFY(lines.contains("# TYPE multimc_test_prom_ms histogram"));
+		// buckets are cumulative
+		QVERIFY(lines.contains("multimc_test_prom_ms_bucket{le=\"1\"} 1"));
+		QVERIFY(lines.contains("multimc_test_prom_ms_bucket{le=\"10\"} 2"));
+		QVERIFY(lines.contains("multimc_test_prom_ms_bucket{le=\"+Inf\"} 3"));
+		QVERIFY(lines.contains("multimc_test_prom_ms_sum 55.5"));
+		QVERIFY(lines.contains("multimc_test_prom_ms_count 3"));
+
+		// sizes don't turn into 6 digit exponents
+		auto &sizes = registry.histogram("test_prom_bytes", "Sizes.", {8388608, 536870912});
+		sizes.observe(123456789);
+		sizes.observe(0.25);
+		const QStringList sizeLines = QString::fromUtf8(registry.toPrometheus()).split('\n');
+		QVERIFY(sizeLines.contains("multimc_test_prom_bytes_bucket{le=\"8388608\"} 1"));
+		QVERIFY(sizeLines.contains("multimc_test_prom_bytes_bucket{le=\"536870912\"} 2"));
+		QVERIFY(sizeLines.contains("multimc_test_prom_bytes_sum 123456789.25"));
+		bool found = false;
+		for (auto line : lines)
+		{
+			if (line.startsWith("multimc_build_info{"))
+			{
+				QVERIFY(line.contains("platform=\"with \\\"quotes\\\"\""));
+				found = true;
+			}
+		}
+		QVERIFY(found);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(MetricsTest)
+
+#include "tst_Metrics.moc"
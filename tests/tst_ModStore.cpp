@@ -0,0 +1,98 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include "TestUtil.h"
+
+#include "logic/ModStore.h"
+#include "logic/ModList.h"
+#include "logic/settings/SettingsObject.h"
+
+class ModStoreTest : public QObject
+{
+	Q_OBJECT
+private:
+	void writeFile(const QString &path, const QByteArray &data)
+	{
+		QDir().mkpath(QFileInfo(path).path());
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write(data);
+	}
+	QString objectPath(const QByteArray &data)
+	{
+		const QString sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+		return m_dir.path() + "/store/objects/" + sha1.left(2) + "/" + sha1;
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+#ifndef Q_OS_UNIX
+		QSKIP("The mod store needs hardlinks");
+#endif
+		QVERIFY(m_dir.isValid());
+		MMC->settings()->set("UseModStore", true);
+	}
+	void cleanupTestCase()
+	{
+		MMC->settings()->set("UseModStore", false);
+	}
+
+	void test_InstallLinks()
+	{
+		ModStore store(m_dir.path() + "/store");
+		const QString download = m_dir.path() + "/download/a.jar";
+		writeFile(download, "mod a");
+		QDir().mkpath(m_dir.path() + "/one/mods");
+		QDir().mkpath(m_dir.path() + "/two/mods");
+
+		QVERIFY(store.install(download, m_dir.path() + "/one/mods/a.jar"));
+		QVERIFY(store.install(download, m_dir.path() + "/two/mods/a.jar"));
+
+		QCOMPARE(ModStore::linkCount(objectPath("mod a")), 3);
+		QVERIFY(!(QFile::permissions(objectPath("mod a")) & QFile::WriteOwner));
+		// the source isn't touched
+		QCOMPARE(ModStore::linkCount(download), 1);
+		QVERIFY(QFile::permissions(download) & QFile::WriteOwner);
+		QCOMPARE(TestsInternal::readFile(m_dir.path() + "/two/mods/a.jar"), QByteArray("mod a"));
+	}
+
+	void test_UserFilesAreLeftAlone()
+	{
+		ModStore store(m_dir.path() + "/store");
+		ModList list(m_dir.path() + "/three/mods");
+		writeFile(m_dir.path() + "/three/mods/b.jar", "mod b");
+
+		QVERIFY(list.update());
+
+		QCOMPARE(ModStore::linkCount(m_dir.path() + "/three/mods/b.jar"), 1);
+		QVERIFY(QFile::permissions(m_dir.path() + "/three/mods/b.jar") & QFile::WriteOwner);
+		QVERIFY(!QFile::exists(objectPath("mod b")));
+	}
+
+	void test_CollectGarbage()
+	{
+		ModStore store(m_dir.path() + "/store");
+		const QString download = m_dir.path() + "/download/c.jar";
+		const QString mod = m_dir.path() + "/four/mods/c.jar";
+		writeFile(download, "mod c");
+		QDir().mkpath(m_dir.path() + "/four/mods");
+		QVERIFY(store.install(download, mod));
+		QVERIFY(QFile::exists(objectPath("mod c")));
+		QVERIFY(QFile::remove(mod));
+
+		QVERIFY(store.collectGarbage() >= 1);
+		QVERIFY(!QFile::exists(objectPath("mod c")));
+		QVERIFY(QFile::exists(objectPath("mod a")));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(ModStoreTest)
+
+#include "tst_ModStore.moc"
@@ -0,0 +1,175 @@
+#include <QTest>
+#include <QMutex>
+#include <QRegularExpression>
+#include "TestUtil.h"
+
+#include "logger/QsLog.h"
+#include "logger/QsLogDest.h"
+
+using namespace QsLogging;
+
+static int evaluations = 0;
+static int expensive()
+{
+	return ++evaluations;
+}
+
+// records messages. holding 'gate' blocks the writer thread in write()
+class RecordingDestination : public Destination
+{
+public:
+	virtual void write(const QString &message)
+	{
+		QMutexLocker lock(&gate);
+		messages.append(message);
+	}
+	QMutex gate;
+	QStringList messages;
+};
+
+class QsLogTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void init()
+	{
+		Logger::instance().configure("info");
+		evaluations = 0;
+	}
+	void cleanupTestCase()
+	{
+		Logger::instance().configure("info");
+	}
+
+	void test_Configure_data()
+	{
+		QTest::addColumn<QString>("spec");
+		QTest::addColumn<bool>("ok");
+		QTest::addColumn<int>("general");
+		QTest::addColumn<int>("net");
+		QTest::addColumn<int>("mods");
+
+		QTest::newRow("bare level") << "debug" << true << int(DebugLevel) << int(DebugLevel)
+									<< int(DebugLevel);
+		QTest::newRow("category") << "net=trace" << true << int(InfoLevel) << int(TraceLevel)
+								  << int(InfoLevel);
+		QTest::newRow("mixed") << "warn, net=trace,MODS=Error" << true << int(WarnLevel)
+							   << int(TraceLevel) << int(ErrorLevel);
+		QTest::newRow("unknown category") << "foo=trace,net=debug" << false << int(InfoLevel)
+										  << int(DebugLevel) << int(InfoLevel);
+		QTest::newRow("unknown level") << "loud" << false << int(InfoLevel) << int(InfoLevel)
+									   << int(InfoLevel);
+	}
+	void test_Configure()
+	{
+		QFETCH(QString, spec);
+		QFETCH(bool, ok);
+		QFETCH(int, general);
+		QFETCH(int, net);
+		QFETCH(int, mods);
+
+		Logger &logger = Logger::instance();
+		QCOMPARE(logger.configure(spec), ok);
+		QCOMPARE(int(logger.loggingLevel()), general);
+		QCOMPARE(int(logger.loggingLevel(NetCategory)), net);
+		QCOMPARE(int(logger.loggingLevel(ModsCategory)), mods);
+	}
+
+	void test_DisabledSkipsArguments()
+	{
+		QLOG_DEBUG() << expensive();
+		QCLOG_TRACE(Net) << expensive();
+		QCOMPARE(evaluations, 0);
+		Logger::instance().setLoggingLevel(NetCategory, TraceLevel);
+		QCLOG_TRACE(Net) << expensive();
+#if QSLOG_LEVEL_FLOOR > 0
+		QCOMPARE(evaluations, 0);
+#else
+		QCOMPARE(evaluations, 1);
+#endif
+	}
+
+	void test_DanglingElse()
+	{
+		bool taken = false;
+		if (evaluations != 0)
+			QLOG_DEBUG() << expensive();
+		else
+			taken = true;
+		QVERIFY(taken);
+	}
+
+	void test_QueueOrderDropsAndFlush()
+	{
+		Logger &logger = Logger::instance();
+		RecordingDestination destination;
+		logger.addDestination(&destination);
+
+		// with the writer stuck, the queue fills up past the limit
+		const int count = 65536 + 100;
+		destination.gate.lock();
+		for (int i = 0; i < count; i++)
+		{
+			QLOG_INFO() << "queued" << i;
+		}
+		QLOG_WARN() << "important";
+		destination.gate.unlock();
+		logger.flush();
+		logger.removeDestination(&destination);
+
+		int last = -1;
+		int written = 0;
+		int dropped = 0;
+		bool important = false;
+		QRegularExpression droppedExp("(\\d+) log messages were dropped");
+		QRegularExpression queuedExp("queued (\\d+)");
+		for (auto message : destination.messages)
+		{
+			auto match = droppedExp.match(message);
+			if (match.hasMatch())
+			{
+				dropped += match.captured(1).toInt();
+				continue;
+			}
+			if (message.contains("important"))
+			{
+				important = true;
+				continue;
+			}
+			auto queued = queuedExp.match(message);
+			QVERIFY(queued.hasMatch());
+			const int index = queued.captured(1).toInt();
+			QVERIFY(index > last);
+			last = index;
+			written++;
+		}
+		QVERIFY(important);
+		QVERIFY(dropped > 0);
+		QCOMPARE(written + dropped, count);
+	}
+
+	// disabled statements should cost one load and one branch
+	void bench_Disabled()
+	{
+		QBENCHMARK
+		{
+			QLOG_TRACE() << "trace" << expensive() << QString("formatted %1").arg(42);
+		}
+		QCOMPARE(evaluations, 0);
+	}
+	// for comparison, a statement that gets formatted and queued
+	void bench_Enabled()
+	{
+		Logger::instance().setLoggingLevel(GeneralCategory, TraceLevel);
+		QBENCHMARK
+		{
+			QLOG_TRACE() << "trace" << 42 << QString("formatted %1").arg(42);
+		}
+		Logger::instance().flush();
+	}
+};
+
+QTEST_GUILESS_MAIN(QsLogTest)
+
+#include "tst_QsLog.moc"
@@ -0,0 +1,106 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "logic/RecursiveFileSystemWatcher.h"
+
+class RecursiveFileSystemWatcherTest : public QObject
+{
+	Q_OBJECT
+private:
+	void writeFile(const QString &path)
+	{
+		QDir().mkpath(QFileInfo(path).path());
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write("log\n");
+	}
+	QString root()
+	{
+		return m_dir.path() + "/" + QTest::currentTestFunction();
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_IncrementalUpdate()
+	{
+		writeFile(root() + "/latest.log");
+		writeFile(root() + "/crash-reports/notes.txt");
+		writeFile(root() + "/old/2014.log");
+
+		RecursiveFileSystemWatcher watcher(nullptr);
+		watcher.setFileExpression(".*\\.log$");
+		watcher.setRootDir(root());
+		watcher.enable();
+		QCOMPARE(watcher.files(), QStringList() << "latest.log" << "old/2014.log");
+		QSignalSpy spy(&watcher, SIGNAL(filesChanged()));
+
+		// a file in a folder that only now appears. it is written right away, before the
+		// watcher had a chance to list the folder
+		writeFile(root() + "/new/deeper/fresh.log");
+		QTRY_COMPARE(watcher.files(), QStringList() << "latest.log"
+													<< "new/deeper/fresh.log"
+													<< "old/2014.log");
+
+		QVERIFY(QFile::remove(root() + "/latest.log"));
+		QVERIFY(QDir(root() + "/old").removeRecursively());
+		QTRY_COMPARE(watcher.files(), QStringList() << "new/deeper/fresh.log");
+		QVERIFY(!watcher.isPolling());
+
+		// files that don't match change nothing
+		const int changes = spy.count();
+		writeFile(root() + "/crash-reports/more-notes.txt");
+		QTest::qWait(500);
+		QCOMPARE(spy.count(), changes);
+
+		// nothing is reported while disabled, the changes are picked up when enabled again
+		watcher.disable();
+		writeFile(root() + "/later.log");
+		QTest::qWait(500);
+		QCOMPARE(spy.count(), changes);
+		watcher.enable();
+		QCOMPARE(watcher.files(), QStringList() << "later.log" << "new/deeper/fresh.log");
+	}
+
+	void test_OutOfWatches()
+	{
+		writeFile(root() + "/a/one.log");
+		writeFile(root() + "/b/two.log");
+		writeFile(root() + "/c/three.log");
+
+		RecursiveFileSystemWatcher watcher(nullptr);
+		watcher.m_watchLimit = 2;
+		watcher.setFileExpression(".*\\.log$");
+		watcher.setRootDir(root());
+		watcher.enable();
+		QVERIFY(watcher.isPolling());
+		QCOMPARE(watcher.files(), QStringList() << "a/one.log" << "b/two.log" << "c/three.log");
+
+		// polling still finds changes, in the folders that got no watch too
+		writeFile(root() + "/c/four.log");
+		QVERIFY(QFile::remove(root() + "/a/one.log"));
+		QTRY_COMPARE(watcher.files(), QStringList() << "b/two.log" << "c/four.log"
+													<< "c/three.log");
+
+		// and stops with the watcher
+		watcher.disable();
+		QVERIFY(!watcher.m_pollTimer.isActive());
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(RecursiveFileSystemWatcherTest)
+
+#include "tst_RecursiveFileSystemWatcher.moc"
@@ -0,0 +1,64 @@
+#include <QTest>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "logic/StallDetector.h"
+#include "logic/Metrics.h"
+
+class StallDetectorTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_PhaseNesting()
+	{
+		QCOMPARE(Metrics::currentPhase(), QString());
+		{
+			Metrics::PhaseMarker outer("outer");
+			QCOMPARE(Metrics::currentPhase(), QString("outer"));
+			{
+				Metrics::PhaseMarker inner("inner");
+				QCOMPARE(Metrics::currentPhase(), QString("inner"));
+			}
+			QCOMPARE(Metrics::currentPhase(), QString("outer"));
+		}
+		QCOMPARE(Metrics::currentPhase(), QString());
+	}
+
+	void test_Stall()
+	{
+		StallDetector detector(100);
+		QSignalSpy spy(&detector, SIGNAL(stalled(qint64, QString)));
+		detector.start();
+		// let the heartbeat get going
+		QTest::qWait(200);
+		QCOMPARE(spy.count(), 0);
+		{
+			Metrics::PhaseMarker marker("test phase");
+			QThread::msleep(500);
+		}
+		QTest::qWait(200);
+		detector.stop();
+
+		QCOMPARE(spy.count(), 1);
+		QCOMPARE(spy.first().at(1).toString(), QString("test phase"));
+		auto stats = detector.stats();
+		QVERIFY(stats.contains("test phase"));
+		QCOMPARE(stats["test phase"].count, 1);
+		QVERIFY(stats["test phase"].max >= 300);
+		QVERIFY(detector.report().startsWith("test phase: 1 stall(s)"));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(StallDetectorTest)
+
+#include "tst_StallDetector.moc"
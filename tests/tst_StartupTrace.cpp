@@ -0,0 +1,154 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <QThread>
+#include "TestUtil.h"
+
+#include "logic/StartupTrace.h"
+#include "MultiMC.h"
+
+class StartupTraceTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_Phases()
+	{
+		StartupTrace trace;
+		{
+			auto outer = trace.phase("outer");
+			{
+				auto inner = trace.phase("inner", "deferred");
+				QThread::msleep(2);
+			}
+			auto ended = trace.phase("ended");
+			ended.end();
+			// ending twice records nothing
+			ended.end();
+		}
+		trace.mark("visible");
+
+		auto events = trace.events();
+		QCOMPARE(events.size(), 4);
+		// phases are recorded when they end
+		QCOMPARE(events[0].name, QString("inner"));
+		QCOMPARE(events[0].category, QString("deferred"));
+		QCOMPARE(events[1].name, QString("ended"));
+		QCOMPARE(events[2].name, QString("outer"));
+		QCOMPARE(events[2].category, QString("startup"));
+		QCOMPARE(events[3].name, QString("visible"));
+		QCOMPARE(events[3].duration, qint64(-1));
+
+		// the inner phase lies within the outer one
+		QVERIFY(events[0].duration >= 2000);
+		QVERIFY(events[0].start >= events[2].start);
+		QVERIFY(events[0].start + events[0].duration <= events[2].start + events[2].duration);
+		QVERIFY(events[3].start >= events[2].start + events[2].duration);
+	}
+
+	void test_ChromeTrace()
+	{
+		StartupTrace trace;
+		{
+			auto phase = trace.phase("settings");
+		}
+		trace.mark("visible");
+
+		QTemporaryDir dir;
+		QVERIFY(dir.isValid());
+		const QString path = dir.path() + "/trace.json";
+		QVERIFY(trace.write(path));
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::ReadOnly));
+		auto doc = QJsonDocument::fromJson(file.readAll());
+		QVERIFY(doc.isObject());
+		auto events = doc.object().value("traceEvents").toArray();
+		QCOMPARE(events.size(), 2);
+
+		auto phase = events[0].toObject();
+		QCOMPARE(phase.value("name").toString(), QString("settings"));
+		QCOMPARE(phase.value("cat").toString(), QString("startup"));
+		QCOMPARE(phase.value("ph").toString(), QString("X"));
+		QVERIFY(phase.contains("dur"));
+		QVERIFY(phase.contains("ts"));
+		QVERIFY(phase.contains("pid"));
+		QVERIFY(phase.contains("tid"));
+
+		auto mark = events[1].toObject();
+		QCOMPARE(mark.value("ph").toString(), QString("i"));
+		QVERIFY(!mark.contains("dur"));
+		// no budget, no budget data
+		QVERIFY(!doc.object().contains("otherData"));
+	}
+
+	void test_Budget()
+	{
+		StartupTrace trace;
+		// no budget is always kept
+		QVERIFY(trace.withinBudget());
+
+		trace.setBudget("visible", 50 * 1000);
+		QCOMPARE(trace.budget(), qint64(50 * 1000));
+		QVERIFY(trace.withinBudget());
+		trace.mark("visible");
+		QThread::msleep(60);
+		// reached in time, what comes after doesn't matter
+		QVERIFY(trace.withinBudget());
+
+		auto doc = QJsonDocument::fromJson(trace.toChromeTrace());
+		auto otherData = doc.object().value("otherData").toObject();
+		QCOMPARE(otherData.value("budget_mark").toString(), QString("visible"));
+		QCOMPARE(otherData.value("budget_us").toDouble(), 50.0 * 1000);
+		QCOMPARE(otherData.value("within_budget").toBool(), true);
+
+		StartupTrace late;
+		late.setBudget("visible", 20 * 1000);
+		QThread::msleep(30);
+		// the time ran out before the mark
+		QVERIFY(!late.withinBudget());
+		late.mark("visible");
+		QVERIFY(!late.withinBudget());
+		doc = QJsonDocument::fromJson(late.toChromeTrace());
+		QCOMPARE(doc.object().value("otherData").toObject().value("within_budget").toBool(),
+				 false);
+	}
+
+	void test_ApplicationBudget()
+	{
+		// the window isn't shown here, but everything before it has to fit the budget
+		auto trace = MMC->startupTrace();
+		QVERIFY(trace->budget() > 0);
+		bool found = false;
+		for (auto &event : trace->events())
+		{
+			if (event.name != "MultiMC constructor")
+				continue;
+			found = true;
+			QVERIFY2(event.start + event.duration <= trace->budget(),
+					 qPrintable(QString("The constructor took %1 ms")
+									.arg(event.duration / 1000)));
+		}
+		QVERIFY(found);
+		// the instance list is loaded after the window is shown
+		for (auto &event : trace->events())
+		{
+			QVERIFY(event.name != "instance list");
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(StartupTraceTest)
+
+#include "tst_StartupTrace.moc"
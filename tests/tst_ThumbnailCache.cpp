@@ -0,0 +1,81 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QImage>
+#include <QFile>
+#include "TestUtil.h"
+
+#include "logic/screenshots/ThumbnailCache.h"
+
+class ThumbnailCacheTest : public QObject
+{
+	Q_OBJECT
+private:
+	QString makeImage(const QString &name, QSize size, QColor color)
+	{
+		QString path = m_dir.path() + "/" + name;
+		QImage image(size, QImage::Format_RGB32);
+		image.fill(color);
+		image.save(path, "png");
+		return path;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_Generate()
+	{
+		QString path = makeImage("wide.png", QSize(1000, 500), Qt::red);
+		QImage thumbnail = ThumbnailCache::generate(path, 64);
+		QCOMPARE(thumbnail.size(), QSize(64, 64));
+		// centered, the top and bottom quarter are padding
+		QCOMPARE(qAlpha(thumbnail.pixel(32, 2)), 0);
+		QCOMPARE(QColor(thumbnail.pixel(32, 32)), QColor(Qt::red));
+
+		QVERIFY(ThumbnailCache::generate(m_dir.path() + "/missing.png", 64).isNull());
+	}
+
+	void test_StoreLoad()
+	{
+		ThumbnailCache cache(m_dir.path() + "/cache", 64);
+		QString path = makeImage("stored.png", QSize(200, 200), Qt::blue);
+		QVERIFY(cache.load(path).isNull());
+
+		QImage thumbnail = cache.get(path);
+		QVERIFY(!thumbnail.isNull());
+		QImage loaded = cache.load(path);
+		QVERIFY(!loaded.isNull());
+		QCOMPARE(loaded.size(), QSize(64, 64));
+
+		cache.remove(path);
+		QVERIFY(cache.load(path).isNull());
+	}
+
+	void test_OutdatedThumbnail()
+	{
+		ThumbnailCache cache(m_dir.path() + "/cache", 64);
+		QString path = makeImage("changed.png", QSize(100, 100), Qt::green);
+		QVERIFY(!cache.get(path).isNull());
+		QVERIFY(!cache.load(path).isNull());
+
+		// a different size is enough, even within the same second
+		makeImage("changed.png", QSize(300, 100), Qt::green);
+		QVERIFY(cache.load(path).isNull());
+		QImage regenerated = cache.get(path);
+		QCOMPARE(qAlpha(regenerated.pixel(32, 2)), 0);
+	}
+
+private:
+	QTemporaryDir m_dir;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(ThumbnailCacheTest)
+
+#include "tst_ThumbnailCache.moc"
@@ -0,0 +1,85 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "logic/WatchHub.h"
+
+class WatchHubTest : public QObject
+{
+	Q_OBJECT
+private:
+	void writeFile(const QString &path, const QByteArray &data)
+	{
+		QFile file(path);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write(data);
+	}
+
+	QTemporaryDir m_dir;
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+	}
+
+	void test_SharedHandle()
+	{
+		WatchHub hub;
+		auto handle = hub.watch(m_dir.path());
+		QVERIFY(handle->isActive());
+		// the same path, spelled differently
+		QCOMPARE(hub.watch(m_dir.path() + "/./").get(), handle.get());
+		QVERIFY(!hub.watch(m_dir.path() + "/missing")->isActive());
+	}
+
+	void test_Batching()
+	{
+		WatchHub hub;
+		auto handle = hub.watch(m_dir.path());
+		QSignalSpy spy(handle.get(), SIGNAL(changed(QString)));
+
+		for (int i = 0; i < 5; i++)
+		{
+			writeFile(m_dir.path() + QString("/batch%1.txt").arg(i), "data");
+		}
+		QVERIFY(spy.wait(2000));
+		// anything left over would come in now
+		QTest::qWait(600);
+		QCOMPARE(spy.count(), 1);
+		QCOMPARE(spy.first().first().toString(), handle->path());
+	}
+
+	void test_Suspend()
+	{
+		WatchHub hub;
+		auto handle = hub.watch(m_dir.path());
+		QSignalSpy spy(handle.get(), SIGNAL(changed(QString)));
+
+		{
+			auto suspension = hub.suspend(m_dir.path());
+			writeFile(m_dir.path() + "/suspended1.txt", "data");
+			writeFile(m_dir.path() + "/suspended2.txt", "data");
+			QTest::qWait(600);
+			QCOMPARE(spy.count(), 0);
+		}
+		// late reports of the suspended writes are swallowed too
+		QTest::qWait(600);
+		QCOMPARE(spy.count(), 0);
+
+		// and once it is over, changes are reported again
+		writeFile(m_dir.path() + "/resumed.txt", "data");
+		QVERIFY(spy.wait(2000));
+		QCOMPARE(spy.count(), 1);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(WatchHubTest)
+
+#include "tst_WatchHub.moc"
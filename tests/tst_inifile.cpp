@@ -1,8 +1,50 @@
 #include <QTest>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QStringList>
 #include "TestUtil.h"
 
 #include "logic/settings/INIFile.h"
 
+// The parser as it was before it worked on bytes. The current one has to agree with it.
+static QMap<QString, QVariant> referenceParse(QByteArray file)
+{
+	QMap<QString, QVariant> out;
+	QTextStream in(file);
+	in.setCodec("UTF-8");
+	QStringList lines = in.readAll().split('\n');
+	for (int i = 0; i < lines.count(); i++)
+	{
+		QString &lineRaw = lines[i];
+		QString line = lineRaw.left(lineRaw.indexOf('#')).trimmed();
+		int eqPos = line.indexOf('=');
+		if (eqPos == -1)
+			continue;
+		QString key = line.left(eqPos).trimmed();
+		QString valueStr = line.right(line.length() - eqPos - 1).trimmed();
+		out[key] = INIFile::unescape(valueStr);
+	}
+	return out;
+}
+
+static QByteArray bigConfig()
+{
+	QByteArray out;
+	for (int i = 0; i < 40; i++)
+	{
+		out += "InstanceType=OneSix\n";
+		out += "IntendedVersion=1.7.10\n";
+		out += "name=Some instance " + QByteArray::number(i) + "\n";
+		out += "iconKey=infinity\n";
+		out += "lastLaunchTime=1404069582331\n";
+		out += "notes=Line one\\nLine two\\n\\tindented\n";
+		out += "JvmArgs=-XX:+UseConcMarkSweepGC -XX:+CMSIncrementalMode\n";
+		out += "OverrideMemory=true\n";
+		out += "MaxMemAlloc=" + QByteArray::number(1024 + i) + "\n";
+	}
+	return out;
+}
+
 class IniFileTest : public QObject
 {
 	Q_OBJECT
@@ -36,6 +78,85 @@ slots:
 		
 		QCOMPARE(back, through);
 	}
+
+	void test_Parse_data()
+	{
+		QTest::addColumn<QByteArray>("content");
+
+		QTest::newRow("empty") << QByteArray();
+		QTest::newRow("simple") << QByteArray("a=b\nc=d\n");
+		QTest::newRow("no trailing newline") << QByteArray("a=b\nc=d");
+		QTest::newRow("crlf") << QByteArray("a=b\r\nc=d\r\n");
+		QTest::newRow("whitespace") << QByteArray("  a  =  b c  \n\tkey\t=\tvalue\t\n\v\fx\f=\vy\n");
+		QTest::newRow("comments") << QByteArray("# comment\na=b # trailing\n#c=d\ne=f#g=h\n");
+		QTest::newRow("no equals") << QByteArray("garbage\n\n   \na=b\n");
+		QTest::newRow("equals in value") << QByteArray("a=b=c\n=empty key\nempty value=\n");
+		QTest::newRow("duplicate keys") << QByteArray("a=1\na=2\n");
+		QTest::newRow("escapes") << QByteArray("a=x\\ny\\tz\\\\w\\q\n");
+		QTest::newRow("trailing backslash") << QByteArray("a=x\\\nb=\\\nc=x\\ \n");
+		QTest::newRow("escaped space") << QByteArray("a=\\ x \\ \n");
+		QTest::newRow("utf8") << QByteArray("n\xc3\xa4me=\xe2\x82\xac \xf0\x9f\x98\x80\\n\xc3\xbc\n");
+		QTest::newRow("unicode whitespace") << QByteArray("\xc2\xa0" "a\xe3\x80\x80=\xc2\xa0" "b\xc2\xa0\nc=\xe2\x80\xa8\\n\xe2\x80\xa8\n");
+		QTest::newRow("backslash before utf8") << QByteArray("a=\\\xc3\xa4\\\xf0\x9f\x98\x80\n");
+		QTest::newRow("bom") << QByteArray("\xef\xbb\xbf" "a=b\n");
+		QTest::newRow("invalid utf8") << QByteArray("a=\xff\xfe x\nb=\xc3\n");
+		QTest::newRow("big") << bigConfig();
+	}
+	void test_Parse()
+	{
+		QFETCH(QByteArray, content);
+
+		INIFile ini;
+		QVERIFY(ini.loadFile(content));
+		QCOMPARE(QMap<QString, QVariant>(ini), referenceParse(content));
+	}
+
+	void test_SaveLoad()
+	{
+		QTemporaryDir dir;
+		QVERIFY(dir.isValid());
+		QString path = dir.path() + "/test.cfg";
+
+		INIFile out;
+		out.set("plain", "value");
+		out.set("escapes", "a\nb\tc\\d");
+		out.set("unicode", QString::fromUtf8("\xc3\xa4\xe2\x82\xac"));
+		out.set("empty", "");
+		QVERIFY(out.saveFile(path));
+
+		INIFile in;
+		QVERIFY(in.loadFile(path));
+		QCOMPARE(in.get("plain", QVariant()).toString(), QString("value"));
+		QCOMPARE(in.get("escapes", QVariant()).toString(), QString("a\nb\tc\\d"));
+		QCOMPARE(in.get("unicode", QVariant()).toString(), QString::fromUtf8("\xc3\xa4\xe2\x82\xac"));
+		QCOMPARE(in.get("empty", QVariant("default")).toString(), QString());
+		QCOMPARE(in.size(), 4);
+
+		// empty files are fine, missing ones are not
+		QFile empty(dir.path() + "/empty.cfg");
+		QVERIFY(empty.open(QIODevice::WriteOnly));
+		empty.close();
+		QVERIFY(INIFile().loadFile(empty.fileName()));
+		QVERIFY(!INIFile().loadFile(dir.path() + "/missing.cfg"));
+	}
+
+	void bench_Load()
+	{
+		QByteArray content = bigConfig();
+		QBENCHMARK
+		{
+			INIFile ini;
+			ini.loadFile(content);
+		}
+	}
+	void bench_LoadReference()
+	{
+		QByteArray content = bigConfig();
+		QBENCHMARK
+		{
+			referenceParse(content);
+		}
+	}
 };
 
 QTEST_GUILESS_MAIN_MULTIMC(IniFileTest)
@@ -0,0 +1,142 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "logic/settings/INISettingsObject.h"
+#include "logic/settings/INIFile.h"
+#include "logic/settings/Setting.h"
+
+class SettingsTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_dir.isValid());
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_KeyInterning()
+	{
+		SettingKey a("SomeTestKey");
+		SettingKey b(QString("SomeTestKey"));
+		SettingKey c("OtherTestKey");
+		QVERIFY(a == b);
+		QVERIFY(a != c);
+		QCOMPARE(a.id(), QString("SomeTestKey"));
+		QCOMPARE(c.id(), QString("OtherTestKey"));
+		QCOMPARE(SettingKey::intern("SomeTestKey"), a.index());
+	}
+
+	void test_Handle()
+	{
+		INISettingsObject settings(m_dir.path() + "/handle.cfg");
+		settings.registerSetting("Number", 1);
+		auto handle = settings.handle<int>("Number");
+		QVERIFY(handle.isValid());
+		QVERIFY(!settings.handle<int>("Missing").isValid());
+		QCOMPARE(handle.get(), 1);
+
+		handle.set(5);
+		QCOMPARE(handle.get(), 5);
+		QCOMPARE(settings.get("Number").toInt(), 5);
+		QCOMPARE(settings.get(SettingKey("Number")).toInt(), 5);
+
+		settings.set("Number", 7);
+		QCOMPARE(handle.get(), 7);
+
+		handle.reset();
+		QCOMPARE(handle.get(), 1);
+		QVERIFY(!settings.get(SettingKey("Missing")).isValid());
+	}
+
+	void test_OverrideFollowsOriginal()
+	{
+		INISettingsObject global(m_dir.path() + "/global.cfg");
+		INISettingsObject instance(m_dir.path() + "/instance.cfg");
+		global.registerSetting("Value", "global default");
+		instance.registerOverride(global.getSetting("Value"));
+
+		auto value = instance.handle<QString>("Value");
+		QCOMPARE(value.get(), QString("global default"));
+
+		global.set("Value", "global");
+		QCOMPARE(value.get(), QString("global"));
+
+		value.set("instance");
+		QCOMPARE(value.get(), QString("instance"));
+		global.set("Value", "global again");
+		QCOMPARE(value.get(), QString("instance"));
+
+		value.reset();
+		QCOMPARE(value.get(), QString("global again"));
+		global.reset("Value");
+		QCOMPARE(value.get(), QString("global default"));
+	}
+
+	void test_ReloadInvalidates()
+	{
+		QString path = m_dir.path() + "/reload.cfg";
+		INISettingsObject settings(path);
+		settings.registerSetting("Name", "default");
+		auto name = settings.handle<QString>("Name");
+		QCOMPARE(name.get(), QString("default"));
+
+		INIFile file;
+		file.set("Name", "changed on disk");
+		QVERIFY(file.saveFile(path));
+		QCOMPARE(name.get(), QString("default"));
+
+		QVERIFY(settings.reload());
+		QCOMPARE(name.get(), QString("changed on disk"));
+	}
+
+	void bench_GetById()
+	{
+		INISettingsObject settings(m_dir.path() + "/bench.cfg");
+		registerMany(settings);
+		QBENCHMARK
+		{
+			settings.get("Setting50").toInt();
+		}
+	}
+	void bench_GetByKey()
+	{
+		INISettingsObject settings(m_dir.path() + "/bench.cfg");
+		registerMany(settings);
+		SettingKey key("Setting50");
+		QBENCHMARK
+		{
+			settings.get(key).toInt();
+		}
+	}
+	void bench_GetByHandle()
+	{
+		INISettingsObject settings(m_dir.path() + "/bench.cfg");
+		registerMany(settings);
+		auto handle = settings.handle<int>("Setting50");
+		QBENCHMARK
+		{
+			handle.get();
+		}
+	}
+
+private:
+	void registerMany(SettingsObject &settings)
+	{
+		for (int i = 0; i < 100; i++)
+		{
+			settings.registerSetting(QString("Setting%1").arg(i), i);
+		}
+	}
+
+	QTemporaryDir m_dir;
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(SettingsTest)
+
+#include "tst_settings.moc"